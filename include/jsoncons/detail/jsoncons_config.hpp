@@ -59,6 +59,12 @@ namespace jsoncons
 
 //#define JSONCONS_HAS_STRING_VIEW
 
+// Files are read through a read-only memory mapping where POSIX mmap is
+// available. Define JSONCONS_NO_MMAP to read them with streams instead.
+#if !defined(JSONCONS_NO_MMAP) && (defined(__linux__) || defined(__APPLE__) || defined(__unix__))
+#define JSONCONS_HAS_MMAP
+#endif
+
 #if defined(ANDROID) || defined(__ANDROID__)
 #define JSONCONS_HAS_STRTOD_L
 #endif
@@ -28,6 +28,8 @@
 #include <initializer_list>
 #include <jsoncons/detail/jsoncons_config.hpp>
 #include <jsoncons/detail/osequencestream.hpp>
+#include <jsoncons/detail/decimal_to_double.hpp>
+#include <jsoncons/detail/double_to_digits.hpp>
 
 #if defined(JSONCONS_HAS_STRING_VIEW)
 #include <string_view>
@@ -853,225 +855,124 @@ public:
 
 // print_double
 
-#ifdef JSONCONS_HAS__ECVT_S
-
 template <class CharT>
 class print_double
 {
     uint8_t precision_;
 public:
+    // A precision of 0 selects the shortest representation that reads back
+    // to the same double
     print_double(uint8_t precision)
         : precision_(precision)
     {
     }
 
-    void operator()(double val, uint8_t precision, buffered_output<CharT>& os) 
+    void operator()(double val, uint8_t precision, buffered_output<CharT>& os)
     {
-        char buf[_CVTBUFSIZE];
-        int decimal_point = 0;
-        int sign = 0;
-
         int prec = (precision == 0) ? precision_ : precision;
 
-        int err = _ecvt_s(buf, _CVTBUFSIZE, val, prec, &decimal_point, &sign);
-        if (err != 0)
+        if (std::signbit(val))
         {
-            throw std::runtime_error("Failed attempting double to string conversion");
+            os.put('-');
+            val = -val;
         }
-        //std::cout << "prec:" << prec << ", buf:" << buf << std::endl;
-        char* s = buf;
-        char* se = s + prec;
-
-        int i, k;
-        int j;
-
-        if (sign)
+        if (val == 0)
         {
-            os.put('-');
+            os.put('0');
+            os.put('.');
+            os.put('0');
+            return;
         }
-        if (decimal_point <= -4 || decimal_point > se - s + 5) 
+
+        char digits[256];
+        int exponent = 0;
+        int length = detail::double_to_digits(val, prec, digits, exponent);
+
+        // As with printf("%g"), use exponential format when the exponent
+        // is less than -4 or not less than the precision
+        int max_exponent = (prec == 0) ? std::numeric_limits<double>::max_digits10 : prec;
+        if (exponent < -4 || exponent >= max_exponent)
         {
-            os.put(*s++);
-            if (s < se) 
+            os.put(digits[0]);
+            os.put('.');
+            if (length > 1)
             {
-                os.put('.');
-                while ((se-1) > s && *(se-1) == '0')
+                for (int i = 1; i < length; ++i)
                 {
-                    --se;
-                }
-
-                while(s < se)
-                {
-                    os.put(*s++);
+                    os.put(digits[i]);
                 }
             }
+            else
+            {
+                os.put('0');
+            }
             os.put('e');
-            /* sprintf(b, "%+.2d", decimal_point - 1); */
-            if (--decimal_point < 0) {
+            if (exponent < 0)
+            {
                 os.put('-');
-                decimal_point = -decimal_point;
-                }
+                exponent = -exponent;
+            }
             else
+            {
                 os.put('+');
-            for(j = 2, k = 10; 10*k <= decimal_point; j++, k *= 10);
-            for(;;) 
+            }
+            if (exponent >= 100)
             {
-                i = decimal_point / k;
-                os.put(static_cast<CharT>(i) + '0');
-                if (--j <= 0)
-                    break;
-                decimal_point -= i*k;
-                decimal_point *= 10;
+                os.put(static_cast<CharT>('0' + exponent / 100));
+                exponent %= 100;
             }
+            os.put(static_cast<CharT>('0' + exponent / 10));
+            os.put(static_cast<CharT>('0' + exponent % 10));
         }
-        else if (decimal_point <= 0) 
+        else if (exponent < 0)
         {
             os.put('0');
             os.put('.');
-            while ((se-1) > s && *(se-1) == '0')
-            {
-                --se;
-            }
-            for(; decimal_point < 0; decimal_point++)
+            for (int i = exponent + 1; i < 0; ++i)
             {
                 os.put('0');
             }
-            while(s < se)
+            for (int i = 0; i < length; ++i)
             {
-                os.put(*s++);
+                os.put(digits[i]);
             }
         }
-        else {
-            while(s < se) 
-            {
-                os.put(*s++);
-                if ((--decimal_point == 0) && s < se)
-                {
-                    os.put('.');
-                    while ((se-1) > s && *(se-1) == '0')
-                    {
-                        --se;
-                    }
-                }
-            }
-            for(; decimal_point > 0; decimal_point--)
-            {
-                os.put('0');
-            }
-        }
-    }
-};
-
-#else
-
-template <class CharT>
-class print_double
-{
-    uint8_t precision_;
-    basic_osequencestream<CharT> oss_;
-public:
-    print_double(uint8_t precision)
-        : precision_(precision)
-    {
-        oss_.imbue(std::locale::classic());
-        oss_.precision(precision);
-    }
-    void operator()(double val, uint8_t precision, buffered_output<CharT>& os)
-    {
-        oss_.clear_sequence();
-        oss_.precision((precision == 0) ? precision_ : precision);
-        oss_ << val;
-
-        //std::cout << "precision_:" << (int)precision_ << ", precision:" << (int)precision << ", buf:" << oss_.data() << std::endl;
-
-        const CharT* sbeg = oss_.data();
-        const CharT* send = sbeg + oss_.length();
-        const CharT* pexp = send;
-
-        if (sbeg != send)
+        else
         {
-            bool dot = false;
-            for (pexp = sbeg; *pexp != 'e' && *pexp != 'E' && pexp < send; ++pexp)
+            for (int i = 0; i <= exponent; ++i)
             {
+                os.put(i < length ? digits[i] : '0');
             }
-
-            if (pexp != send)
+            os.put('.');
+            if (length > exponent + 1)
             {
-                const CharT* p = pexp;
-                while (p >= sbeg+2 && *(p-1) == '0' && *(p-2) != '.')
+                for (int i = exponent + 1; i < length; ++i)
                 {
-                    --p;
-                }
-                for (const CharT* q = sbeg; q < p; ++q)
-                {
-                    if (*q == '.')
-                    {
-                        dot = true;
-                    }
-                    os.put(*q);
-                }
-                if (!dot)
-                {
-                    os.put('.');
-                    os.put('0');
-                    dot = true;
-                }
-                for (const CharT* q = pexp; q < send; ++q)
-                {
-                    os.put(*q);
+                    os.put(digits[i]);
                 }
             }
             else
             {
-                const CharT* p = send;
-                while (p >= sbeg+2 && *(p-1) == '0' && *(p-2) != '.')
-                {
-                    --p;
-                }
-                const CharT* qend = *(p-2) == '.' ? p : send;
-                for (const CharT* q = sbeg; q < qend; ++q)
-                {
-                    if (*q == '.')
-                    {
-                        dot = true;
-                    }
-                    os.put(*q);
-                }
-            }
-
-            if (!dot)
-            {
-                os.put('.');
                 os.put('0');
             }
         }
     }
 };
-#endif
 
-#if defined(_MSC_VER)
+// string_to_double
 
 template <class CharT>
 class string_to_double
 {
-private:
-    _locale_t locale_;
 public:
     string_to_double()
     {
-        locale_ = _create_locale(LC_NUMERIC, "C");
-    }
-    ~string_to_double()
-    {
-        _free_locale(locale_);
     }
 
-    double operator()(const CharT* s, size_t)
+    double operator()(const CharT* s, size_t length)
     {
-        const CharT *begin = s;
-        CharT *end = nullptr;
-        double val = cstring_traits<CharT>::_tod_l(begin, &end, locale_);
-        if (begin == end)
+        double val;
+        if (!detail::decimal_to_double(s, length, val))
         {
             throw std::invalid_argument("Invalid float value");
         }
@@ -1083,115 +984,6 @@ private:
     string_to_double& operator=(const string_to_double&) = delete;
 };
 
-#elif defined(JSONCONS_HAS_STRTOD_L)
-
-template <class CharT>
-class string_to_double
-{
-private:
-    locale_t locale_;
-public:
-    string_to_double()
-    {
-        locale_ = newlocale(LC_ALL_MASK, "C", (locale_t) 0);
-    }
-    ~string_to_double()
-    {
-        freelocale(locale_);
-    }
-
-    double operator()(const CharT* s, size_t length)
-    {
-        const CharT *begin = s;
-        CharT *end = nullptr;
-        double val = cstring_traits<CharT>::tod_l(begin, &end, locale_);
-        if (begin == end)
-        {
-            throw std::invalid_argument("Invalid float value");
-        }
-        return val;
-    }
-
-private:
-    // noncopyable and nonmoveable
-    string_to_double(const string_to_double& fr) = delete;
-    string_to_double& operator=(const string_to_double& fr) = delete;
-};
-
-#else
-template <class CharT>
-class string_to_double
-{
-private:
-    std::vector<CharT> buffer_;
-    std::string decimal_point_;
-    bool is_dot_;
-public:
-    string_to_double()
-        : buffer_()
-    {
-        struct lconv * lc = localeconv();
-        if (lc != nullptr)
-        {
-            decimal_point_ = std::string(lc->decimal_point);    
-        }
-        else
-        {
-            decimal_point_ = std::string("."); 
-        }
-        buffer_.reserve(100);
-        is_dot_ = decimal_point_ == ".";
-    }
-
-    double operator()(const CharT* s, size_t length)
-    {
-        double val;
-        if (is_dot_)
-        {
-            const CharT *begin = s;
-            CharT *end = nullptr;
-            val = cstring_traits<CharT>::tod(begin, &end);
-            if (begin == end)
-            {
-                throw std::invalid_argument("Invalid float value");
-            }
-        }
-        else
-        {
-            buffer_.clear();
-            size_t j = 0;
-            const CharT* pe = s + length;
-            for (const CharT* p = s; p < pe; ++p)
-            {
-                if (*p == '.')
-                {
-                    buffer_.insert(buffer_.begin() + j, decimal_point_.begin(), decimal_point_.end());
-                    j += decimal_point_.length();
-                }
-                else
-                {
-                    buffer_.push_back(*p);
-                    ++j;
-                }
-            }
-            const CharT *begin = buffer_.data();
-            CharT *end = nullptr;
-            val = cstring_traits<CharT>::tod(begin, &end);
-            if (begin == end)
-            {
-                throw std::invalid_argument("Invalid float value");
-            }
-        }
-        return val;
-    }
-
-private:
-    // noncopyable and nonmoveable
-    string_to_double(const string_to_double& fr) = delete;
-    string_to_double& operator=(const string_to_double& fr) = delete;
-};
-#endif
-
 }
 
 #endif
@@ -0,0 +1,315 @@
+// Copyright 2017 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_DETAIL_SIMD_SCAN_HPP
+#define JSONCONS_DETAIL_SIMD_SCAN_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+#include <jsoncons/detail/jsoncons_config.hpp>
+
+// Define JSONCONS_NO_SIMD to force the scalar scanners
+
+#if !defined(JSONCONS_NO_SIMD)
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define JSONCONS_HAS_SSE2
+#include <emmintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+#if defined(JSONCONS_HAS_SSE2) && defined(__x86_64__) && (defined(__clang__) || (defined(__GNUC__) && (__GNUC__ * 100 + __GNUC_MINOR__ >= 409)))
+#define JSONCONS_HAS_AVX2_DISPATCH
+#include <immintrin.h>
+#endif
+#endif
+
+namespace jsoncons { namespace detail {
+
+// Scanners used by basic_json_parser to jump over runs of characters that
+// need no per-character handling. Each returns a pointer to the first
+// character in [p,end) that the parser must look at, or end.
+//
+// scan_string_chars stops at '"', '\\' and control characters (< 0x20),
+// everything else (including UTF-8 continuation bytes) is left for
+// unicons::validate.
+//
+// scan_blanks stops at anything other than ' ' and '\t', line breaks
+// are left to the parser for line counting.
+//
+// scan_ascii stops at the first character >= 0x80, so that UTF-8
+// validation only needs to start there.
+
+inline
+bool is_string_special(uint32_t c)
+{
+    return c == '\"' || c == '\\' || c < 0x20;
+}
+
+inline
+bool is_blank(uint32_t c)
+{
+    return c == ' ' || c == '\t';
+}
+
+template <class CharT>
+const CharT* scan_string_chars_scalar(const CharT* p, const CharT* end)
+{
+    while (p < end && !is_string_special(static_cast<typename std::make_unsigned<CharT>::type>(*p)))
+    {
+        ++p;
+    }
+    return p;
+}
+
+template <class CharT>
+const CharT* scan_blanks_scalar(const CharT* p, const CharT* end)
+{
+    while (p < end && is_blank(static_cast<typename std::make_unsigned<CharT>::type>(*p)))
+    {
+        ++p;
+    }
+    return p;
+}
+
+template <class CharT>
+const CharT* scan_ascii_scalar(const CharT* p, const CharT* end)
+{
+    while (p < end && static_cast<typename std::make_unsigned<CharT>::type>(*p) < 0x80)
+    {
+        ++p;
+    }
+    return p;
+}
+
+#if defined(JSONCONS_HAS_SSE2)
+
+inline
+int first_set_bit(uint32_t mask)
+{
+#if defined(_MSC_VER)
+    unsigned long index;
+    _BitScanForward(&index, mask);
+    return static_cast<int>(index);
+#else
+    return __builtin_ctz(mask);
+#endif
+}
+
+inline
+const char* scan_string_chars_sse2(const char* p, const char* end)
+{
+    const __m128i quote = _mm_set1_epi8('\"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i max_control = _mm_set1_epi8(0x1f);
+
+    while (end - p >= 16)
+    {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        // unsigned c <= 0x1f iff max(c,0x1f) == 0x1f
+        __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote),
+                                                    _mm_cmpeq_epi8(chunk, backslash)),
+                                       _mm_cmpeq_epi8(_mm_max_epu8(chunk, max_control), max_control));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(special));
+        if (mask != 0)
+        {
+            return p + first_set_bit(mask);
+        }
+        p += 16;
+    }
+    return scan_string_chars_scalar(p, end);
+}
+
+inline
+const char* scan_blanks_sse2(const char* p, const char* end)
+{
+    const __m128i space = _mm_set1_epi8(' ');
+    const __m128i tab = _mm_set1_epi8('\t');
+
+    while (end - p >= 16)
+    {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        __m128i blank = _mm_or_si128(_mm_cmpeq_epi8(chunk, space),
+                                     _mm_cmpeq_epi8(chunk, tab));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(blank)) ^ 0xffffu;
+        if (mask != 0)
+        {
+            return p + first_set_bit(mask);
+        }
+        p += 16;
+    }
+    return scan_blanks_scalar(p, end);
+}
+
+inline
+const char* scan_ascii_sse2(const char* p, const char* end)
+{
+    while (end - p >= 16)
+    {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+        uint32_t mask = static_cast<uint32_t>(_mm_movemask_epi8(chunk));
+        if (mask != 0)
+        {
+            return p + first_set_bit(mask);
+        }
+        p += 16;
+    }
+    return scan_ascii_scalar(p, end);
+}
+
+#endif
+
+#if defined(JSONCONS_HAS_AVX2_DISPATCH)
+
+__attribute__((target("avx2"))) inline
+const char* scan_string_chars_avx2(const char* p, const char* end)
+{
+    const __m256i quote = _mm256_set1_epi8('\"');
+    const __m256i backslash = _mm256_set1_epi8('\\');
+    const __m256i max_control = _mm256_set1_epi8(0x1f);
+
+    while (end - p >= 32)
+    {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i special = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(chunk, quote),
+                                                          _mm256_cmpeq_epi8(chunk, backslash)),
+                                          _mm256_cmpeq_epi8(_mm256_max_epu8(chunk, max_control), max_control));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(special));
+        if (mask != 0)
+        {
+            return p + __builtin_ctz(mask);
+        }
+        p += 32;
+    }
+    return scan_string_chars_sse2(p, end);
+}
+
+__attribute__((target("avx2"))) inline
+const char* scan_blanks_avx2(const char* p, const char* end)
+{
+    const __m256i space = _mm256_set1_epi8(' ');
+    const __m256i tab = _mm256_set1_epi8('\t');
+
+    while (end - p >= 32)
+    {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        __m256i blank = _mm256_or_si256(_mm256_cmpeq_epi8(chunk, space),
+                                        _mm256_cmpeq_epi8(chunk, tab));
+        uint32_t mask = ~static_cast<uint32_t>(_mm256_movemask_epi8(blank));
+        if (mask != 0)
+        {
+            return p + __builtin_ctz(mask);
+        }
+        p += 32;
+    }
+    return scan_blanks_sse2(p, end);
+}
+
+__attribute__((target("avx2"))) inline
+const char* scan_ascii_avx2(const char* p, const char* end)
+{
+    while (end - p >= 32)
+    {
+        __m256i chunk = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p));
+        uint32_t mask = static_cast<uint32_t>(_mm256_movemask_epi8(chunk));
+        if (mask != 0)
+        {
+            return p + __builtin_ctz(mask);
+        }
+        p += 32;
+    }
+    return scan_ascii_sse2(p, end);
+}
+
+inline
+bool cpu_has_avx2()
+{
+    static const bool has_avx2 = []() -> bool
+    {
+        __builtin_cpu_init();
+        return __builtin_cpu_supports("avx2") != 0;
+    }();
+    return has_avx2;
+}
+
+#endif
+
+// scan_string_chars
+
+template <class CharT>
+const CharT* scan_string_chars(const CharT* p, const CharT* end)
+{
+    return scan_string_chars_scalar(p, end);
+}
+
+inline
+const char* scan_string_chars(const char* p, const char* end)
+{
+#if defined(JSONCONS_HAS_AVX2_DISPATCH)
+    if (cpu_has_avx2())
+    {
+        return scan_string_chars_avx2(p, end);
+    }
+#endif
+#if defined(JSONCONS_HAS_SSE2)
+    return scan_string_chars_sse2(p, end);
+#else
+    return scan_string_chars_scalar(p, end);
+#endif
+}
+
+// scan_blanks
+
+template <class CharT>
+const CharT* scan_blanks(const CharT* p, const CharT* end)
+{
+    return scan_blanks_scalar(p, end);
+}
+
+inline
+const char* scan_blanks(const char* p, const char* end)
+{
+#if defined(JSONCONS_HAS_AVX2_DISPATCH)
+    if (cpu_has_avx2())
+    {
+        return scan_blanks_avx2(p, end);
+    }
+#endif
+#if defined(JSONCONS_HAS_SSE2)
+    return scan_blanks_sse2(p, end);
+#else
+    return scan_blanks_scalar(p, end);
+#endif
+}
+
+// scan_ascii
+
+template <class CharT>
+const CharT* scan_ascii(const CharT* p, const CharT* end)
+{
+    return scan_ascii_scalar(p, end);
+}
+
+inline
+const char* scan_ascii(const char* p, const char* end)
+{
+#if defined(JSONCONS_HAS_AVX2_DISPATCH)
+    if (cpu_has_avx2())
+    {
+        return scan_ascii_avx2(p, end);
+    }
+#endif
+#if defined(JSONCONS_HAS_SSE2)
+    return scan_ascii_sse2(p, end);
+#else
+    return scan_ascii_scalar(p, end);
+#endif
+}
+
+}}
+
+#endif
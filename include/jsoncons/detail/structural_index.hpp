@@ -0,0 +1,220 @@
+// Copyright 2017 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_DETAIL_STRUCTURAL_INDEX_HPP
+#define JSONCONS_DETAIL_STRUCTURAL_INDEX_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include <type_traits>
+#include <jsoncons/detail/jsoncons_config.hpp>
+#include <jsoncons/detail/simd_scan.hpp>
+
+namespace jsoncons { namespace detail {
+
+// Stage one of the json_view parser: finds the positions of all structural
+// characters of a JSON text, 64 characters at a time, with bitmaps.
+//
+// Reported are '{', '}', '[', ']', ',' and ':' outside strings, both quotes
+// of every string, and the first character of every other value (numbers,
+// true, false, null). Escaped quotes are found by tracking runs of
+// backslashes, and string interiors by a prefix xor of the quote bits.
+
+inline
+int trailing_zeros64(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return __builtin_ctzll(x);
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long index;
+    _BitScanForward64(&index, x);
+    return static_cast<int>(index);
+#else
+    int n = 0;
+    while ((x & 1) == 0)
+    {
+        x >>= 1;
+        ++n;
+    }
+    return n;
+#endif
+}
+
+// Bit i is set in the result if an odd number of bits at or below i are set in x
+inline
+uint64_t prefix_xor(uint64_t x)
+{
+    x ^= x << 1;
+    x ^= x << 2;
+    x ^= x << 4;
+    x ^= x << 8;
+    x ^= x << 16;
+    x ^= x << 32;
+    return x;
+}
+
+struct character_masks
+{
+    uint64_t backslash;
+    uint64_t quote;
+    uint64_t blank;
+    uint64_t op;
+};
+
+// Characters past length are classified as blanks
+template <class CharT>
+void classify_block_scalar(const CharT* p, size_t length, character_masks& masks)
+{
+    masks.backslash = masks.quote = masks.blank = masks.op = 0;
+    for (size_t i = 0; i < 64; ++i)
+    {
+        uint64_t bit = uint64_t(1) << i;
+        if (i >= length)
+        {
+            masks.blank |= bit;
+            continue;
+        }
+        switch (p[i])
+        {
+        case '\\':
+            masks.backslash |= bit;
+            break;
+        case '\"':
+            masks.quote |= bit;
+            break;
+        case ' ': case '\t': case '\n': case '\r':
+            masks.blank |= bit;
+            break;
+        case '{': case '}': case '[': case ']': case ',': case ':':
+            masks.op |= bit;
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+#if defined(JSONCONS_HAS_SSE2)
+
+inline
+void classify_block_sse2(const char* p, character_masks& masks)
+{
+    masks.backslash = masks.quote = masks.blank = masks.op = 0;
+    for (int k = 0; k < 4; ++k)
+    {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p + 16*k));
+        __m128i backslash = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'));
+        __m128i quote = _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\"'));
+        __m128i blank = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(' ')),
+                                                  _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\t'))),
+                                     _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\n')),
+                                                  _mm_cmpeq_epi8(chunk, _mm_set1_epi8('\r'))));
+        __m128i op = _mm_or_si128(_mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('{')),
+                                                            _mm_cmpeq_epi8(chunk, _mm_set1_epi8('}'))),
+                                               _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('[')),
+                                                            _mm_cmpeq_epi8(chunk, _mm_set1_epi8(']')))),
+                                  _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(',')),
+                                               _mm_cmpeq_epi8(chunk, _mm_set1_epi8(':'))));
+        int shift = 16*k;
+        masks.backslash |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(backslash))) << shift;
+        masks.quote |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(quote))) << shift;
+        masks.blank |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(blank))) << shift;
+        masks.op |= static_cast<uint64_t>(static_cast<uint32_t>(_mm_movemask_epi8(op))) << shift;
+    }
+}
+
+#endif
+
+template <class CharT>
+void classify_block(const CharT* p, size_t length, character_masks& masks)
+{
+    classify_block_scalar(p, length, masks);
+}
+
+inline
+void classify_block(const char* p, size_t length, character_masks& masks)
+{
+#if defined(JSONCONS_HAS_SSE2)
+    if (length >= 64)
+    {
+        classify_block_sse2(p, masks);
+        return;
+    }
+#endif
+    classify_block_scalar(p, length, masks);
+}
+
+class structural_indexer
+{
+    uint64_t prev_escaped_;
+    uint64_t prev_in_string_;
+    uint64_t prev_scalar_;
+public:
+    structural_indexer()
+        : prev_escaped_(0), prev_in_string_(0), prev_scalar_(0)
+    {
+    }
+
+    // Appends the positions of the structural characters of text to
+    // indexes. Returns false if the text ends inside a string.
+    template <class CharT>
+    bool index(const CharT* text, size_t length, std::vector<uint32_t>& indexes)
+    {
+        prev_escaped_ = prev_in_string_ = prev_scalar_ = 0;
+        character_masks masks;
+        for (size_t base = 0; base < length; base += 64)
+        {
+            classify_block(text + base, length - base, masks);
+
+            uint64_t quotes = masks.quote & ~escaped(masks.backslash);
+            uint64_t in_string = prefix_xor(quotes) ^ prev_in_string_;
+            prev_in_string_ = static_cast<uint64_t>(static_cast<int64_t>(in_string) >> 63);
+
+            uint64_t scalar = ~(masks.blank | masks.op | quotes | in_string);
+            uint64_t scalar_starts = scalar & ~((scalar << 1) | prev_scalar_);
+            prev_scalar_ = scalar >> 63;
+
+            uint64_t structurals = (masks.op & ~in_string) | quotes | scalar_starts;
+            while (structurals != 0)
+            {
+                indexes.push_back(static_cast<uint32_t>(base + trailing_zeros64(structurals)));
+                structurals &= structurals - 1;
+            }
+        }
+        return prev_in_string_ == 0;
+    }
+
+private:
+    // Bits of the characters that follow an unescaped backslash. Backslashes
+    // are rare, so they are walked one at a time.
+    uint64_t escaped(uint64_t backslash)
+    {
+        uint64_t result = 0;
+        if (prev_escaped_)
+        {
+            result = 1;
+            backslash &= ~uint64_t(1);
+        }
+        prev_escaped_ = 0;
+        while (backslash != 0)
+        {
+            int i = trailing_zeros64(backslash);
+            if (i == 63)
+            {
+                prev_escaped_ = 1;
+                break;
+            }
+            result |= uint64_t(1) << (i + 1);
+            backslash &= ~(uint64_t(3) << i);
+        }
+        return result;
+    }
+};
+
+}}
+
+#endif
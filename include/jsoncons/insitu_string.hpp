@@ -0,0 +1,253 @@
+// Copyright 2017 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_INSITU_STRING_HPP
+#define JSONCONS_INSITU_STRING_HPP
+
+#include <string>
+#include <ostream>
+#include <algorithm>
+#include <memory>
+#include <utility>
+#include <type_traits>
+#include <jsoncons/detail/jsoncons_config.hpp>
+
+namespace jsoncons {
+
+// Selects the in-situ overloads of the parser, the decoder and basic_json,
+// which leave strings in the caller's buffer instead of copying them.
+
+struct insitu_arg_t
+{
+    explicit insitu_arg_t() = default;
+};
+
+const insitu_arg_t insitu_arg = insitu_arg_t();
+
+// String storage for insitu_json_traits. A string constructed with
+// insitu_arg is a view of characters owned by someone else, which must
+// outlive it and be followed by a null character. Copies of a view are
+// views of the same characters. A string constructed any other way owns
+// its characters, like std::basic_string.
+
+template <class CharT,class Traits = std::char_traits<CharT>,class Allocator = std::allocator<CharT>>
+class basic_insitu_string
+{
+public:
+    typedef CharT value_type;
+    typedef Traits traits_type;
+    typedef Allocator allocator_type;
+    typedef std::basic_string<CharT,Traits,Allocator> string_type;
+    typedef const CharT* iterator;
+    typedef const CharT* const_iterator;
+private:
+    const CharT* view_;
+    size_t length_;
+    string_type owned_;
+public:
+    basic_insitu_string()
+        : view_(nullptr), length_(0)
+    {
+    }
+
+    explicit basic_insitu_string(const Allocator& allocator)
+        : view_(nullptr), length_(0), owned_(allocator)
+    {
+    }
+
+    basic_insitu_string(const CharT* s, size_t length, insitu_arg_t)
+        : view_(s), length_(length)
+    {
+    }
+
+    basic_insitu_string(const CharT* s, size_t length)
+        : view_(nullptr), length_(0), owned_(s,length)
+    {
+    }
+
+    basic_insitu_string(const CharT* s, size_t length, const Allocator& allocator)
+        : view_(nullptr), length_(0), owned_(s,length,allocator)
+    {
+    }
+
+    template <class InputIt>
+    basic_insitu_string(InputIt first, InputIt last)
+        : view_(nullptr), length_(0), owned_(first,last)
+    {
+    }
+
+    template <class InputIt>
+    basic_insitu_string(InputIt first, InputIt last, const Allocator& allocator)
+        : view_(nullptr), length_(0), owned_(first,last,allocator)
+    {
+    }
+
+    basic_insitu_string(const basic_insitu_string& other)
+        : view_(other.view_), length_(other.length_), owned_(other.owned_)
+    {
+    }
+
+    basic_insitu_string(const basic_insitu_string& other, const Allocator& allocator)
+        : view_(other.view_), length_(other.length_), owned_(other.owned_,allocator)
+    {
+    }
+
+    basic_insitu_string(basic_insitu_string&& other) JSONCONS_NOEXCEPT
+        : view_(other.view_), length_(other.length_), owned_(std::move(other.owned_))
+    {
+    }
+
+    basic_insitu_string(basic_insitu_string&& other, const Allocator& allocator)
+        : view_(other.view_), length_(other.length_), owned_(std::move(other.owned_),allocator)
+    {
+    }
+
+    basic_insitu_string& operator=(const basic_insitu_string& other)
+    {
+        view_ = other.view_;
+        length_ = other.length_;
+        owned_ = other.owned_;
+        return *this;
+    }
+
+    basic_insitu_string& operator=(basic_insitu_string&& other) JSONCONS_NOEXCEPT
+    {
+        view_ = other.view_;
+        length_ = other.length_;
+        owned_ = std::move(other.owned_);
+        return *this;
+    }
+
+    // True if the characters are not owned by this string
+    bool is_view() const
+    {
+        return view_ != nullptr;
+    }
+
+    const CharT* data() const
+    {
+        return view_ != nullptr ? view_ : owned_.data();
+    }
+
+    const CharT* c_str() const
+    {
+        return view_ != nullptr ? view_ : owned_.c_str();
+    }
+
+    size_t size() const
+    {
+        return view_ != nullptr ? length_ : owned_.size();
+    }
+
+    size_t length() const
+    {
+        return size();
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    const_iterator begin() const
+    {
+        return data();
+    }
+
+    const_iterator end() const
+    {
+        return data() + size();
+    }
+
+    const CharT& operator[](size_t i) const
+    {
+        return data()[i];
+    }
+
+    allocator_type get_allocator() const
+    {
+        return owned_.get_allocator();
+    }
+
+    int compare(const basic_insitu_string& other) const
+    {
+        return compare(other.data(), other.size());
+    }
+
+    int compare(const CharT* s, size_t length) const
+    {
+        size_t len = (std::min)(size(), length);
+        int result = traits_type::compare(data(), s, len);
+        if (result != 0)
+        {
+            return result;
+        }
+        return size() < length ? -1 : (size() == length ? 0 : 1);
+    }
+
+    void swap(basic_insitu_string& other) JSONCONS_NOEXCEPT
+    {
+        std::swap(view_, other.view_);
+        std::swap(length_, other.length_);
+        owned_.swap(other.owned_);
+    }
+
+    void shrink_to_fit()
+    {
+        owned_.shrink_to_fit();
+    }
+
+    operator std::basic_string<CharT,Traits>() const
+    {
+        return std::basic_string<CharT,Traits>(data(),size());
+    }
+
+    friend bool operator==(const basic_insitu_string& lhs, const basic_insitu_string& rhs)
+    {
+        return lhs.compare(rhs) == 0;
+    }
+
+    friend bool operator!=(const basic_insitu_string& lhs, const basic_insitu_string& rhs)
+    {
+        return lhs.compare(rhs) != 0;
+    }
+
+    friend bool operator<(const basic_insitu_string& lhs, const basic_insitu_string& rhs)
+    {
+        return lhs.compare(rhs) < 0;
+    }
+
+    friend std::basic_ostream<CharT>& operator<<(std::basic_ostream<CharT>& os, const basic_insitu_string& s)
+    {
+        os.write(s.data(),s.size());
+        return os;
+    }
+};
+
+namespace detail {
+
+// Storage for a string that lies in an in-situ buffer: a view when the
+// storage type supports it, a copy otherwise
+
+template <class StringT,class CharT,class Allocator>
+typename std::enable_if<std::is_constructible<StringT,const CharT*,size_t,insitu_arg_t>::value,StringT>::type
+insitu_string_storage(const CharT* s, size_t length, const Allocator&)
+{
+    return StringT(s,length,insitu_arg);
+}
+
+template <class StringT,class CharT,class Allocator>
+typename std::enable_if<!std::is_constructible<StringT,const CharT*,size_t,insitu_arg_t>::value,StringT>::type
+insitu_string_storage(const CharT* s, size_t length, const Allocator& allocator)
+{
+    return StringT(s,length,allocator);
+}
+
+}
+
+}
+
+#endif
@@ -26,8 +26,11 @@
 #include <jsoncons/json_serializer.hpp>
 #include <jsoncons/json_decoder.hpp>
 #include <jsoncons/json_reader.hpp>
+#include <jsoncons/mapped_file.hpp>
+#include <jsoncons/monotonic_arena.hpp>
 #include <jsoncons/json_type_traits.hpp>
 #include <jsoncons/json_error_category.hpp>
+#include <jsoncons/json_hash.hpp>
 
 #if defined(__GNUC__)
 #pragma GCC diagnostic push
@@ -376,6 +379,12 @@ public:
                 create(string_holder_allocator_type(a), data, length, a);
             }
 
+            string_data(const char_type* data, size_t length, insitu_arg_t, const Allocator& a)
+                : base_data(value_type::string_t)
+            {
+                create(string_holder_allocator_type(a), data, length, insitu_arg, a);
+            }
+
             ~string_data()
             {
                 typename std::allocator_traits<string_holder_allocator_type>:: template rebind_alloc<Json_string_<json_type>> alloc(ptr_->get_allocator());
@@ -680,6 +689,18 @@ public:
                 new(reinterpret_cast<void*>(&data_))string_data(s, length, alloc);
             }
         }
+
+        variant(const char_type* s, size_t length, insitu_arg_t, const Allocator& alloc)
+        {
+            if (length <= small_string_data::max_length)
+            {
+                new(reinterpret_cast<void*>(&data_))small_string_data(s, static_cast<uint8_t>(length));
+            }
+            else
+            {
+                new(reinterpret_cast<void*>(&data_))string_data(s, length, insitu_arg, alloc);
+            }
+        }
         variant(const object& val)
         {
             new(reinterpret_cast<void*>(&data_))object_data(val);
@@ -2237,6 +2258,24 @@ public:
     static basic_json parse(std::basic_istream<char_type>& is);
     static basic_json parse(std::basic_istream<char_type>& is, parse_error_handler& err_handler);
 
+    // The result and all its strings, arrays and objects are allocated with
+    // allocator, for example an arena_allocator
+    static basic_json parse(std::basic_istream<char_type>& is, const allocator_type& allocator)
+    {
+        parse_error_handler_type err_handler;
+        return parse(is,err_handler,allocator);
+    }
+
+    static basic_json parse(std::basic_istream<char_type>& is, 
+                            parse_error_handler& err_handler, 
+                            const allocator_type& allocator);
+
+    static basic_json parse(string_view_type s, const allocator_type& allocator)
+    {
+        parse_error_handler_type err_handler;
+        return parse(s,err_handler,allocator);
+    }
+
     static basic_json parse(string_view_type s)
     {
         parse_error_handler_type err_handler;
@@ -2256,7 +2295,14 @@ public:
 
     static basic_json parse(string_view_type s, parse_error_handler& err_handler)
     {
-        json_decoder<json_type> handler;
+        return parse(s,err_handler,allocator_type());
+    }
+
+    static basic_json parse(string_view_type s, 
+                            parse_error_handler& err_handler, 
+                            const allocator_type& allocator)
+    {
+        json_decoder<json_type> handler(char_allocator_type(allocator),allocator);
         basic_json_parser<char_type> parser(handler,err_handler);
 
         auto result = unicons::skip_bom(s.begin(), s.end());
@@ -2276,6 +2322,36 @@ public:
         return handler.get_result();
     }
 
+    // Parses s in place. Escaped strings are decoded into s and with
+    // insitu_json_traits the strings of the result are views of s.
+    static basic_json parse_insitu(char_type* s, size_t length)
+    {
+        parse_error_handler_type err_handler;
+        return parse_insitu(s,length,err_handler);
+    }
+
+    static basic_json parse_insitu(char_type* s, size_t length, parse_error_handler& err_handler)
+    {
+        json_decoder<json_type> handler(insitu_arg);
+        basic_json_parser<char_type> parser(handler,err_handler);
+
+        auto result = unicons::skip_bom(s, s + length);
+        if (result.ec != unicons::encoding_errc())
+        {
+            throw parse_error(result.ec,1,1);
+        }
+        size_t offset = result.it - s;
+        parser.set_source(s+offset,length-offset,insitu_arg);
+        parser.parse();
+        parser.end_parse();
+        parser.check_done();
+        if (!handler.is_valid())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Failed to parse json string");
+        }
+        return handler.get_result();
+    }
+
     static basic_json parse_file(const std::basic_string<char_type,char_traits_type>& filename)
     {
         parse_error_handler_type err_handler;
@@ -2285,8 +2361,7 @@ public:
     static basic_json parse_file(const std::basic_string<char_type,char_traits_type>& filename,
                                  parse_error_handler& err_handler)
     {
-        std::basic_ifstream<CharT> is(filename);
-        return parse(is,err_handler);
+        return parse_file(filename, err_handler, std::is_same<char_type,char>());
     }
 
     static basic_json make_array()
@@ -2462,6 +2537,13 @@ public:
         : var_(s, length, allocator)
     {
     }
+
+    // A string that refers to s, which must outlive it and be null terminated, 
+    // if string_storage_type supports that (see insitu_json_traits), otherwise a copy
+    basic_json(const char_type *s, size_t length, insitu_arg_t, const Allocator& allocator = Allocator())
+        : var_(s, length, insitu_arg, allocator)
+    {
+    }
 #if !defined(JSONCONS_NO_DEPRECATED)
     template<class InputIterator>
     basic_json(InputIterator first, InputIterator last, const Allocator& allocator = Allocator())
@@ -4306,6 +4388,28 @@ public:
 
 private:
 
+    // Narrow character files are mapped into memory and parsed in one pass
+    static basic_json parse_file(const std::basic_string<char_type,char_traits_type>& filename,
+                                 parse_error_handler& err_handler,
+                                 std::true_type)
+    {
+        std::error_code ec;
+        mapped_file file(filename, ec);
+        if (ec)
+        {
+            throw parse_error(json_parser_errc::source_error,1,1);
+        }
+        return parse(string_view_type(file.data(),file.size()),err_handler);
+    }
+
+    static basic_json parse_file(const std::basic_string<char_type,char_traits_type>& filename,
+                                 parse_error_handler& err_handler,
+                                 std::false_type)
+    {
+        std::basic_ifstream<CharT> is(filename);
+        return parse(is,err_handler);
+    }
+
     friend std::basic_ostream<char_type>& operator<<(std::basic_ostream<char_type>& os, const json_type& o)
     {
         o.dump(os);
@@ -4344,7 +4448,15 @@ template<class CharT,class JsonTraits,class Allocator>
 basic_json<CharT,JsonTraits,Allocator> basic_json<CharT,JsonTraits,Allocator>::parse(std::basic_istream<char_type>& is, 
                                                                                             parse_error_handler& err_handler)
 {
-    json_decoder<basic_json<CharT,JsonTraits,Allocator>> handler;
+    return parse(is,err_handler,allocator_type());
+}
+
+template<class CharT,class JsonTraits,class Allocator>
+basic_json<CharT,JsonTraits,Allocator> basic_json<CharT,JsonTraits,Allocator>::parse(std::basic_istream<char_type>& is, 
+                                                                                            parse_error_handler& err_handler,
+                                                                                            const allocator_type& allocator)
+{
+    json_decoder<basic_json<CharT,JsonTraits,Allocator>> handler(char_allocator_type(allocator),allocator);
     basic_json_reader<char_type> reader(is, handler, err_handler);
     reader.read_next();
     reader.check_done();
@@ -4438,6 +4550,12 @@ typedef basic_json<char,json_traits<char>,std::allocator<char>> json;
 typedef basic_json<wchar_t,json_traits<wchar_t>,std::allocator<wchar_t>> wjson;
 typedef basic_json<char, o_json_traits<char>, std::allocator<char>> ojson;
 typedef basic_json<wchar_t, o_json_traits<wchar_t>, std::allocator<wchar_t>> wojson;
+typedef basic_json<char, insitu_json_traits<char>, std::allocator<char>> insitu_json;
+typedef basic_json<wchar_t, insitu_json_traits<wchar_t>, std::allocator<wchar_t>> winsitu_json;
+typedef basic_json<char, json_traits<char>, arena_allocator<char>> arena_json;
+typedef basic_json<wchar_t, json_traits<wchar_t>, arena_allocator<wchar_t>> warena_json;
+typedef basic_json<char, hashed_json_traits<char>, std::allocator<char>> hashed_json;
+typedef basic_json<wchar_t, hashed_json_traits<wchar_t>, std::allocator<wchar_t>> whashed_json;
 
 #if !defined(JSONCONS_NO_DEPRECATED)
 typedef basic_json<wchar_t, o_json_traits<wchar_t>, std::allocator<wchar_t>> owjson;
@@ -4479,6 +4597,16 @@ jsoncons::wojson operator "" _ojson(const wchar_t* s, std::size_t n)
 
 }
 
+namespace std {
+    template<class CharT,class JsonTraits,class Allocator>
+    struct hash<jsoncons::basic_json<CharT,JsonTraits,Allocator>>
+    {
+        size_t operator()(const jsoncons::basic_json<CharT,JsonTraits,Allocator>& val) const
+        {
+            return jsoncons::hash_value(val);
+        }
+    };
+}
 
 #if defined(__GNUC__)
 #pragma GCC diagnostic pop
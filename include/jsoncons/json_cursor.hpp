@@ -0,0 +1,642 @@
+// Copyright 2017 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_JSON_CURSOR_HPP
+#define JSONCONS_JSON_CURSOR_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <istream>
+#include <stdexcept>
+#include <system_error>
+#include <jsoncons/json_exception.hpp>
+#include <jsoncons/json_input_handler.hpp>
+#include <jsoncons/parse_error_handler.hpp>
+#include <jsoncons/json_parser.hpp>
+
+namespace jsoncons {
+
+template<class CharT>
+class basic_json_cursor;
+
+enum class json_event_type
+{
+    begin_object,
+    end_object,
+    begin_array,
+    end_array,
+    name,
+    string_value,
+    integer_value,
+    uinteger_value,
+    double_value,
+    bool_value,
+    null_value
+};
+
+template<class CharT>
+class basic_json_event
+{
+public:
+    typedef typename basic_json_input_handler<CharT>::string_view_type string_view_type;
+private:
+    json_event_type event_type_;
+    std::basic_string<CharT> string_value_;
+    union
+    {
+        int64_t int64_value_;
+        uint64_t uint64_value_;
+        double double_value_;
+        bool bool_value_;
+    } value_;
+    uint8_t precision_;
+
+    friend class basic_json_cursor<CharT>;
+public:
+    basic_json_event()
+        : event_type_(json_event_type::null_value), precision_(0)
+    {
+        value_.int64_value_ = 0;
+    }
+
+    json_event_type event_type() const
+    {
+        return event_type_;
+    }
+
+    // Name or string value, valid until the cursor advances
+    string_view_type as_string_view() const
+    {
+        if (!(event_type_ == json_event_type::name || event_type_ == json_event_type::string_value))
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not a string");
+        }
+        return string_view_type(string_value_.data(),string_value_.length());
+    }
+
+    std::basic_string<CharT> as_string() const
+    {
+        string_view_type sv = as_string_view();
+        return std::basic_string<CharT>(sv.data(),sv.length());
+    }
+
+    int64_t as_integer() const
+    {
+        switch (event_type_)
+        {
+        case json_event_type::integer_value:
+            return value_.int64_value_;
+        case json_event_type::uinteger_value:
+            return static_cast<int64_t>(value_.uint64_value_);
+        case json_event_type::double_value:
+            return static_cast<int64_t>(value_.double_value_);
+        default:
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not an integer");
+        }
+    }
+
+    uint64_t as_uinteger() const
+    {
+        switch (event_type_)
+        {
+        case json_event_type::integer_value:
+            return static_cast<uint64_t>(value_.int64_value_);
+        case json_event_type::uinteger_value:
+            return value_.uint64_value_;
+        case json_event_type::double_value:
+            return static_cast<uint64_t>(value_.double_value_);
+        default:
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not an unsigned integer");
+        }
+    }
+
+    double as_double() const
+    {
+        switch (event_type_)
+        {
+        case json_event_type::integer_value:
+            return static_cast<double>(value_.int64_value_);
+        case json_event_type::uinteger_value:
+            return static_cast<double>(value_.uint64_value_);
+        case json_event_type::double_value:
+            return value_.double_value_;
+        default:
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not a double");
+        }
+    }
+
+    bool as_bool() const
+    {
+        if (event_type_ != json_event_type::bool_value)
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not a bool");
+        }
+        return value_.bool_value_;
+    }
+
+    // Number of significant digits of a double value read from text
+    uint8_t precision() const
+    {
+        return precision_;
+    }
+};
+
+// basic_json_cursor
+
+template<class CharT>
+class basic_json_cursor
+{
+public:
+    typedef typename basic_json_input_handler<CharT>::string_view_type string_view_type;
+private:
+    static const size_t default_max_buffer_length = 16384;
+
+    // Queues the events reported by the parser and stops it after each
+    // token, so that the parser runs no further ahead than the caller.
+    class event_queue : public basic_json_input_handler<CharT>
+    {
+        basic_json_cursor* cursor_;
+    public:
+        event_queue(basic_json_cursor* cursor)
+            : cursor_(cursor)
+        {
+        }
+    private:
+        void do_begin_json() override
+        {
+        }
+
+        void do_end_json() override
+        {
+            cursor_->parser_.stop();
+        }
+
+        void do_begin_object(const parsing_context&) override
+        {
+            cursor_->push_structural(json_event_type::begin_object);
+        }
+
+        void do_end_object(const parsing_context&) override
+        {
+            cursor_->push_structural(json_event_type::end_object);
+        }
+
+        void do_begin_array(const parsing_context&) override
+        {
+            cursor_->push_structural(json_event_type::begin_array);
+        }
+
+        void do_end_array(const parsing_context&) override
+        {
+            cursor_->push_structural(json_event_type::end_array);
+        }
+
+        void do_name(string_view_type name, const parsing_context&) override
+        {
+            basic_json_event<CharT>* event = cursor_->push(json_event_type::name);
+            if (event != nullptr)
+            {
+                event->string_value_.assign(name.data(),name.length());
+            }
+        }
+
+        void do_string_value(string_view_type value, const parsing_context&) override
+        {
+            basic_json_event<CharT>* event = cursor_->push(json_event_type::string_value);
+            if (event != nullptr)
+            {
+                event->string_value_.assign(value.data(),value.length());
+            }
+        }
+
+        void do_integer_value(int64_t value, const parsing_context&) override
+        {
+            basic_json_event<CharT>* event = cursor_->push(json_event_type::integer_value);
+            if (event != nullptr)
+            {
+                event->value_.int64_value_ = value;
+            }
+        }
+
+        void do_uinteger_value(uint64_t value, const parsing_context&) override
+        {
+            basic_json_event<CharT>* event = cursor_->push(json_event_type::uinteger_value);
+            if (event != nullptr)
+            {
+                event->value_.uint64_value_ = value;
+            }
+        }
+
+        void do_double_value(double value, uint8_t precision, const parsing_context&) override
+        {
+            basic_json_event<CharT>* event = cursor_->push(json_event_type::double_value);
+            if (event != nullptr)
+            {
+                event->value_.double_value_ = value;
+                event->precision_ = precision;
+            }
+        }
+
+        void do_bool_value(bool value, const parsing_context&) override
+        {
+            basic_json_event<CharT>* event = cursor_->push(json_event_type::bool_value);
+            if (event != nullptr)
+            {
+                event->value_.bool_value_ = value;
+            }
+        }
+
+        void do_null_value(const parsing_context&) override
+        {
+            cursor_->push(json_event_type::null_value);
+        }
+    };
+
+    event_queue queue_;
+    basic_json_parser<CharT> parser_;
+    std::basic_istream<CharT>* is_;
+    bool eof_;
+    std::vector<CharT> buffer_;
+    size_t buffer_length_;
+    bool begin_;
+
+    // events_[index_,count_) are pending, events_[index_] is current
+    std::vector<basic_json_event<CharT>> events_;
+    size_t index_;
+    size_t count_;
+    // Nesting depth still to be skipped, events are dropped while > 0
+    size_t skip_depth_;
+
+    // Noncopyable and nonmoveable
+    basic_json_cursor(const basic_json_cursor&) = delete;
+    basic_json_cursor& operator=(const basic_json_cursor&) = delete;
+
+public:
+
+    basic_json_cursor(std::basic_istream<CharT>& is)
+        : queue_(this),
+          parser_(queue_),
+          is_(std::addressof(is)),
+          eof_(false),
+          buffer_length_(default_max_buffer_length),
+          begin_(true),
+          index_(0),
+          count_(0),
+          skip_depth_(0)
+    {
+        buffer_.reserve(buffer_length_);
+        next();
+    }
+
+    basic_json_cursor(std::basic_istream<CharT>& is,
+                      parse_error_handler& err_handler)
+        : queue_(this),
+          parser_(queue_,err_handler),
+          is_(std::addressof(is)),
+          eof_(false),
+          buffer_length_(default_max_buffer_length),
+          begin_(true),
+          index_(0),
+          count_(0),
+          skip_depth_(0)
+    {
+        buffer_.reserve(buffer_length_);
+        next();
+    }
+
+    basic_json_cursor(std::basic_istream<CharT>& is,
+                      std::error_code& ec)
+        : queue_(this),
+          parser_(queue_),
+          is_(std::addressof(is)),
+          eof_(false),
+          buffer_length_(default_max_buffer_length),
+          begin_(true),
+          index_(0),
+          count_(0),
+          skip_depth_(0)
+    {
+        buffer_.reserve(buffer_length_);
+        next(ec);
+    }
+
+    // The text is not copied and must outlive the cursor
+    basic_json_cursor(string_view_type s)
+        : queue_(this),
+          parser_(queue_),
+          is_(nullptr),
+          eof_(false),
+          buffer_length_(default_max_buffer_length),
+          begin_(true),
+          index_(0),
+          count_(0),
+          skip_depth_(0)
+    {
+        set_text(s);
+        next();
+    }
+
+    basic_json_cursor(string_view_type s,
+                      parse_error_handler& err_handler)
+        : queue_(this),
+          parser_(queue_,err_handler),
+          is_(nullptr),
+          eof_(false),
+          buffer_length_(default_max_buffer_length),
+          begin_(true),
+          index_(0),
+          count_(0),
+          skip_depth_(0)
+    {
+        set_text(s);
+        next();
+    }
+
+    basic_json_cursor(string_view_type s,
+                      std::error_code& ec)
+        : queue_(this),
+          parser_(queue_),
+          is_(nullptr),
+          eof_(false),
+          buffer_length_(default_max_buffer_length),
+          begin_(true),
+          index_(0),
+          count_(0),
+          skip_depth_(0)
+    {
+        set_text(s, ec);
+        if (!ec)
+        {
+            next(ec);
+        }
+    }
+
+    size_t buffer_length() const
+    {
+        return buffer_length_;
+    }
+
+    void buffer_length(size_t length)
+    {
+        buffer_length_ = length;
+        buffer_.reserve(buffer_length_);
+    }
+
+    size_t max_nesting_depth() const
+    {
+        return parser_.max_nesting_depth();
+    }
+
+    void max_nesting_depth(size_t depth)
+    {
+        parser_.max_nesting_depth(depth);
+    }
+
+    bool done() const
+    {
+        return index_ == count_ && parser_.done();
+    }
+
+    const basic_json_event<CharT>& current_event() const
+    {
+        JSONCONS_ASSERT(index_ < count_);
+        return events_[index_];
+    }
+
+    void next()
+    {
+        std::error_code ec;
+        next(ec);
+        if (ec)
+        {
+            throw parse_error(ec,parser_.line_number(),parser_.column_number());
+        }
+    }
+
+    void next(std::error_code& ec)
+    {
+        if (index_ < count_)
+        {
+            ++index_;
+        }
+        fill(ec);
+    }
+
+    // If the current event is begin_object or begin_array, advances to the
+    // matching end_object or end_array. The events in between are parsed
+    // but not queued. For other events skip does nothing.
+    void skip()
+    {
+        std::error_code ec;
+        skip(ec);
+        if (ec)
+        {
+            throw parse_error(ec,parser_.line_number(),parser_.column_number());
+        }
+    }
+
+    void skip(std::error_code& ec)
+    {
+        if (index_ >= count_)
+        {
+            return;
+        }
+        json_event_type type = events_[index_].event_type_;
+        if (type != json_event_type::begin_object && type != json_event_type::begin_array)
+        {
+            return;
+        }
+
+        // Events the parser has already queued
+        size_t depth = 1;
+        while (index_+1 < count_)
+        {
+            ++index_;
+            switch (events_[index_].event_type_)
+            {
+            case json_event_type::begin_object:
+            case json_event_type::begin_array:
+                ++depth;
+                break;
+            case json_event_type::end_object:
+            case json_event_type::end_array:
+                if (--depth == 0)
+                {
+                    return;
+                }
+                break;
+            default:
+                break;
+            }
+        }
+
+        // The rest are dropped as they are parsed, until the matching end
+        // is queued
+        index_ = count_ = 0;
+        skip_depth_ = depth;
+        fill(ec);
+    }
+
+    size_t line_number() const
+    {
+        return parser_.line_number();
+    }
+
+    size_t column_number() const
+    {
+        return parser_.column_number();
+    }
+
+private:
+
+    void set_text(string_view_type s)
+    {
+        std::error_code ec;
+        set_text(s, ec);
+        if (ec)
+        {
+            throw parse_error(ec,1,1);
+        }
+    }
+
+    void set_text(string_view_type s, std::error_code& ec)
+    {
+        auto result = unicons::skip_bom(s.begin(), s.end());
+        if (result.ec != unicons::encoding_errc())
+        {
+            ec = result.ec;
+            return;
+        }
+        size_t offset = result.it - s.begin();
+        parser_.set_source(s.data()+offset,s.length()-offset);
+        begin_ = false;
+        eof_ = true;
+    }
+
+    basic_json_event<CharT>* push(json_event_type type)
+    {
+        if (skip_depth_ > 0)
+        {
+            return nullptr;
+        }
+        if (count_ == events_.size())
+        {
+            events_.emplace_back();
+        }
+        basic_json_event<CharT>* event = std::addressof(events_[count_++]);
+        event->event_type_ = type;
+        parser_.stop();
+        return event;
+    }
+
+    void push_structural(json_event_type type)
+    {
+        if (skip_depth_ > 0)
+        {
+            switch (type)
+            {
+            case json_event_type::begin_object:
+            case json_event_type::begin_array:
+                ++skip_depth_;
+                return;
+            default:
+                if (--skip_depth_ > 0)
+                {
+                    return;
+                }
+                break;
+            }
+        }
+        push(type);
+    }
+
+    // Parses until an event is pending or the text is done
+    void fill(std::error_code& ec)
+    {
+        if (index_ == count_)
+        {
+            index_ = count_ = 0;
+        }
+        while (index_ == count_ && !parser_.done())
+        {
+            if (parser_.source_exhausted())
+            {
+                if (!eof_)
+                {
+                    if (!is_->eof())
+                    {
+                        if (is_->fail())
+                        {
+                            ec = json_parser_errc::source_error;
+                            return;
+                        }
+                        read_buffer(ec);
+                        if (ec) return;
+                    }
+                    else
+                    {
+                        eof_ = true;
+                    }
+                }
+                if (eof_)
+                {
+                    parser_.end_parse(ec);
+                    if (ec) return;
+                    if (!parser_.done())
+                    {
+                        ec = json_parser_errc::unexpected_eof;
+                        return;
+                    }
+                }
+            }
+            else
+            {
+                parser_.parse(ec);
+                if (ec) return;
+            }
+        }
+    }
+
+    void read_buffer(std::error_code& ec)
+    {
+        buffer_.clear();
+        buffer_.resize(buffer_length_);
+        is_->read(buffer_.data(), buffer_length_);
+        buffer_.resize(static_cast<size_t>(is_->gcount()));
+        if (buffer_.size() == 0)
+        {
+            eof_ = true;
+        }
+        else if (begin_)
+        {
+            auto result = unicons::skip_bom(buffer_.begin(), buffer_.end());
+            if (result.ec != unicons::encoding_errc())
+            {
+                ec = result.ec;
+                return;
+            }
+            size_t offset = result.it - buffer_.begin();
+            parser_.set_source(buffer_.data()+offset,buffer_.size()-offset);
+            begin_ = false;
+        }
+        else
+        {
+            parser_.set_source(buffer_.data(),buffer_.size());
+        }
+    }
+};
+
+typedef basic_json_cursor<char> json_cursor;
+typedef basic_json_cursor<wchar_t> wjson_cursor;
+
+typedef basic_json_event<char> json_event;
+typedef basic_json_event<wchar_t> wjson_event;
+
+}
+
+#endif
+
@@ -15,6 +15,7 @@
 #include <memory>
 #include <jsoncons/json_exception.hpp>
 #include <jsoncons/json_input_handler.hpp>
+#include <jsoncons/insitu_string.hpp>
 
 namespace jsoncons {
 
@@ -31,7 +32,7 @@ public:
     typedef typename Json::key_value_pair_type key_value_pair_type;
     typedef typename Json::string_type string_type;
     typedef typename Json::key_storage_type key_storage_type;
-    typedef typename string_type::allocator_type char_allocator;
+    typedef typename Json::char_allocator_type char_allocator;
     typedef typename Json::allocator_type allocator_type;
     typedef typename Json::array array;
     typedef typename array::allocator_type array_allocator;
@@ -53,6 +54,7 @@ public:
     std::vector<stack_item> stack_;
     std::vector<size_t> stack_offsets_;
     bool is_valid_;
+    bool insitu_;
 
 public:
     json_decoder(const char_allocator& sa = char_allocator(),
@@ -63,12 +65,30 @@ public:
           top_(0),
           stack_(default_stack_size),
           stack_offsets_(),
-          is_valid_(false) 
+          is_valid_(false),
+          insitu_(false)
 
     {
         stack_offsets_.reserve(100);
     }
 
+    // For a parser with an in-situ source: names and string values are 
+    // stored as views of the parsed text when Json's storage supports it
+    json_decoder(insitu_arg_t,
+                 const char_allocator& sa = char_allocator(),
+                 const allocator_type& allocator = allocator_type())
+        : sa_(sa),
+          oa_(allocator),
+          aa_(allocator),
+          top_(0),
+          stack_(default_stack_size),
+          stack_offsets_(),
+          is_valid_(false),
+          insitu_(true)
+    {
+        stack_offsets_.reserve(100);
+    }
+
     bool is_valid() const
     {
         return is_valid_;
@@ -200,12 +220,26 @@ private:
 
     void do_name(string_view_type name, const parsing_context&) override
     {
-        stack_[top_].name_ = key_storage_type(name.begin(),name.end(),sa_);
+        if (insitu_)
+        {
+            stack_[top_].name_ = detail::insitu_string_storage<key_storage_type>(name.data(),name.length(),sa_);
+        }
+        else
+        {
+            stack_[top_].name_ = key_storage_type(name.begin(),name.end(),sa_);
+        }
     }
 
     void do_string_value(string_view_type val, const parsing_context&) override
     {
-        stack_[top_].value_ = Json(val.data(),val.length(),sa_);
+        if (insitu_)
+        {
+            stack_[top_].value_ = Json(val.data(),val.length(),insitu_arg,sa_);
+        }
+        else
+        {
+            stack_[top_].value_ = Json(val.data(),val.length(),sa_);
+        }
         if (++top_ >= stack_.size())
         {
             stack_.resize(top_*2);
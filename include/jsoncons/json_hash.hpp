@@ -0,0 +1,173 @@
+// Copyright 2013 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_JSON_HASH_HPP
+#define JSONCONS_JSON_HASH_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <cstddef>
+#include <unordered_map>
+
+namespace jsoncons {
+
+template <class CharT, class JsonTraits, class Allocator>
+class basic_json;
+
+namespace detail {
+
+const uint64_t fnv_offset_basis = 14695981039346656037ULL;
+const uint64_t fnv_prime = 1099511628211ULL;
+
+// splitmix64 finalizer
+inline
+uint64_t mix_hash(uint64_t h)
+{
+    h ^= h >> 30;
+    h *= 0xbf58476d1ce4e5b9ULL;
+    h ^= h >> 27;
+    h *= 0x94d049bb133111ebULL;
+    h ^= h >> 31;
+    return h;
+}
+
+template <class StringView>
+uint64_t hash_chars(const StringView& s)
+{
+    uint64_t h = fnv_offset_basis;
+    for (auto c : s)
+    {
+        h = (h ^ static_cast<uint64_t>(c)) * fnv_prime;
+    }
+    return h;
+}
+
+template <class Json, class ChildHash>
+uint64_t hash_json(const Json& val, ChildHash child_hash)
+{
+    if (val.is_null())
+    {
+        return mix_hash(1);
+    }
+    else if (val.is_bool())
+    {
+        return mix_hash(val.as_bool() ? 2 : 3);
+    }
+    else if (val.is_number())
+    {
+        // Integers and doubles that compare equal hash alike
+        double d = val.as_double();
+        if (d == 0.0)
+        {
+            d = 0.0;
+        }
+        uint64_t bits;
+        std::memcpy(&bits, &d, sizeof(bits));
+        return mix_hash(bits ^ 4);
+    }
+    else if (val.is_string())
+    {
+        return mix_hash(hash_chars(val.as_string_view()) ^ 5);
+    }
+    else if (val.is_array())
+    {
+        uint64_t h = fnv_offset_basis ^ 6;
+        for (const auto& item : val.array_range())
+        {
+            h = (h ^ child_hash(item)) * fnv_prime;
+        }
+        return mix_hash(h);
+    }
+    else if (val.is_object())
+    {
+        // Members are summed so that the hash doesn't depend on their order
+        uint64_t h = 7;
+        for (const auto& member : val.object_range())
+        {
+            h += mix_hash(hash_chars(member.key()) ^ (child_hash(member.value()) * fnv_prime));
+        }
+        return mix_hash(h);
+    }
+    return 0;
+}
+
+}
+
+// A structural hash that is the same for values that compare equal, and
+// the same from run to run. Object members are hashed independently of
+// their order, array elements in order.
+template <class CharT, class JsonTraits, class Allocator>
+size_t hash_value(const basic_json<CharT,JsonTraits,Allocator>& val)
+{
+    typedef basic_json<CharT,JsonTraits,Allocator> Json;
+
+    struct child_hash
+    {
+        uint64_t operator()(const Json& child) const
+        {
+            return detail::hash_json(child, child_hash());
+        }
+    };
+    return static_cast<size_t>(detail::hash_json(val, child_hash()));
+}
+
+// Remembers the hashes of the arrays and objects in documents that are
+// not modified while the cache is in use, so that each subtree is hashed
+// once and subtrees with different hashes compare unequal in constant time.
+template <class Json>
+class json_hash_cache
+{
+    std::unordered_map<const Json*,uint64_t> hashes_;
+public:
+    size_t hash(const Json& val)
+    {
+        return static_cast<size_t>(hash_(val));
+    }
+
+    bool equal(const Json& a, const Json& b)
+    {
+        if (&a == &b)
+        {
+            return true;
+        }
+        if ((a.is_array() || a.is_object()) && (b.is_array() || b.is_object()) &&
+            hash_(a) != hash_(b))
+        {
+            return false;
+        }
+        return a == b;
+    }
+
+    size_t size() const
+    {
+        return hashes_.size();
+    }
+
+    void clear()
+    {
+        hashes_.clear();
+    }
+private:
+    uint64_t hash_(const Json& val)
+    {
+        if (!val.is_array() && !val.is_object())
+        {
+            return detail::hash_json(val, [this](const Json& child){return hash_(child);});
+        }
+        auto it = hashes_.find(&val);
+        if (it != hashes_.end())
+        {
+            return it->second;
+        }
+        uint64_t h = detail::hash_json(val, [this](const Json& child){return hash_(child);});
+        hashes_.emplace(&val, h);
+        return h;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,521 @@
+// Copyright 2017 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_JSON_LINES_READER_HPP
+#define JSONCONS_JSON_LINES_READER_HPP
+
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <memory>
+#include <istream>
+#include <algorithm>
+#include <exception>
+#include <system_error>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_parser.hpp>
+#include <jsoncons/json_decoder.hpp>
+
+namespace jsoncons {
+
+class json_lines_options
+{
+    size_t thread_count_;
+    size_t chunk_size_;
+    bool ordered_;
+public:
+    static const size_t default_chunk_size = 1024*1024;
+
+    json_lines_options()
+        : thread_count_(0),
+          chunk_size_(default_chunk_size),
+          ordered_(true)
+    {
+    }
+
+    // The number of threads that parse records, 0 for one per hardware thread.
+    // With 1, records are parsed on the calling thread.
+    size_t thread_count() const {return thread_count_;}
+    json_lines_options& thread_count(size_t value) {thread_count_ = value; return *this;}
+
+    // The approximate number of characters in a chunk, a run of whole records
+    // parsed by one thread
+    size_t chunk_size() const {return chunk_size_;}
+    json_lines_options& chunk_size(size_t value) {chunk_size_ = value > 0 ? value : 1; return *this;}
+
+    // If true, records are delivered in source order, otherwise a chunk is
+    // delivered as soon as it has been parsed
+    bool ordered() const {return ordered_;}
+    json_lines_options& ordered(bool value) {ordered_ = value; return *this;}
+};
+
+// Reads newline delimited JSON (JSON Lines, NDJSON). Each non blank line is
+// a JSON text. The input is cut into chunks of whole lines, and the chunks
+// are parsed on a pool of threads, each with its own parser and decoder.
+// Values are passed to the caller's function on the calling thread, one at
+// a time, together with their line number.
+
+template <class Json>
+class basic_json_lines_reader
+{
+public:
+    typedef Json json_type;
+    typedef typename Json::char_type char_type;
+    typedef typename Json::string_view_type string_view_type;
+private:
+    typedef std::char_traits<char_type> char_traits_type;
+
+    struct chunk
+    {
+        size_t sequence;
+        size_t first_line;
+        std::basic_string<char_type> buffer;
+        const char_type* data;
+        size_t length;
+
+        std::vector<Json> values;
+        std::vector<size_t> lines;
+        std::error_code ec;
+        size_t error_line;
+        size_t error_column;
+        std::exception_ptr exception;
+
+        chunk(size_t sequence, size_t first_line)
+            : sequence(sequence), first_line(first_line), data(nullptr), length(0),
+              error_line(0), error_column(0)
+        {
+        }
+    };
+
+    struct shared_state
+    {
+        std::mutex mutex;
+        std::condition_variable work_available;
+        std::condition_variable chunk_parsed;
+        std::deque<std::unique_ptr<chunk>> pending;
+        std::map<size_t,std::unique_ptr<chunk>> parsed;
+        bool stop;
+
+        shared_state()
+            : stop(false)
+        {
+        }
+    };
+
+    // Stops and joins the workers however read returns
+    class worker_pool
+    {
+        shared_state& state_;
+        std::vector<std::thread> threads_;
+    public:
+        worker_pool(shared_state& state, size_t thread_count)
+            : state_(state)
+        {
+            threads_.reserve(thread_count);
+            for (size_t i = 0; i < thread_count; ++i)
+            {
+                threads_.emplace_back(&worker_pool::run, std::ref(state_));
+            }
+        }
+
+        ~worker_pool()
+        {
+            {
+                std::lock_guard<std::mutex> lock(state_.mutex);
+                state_.stop = true;
+            }
+            state_.work_available.notify_all();
+            for (auto& t : threads_)
+            {
+                t.join();
+            }
+        }
+
+        static void run(shared_state& state)
+        {
+            json_decoder<Json> decoder;
+            basic_json_parser<char_type> parser(decoder);
+            for (;;)
+            {
+                std::unique_ptr<chunk> c;
+                {
+                    std::unique_lock<std::mutex> lock(state.mutex);
+                    state.work_available.wait(lock, [&state]{return state.stop || !state.pending.empty();});
+                    if (state.stop)
+                    {
+                        return;
+                    }
+                    c = std::move(state.pending.front());
+                    state.pending.pop_front();
+                }
+                parse_chunk(*c, parser, decoder);
+                {
+                    std::lock_guard<std::mutex> lock(state.mutex);
+                    size_t sequence = c->sequence;
+                    state.parsed.emplace(sequence, std::move(c));
+                }
+                state.chunk_parsed.notify_one();
+            }
+        }
+    };
+
+    std::basic_istream<char_type>* is_;
+    string_view_type text_;
+    json_lines_options options_;
+    size_t position_;
+    size_t line_count_;
+    std::basic_string<char_type> carry_;
+    bool begin_;
+    size_t line_;
+    size_t column_;
+
+    // Noncopyable and nonmoveable
+    basic_json_lines_reader(const basic_json_lines_reader&) = delete;
+    basic_json_lines_reader& operator=(const basic_json_lines_reader&) = delete;
+public:
+    basic_json_lines_reader(std::basic_istream<char_type>& is,
+                            const json_lines_options& options = json_lines_options())
+        : is_(std::addressof(is)),
+          options_(options),
+          position_(0),
+          line_count_(0),
+          begin_(true),
+          line_(0),
+          column_(0)
+    {
+    }
+
+    // Reads from text held in memory, for example a mapped_file, which
+    // must outlive the reader. Chunks are not copied.
+    basic_json_lines_reader(string_view_type s,
+                            const json_lines_options& options = json_lines_options())
+        : is_(nullptr),
+          text_(s),
+          options_(options),
+          position_(0),
+          line_count_(0),
+          begin_(true),
+          line_(0),
+          column_(0)
+    {
+    }
+
+    // Calls f(Json&& value, size_t line_number) for each record. Throws
+    // parse_error for the first record that is not valid JSON, after the
+    // values of the records before it, or in unordered mode the records
+    // of the chunks parsed before it, have been delivered.
+    template <class F>
+    void read(F f)
+    {
+        std::error_code ec;
+        read(f, ec);
+        if (ec)
+        {
+            throw parse_error(ec,line_,column_);
+        }
+    }
+
+    template <class F>
+    void read(F f, std::error_code& ec)
+    {
+        size_t thread_count = options_.thread_count();
+        if (thread_count == 0)
+        {
+            thread_count = std::thread::hardware_concurrency();
+        }
+        if (thread_count <= 1)
+        {
+            read_sequential(f, ec);
+        }
+        else
+        {
+            read_parallel(f, ec, thread_count);
+        }
+    }
+
+    // The line and column of the error after read fails
+    size_t line_number() const
+    {
+        return line_;
+    }
+
+    size_t column_number() const
+    {
+        return column_;
+    }
+
+private:
+    template <class F>
+    void read_sequential(F f, std::error_code& ec)
+    {
+        json_decoder<Json> decoder;
+        basic_json_parser<char_type> parser(decoder);
+        for (;;)
+        {
+            std::unique_ptr<chunk> c = next_chunk(0, ec);
+            if (ec || !c)
+            {
+                return;
+            }
+            parse_chunk(*c, parser, decoder);
+            if (!deliver(*c, f, ec))
+            {
+                return;
+            }
+        }
+    }
+
+    template <class F>
+    void read_parallel(F f, std::error_code& ec, size_t thread_count)
+    {
+        shared_state state;
+        worker_pool pool(state, thread_count);
+
+        // Enough chunks in flight to keep every thread busy while the
+        // caller is consuming values
+        const size_t max_in_flight = thread_count * 2;
+        size_t next_sequence = 0;
+        size_t next_delivery = 0;
+        size_t in_flight = 0;
+        bool more = true;
+
+        for (;;)
+        {
+            while (more && in_flight < max_in_flight)
+            {
+                std::unique_ptr<chunk> c = next_chunk(next_sequence, ec);
+                if (ec)
+                {
+                    return;
+                }
+                if (!c)
+                {
+                    more = false;
+                    break;
+                }
+                {
+                    std::lock_guard<std::mutex> lock(state.mutex);
+                    state.pending.push_back(std::move(c));
+                }
+                state.work_available.notify_one();
+                ++next_sequence;
+                ++in_flight;
+            }
+            if (in_flight == 0)
+            {
+                return;
+            }
+
+            std::unique_ptr<chunk> c;
+            {
+                std::unique_lock<std::mutex> lock(state.mutex);
+                if (options_.ordered())
+                {
+                    state.chunk_parsed.wait(lock, [&]{return state.parsed.count(next_delivery) != 0;});
+                    auto it = state.parsed.find(next_delivery);
+                    c = std::move(it->second);
+                    state.parsed.erase(it);
+                }
+                else
+                {
+                    state.chunk_parsed.wait(lock, [&]{return !state.parsed.empty();});
+                    auto it = state.parsed.begin();
+                    c = std::move(it->second);
+                    state.parsed.erase(it);
+                }
+            }
+            --in_flight;
+            ++next_delivery;
+            if (!deliver(*c, f, ec))
+            {
+                return;
+            }
+        }
+    }
+
+    template <class F>
+    bool deliver(chunk& c, F& f, std::error_code& ec)
+    {
+        for (size_t i = 0; i < c.values.size(); ++i)
+        {
+            f(std::move(c.values[i]), c.lines[i]);
+        }
+        if (c.exception)
+        {
+            std::rethrow_exception(c.exception);
+        }
+        if (c.ec)
+        {
+            ec = c.ec;
+            line_ = c.error_line;
+            column_ = c.error_column;
+            return false;
+        }
+        return true;
+    }
+
+    // The next run of whole lines, or null at the end of the input
+    std::unique_ptr<chunk> next_chunk(size_t sequence, std::error_code& ec)
+    {
+        std::unique_ptr<chunk> c(new chunk(sequence, line_count_ + 1));
+        if (is_ == nullptr)
+        {
+            if (begin_)
+            {
+                begin_ = false;
+                if (!skip_bom(text_.data(), text_.size(), position_, ec))
+                {
+                    return nullptr;
+                }
+            }
+            if (position_ >= text_.size())
+            {
+                return nullptr;
+            }
+            const char_type* first = text_.data() + position_;
+            size_t remaining = text_.size() - position_;
+            size_t length = remaining;
+            if (options_.chunk_size() < remaining)
+            {
+                const char_type* nl = char_traits_type::find(first + options_.chunk_size(),
+                                                             remaining - options_.chunk_size(),
+                                                             '\n');
+                length = nl == nullptr ? remaining : (nl - first) + 1;
+            }
+            c->data = first;
+            c->length = length;
+            position_ += length;
+        }
+        else
+        {
+            c->buffer.swap(carry_);
+            carry_.clear();
+            size_t last_newline = std::basic_string<char_type>::npos;
+            while (last_newline == std::basic_string<char_type>::npos && !is_->eof())
+            {
+                if (is_->fail())
+                {
+                    ec = json_parser_errc::source_error;
+                    return nullptr;
+                }
+                size_t old_size = c->buffer.size();
+                c->buffer.resize(old_size + options_.chunk_size());
+                is_->read(&c->buffer[old_size], options_.chunk_size());
+                c->buffer.resize(old_size + static_cast<size_t>(is_->gcount()));
+                last_newline = c->buffer.rfind('\n');
+            }
+            if (begin_)
+            {
+                begin_ = false;
+                size_t offset = 0;
+                if (!skip_bom(c->buffer.data(), c->buffer.size(), offset, ec))
+                {
+                    return nullptr;
+                }
+                c->buffer.erase(0, offset);
+                if (last_newline != std::basic_string<char_type>::npos)
+                {
+                    last_newline -= offset;
+                }
+            }
+            if (c->buffer.empty())
+            {
+                return nullptr;
+            }
+            if (last_newline != std::basic_string<char_type>::npos && !is_->eof())
+            {
+                carry_.assign(c->buffer, last_newline + 1, std::basic_string<char_type>::npos);
+                c->buffer.resize(last_newline + 1);
+            }
+            c->data = c->buffer.data();
+            c->length = c->buffer.size();
+        }
+        line_count_ += std::count(c->data, c->data + c->length, '\n');
+        return c;
+    }
+
+    bool skip_bom(const char_type* data, size_t length, size_t& offset, std::error_code& ec)
+    {
+        auto result = unicons::skip_bom(data, data + length);
+        if (result.ec != unicons::encoding_errc())
+        {
+            ec = result.ec;
+            line_ = 1;
+            column_ = 1;
+            return false;
+        }
+        offset = result.it - data;
+        return true;
+    }
+
+    static bool is_blank(const char_type* first, const char_type* last)
+    {
+        for (; first != last; ++first)
+        {
+            if (*first != ' ' && *first != '\t' && *first != '\r')
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    static void parse_chunk(chunk& c, basic_json_parser<char_type>& parser, json_decoder<Json>& decoder)
+    {
+        try
+        {
+            const char_type* p = c.data;
+            const char_type* end = c.data + c.length;
+            size_t line = c.first_line;
+            while (p < end)
+            {
+                const char_type* nl = char_traits_type::find(p, end - p, '\n');
+                const char_type* line_end = nl == nullptr ? end : nl;
+                if (!is_blank(p, line_end))
+                {
+                    std::error_code ec;
+                    parser.reset();
+                    parser.set_source(p, line_end - p);
+                    parser.parse(ec);
+                    if (!ec)
+                    {
+                        parser.end_parse(ec);
+                    }
+                    if (!ec)
+                    {
+                        parser.check_done(ec);
+                    }
+                    if (ec)
+                    {
+                        c.ec = ec;
+                        c.error_line = line;
+                        c.error_column = parser.column_number();
+                        return;
+                    }
+                    c.values.push_back(decoder.get_result());
+                    c.lines.push_back(line);
+                }
+                p = line_end + 1;
+                ++line;
+            }
+        }
+        catch (...)
+        {
+            c.exception = std::current_exception();
+        }
+    }
+};
+
+typedef basic_json_lines_reader<json> json_lines_reader;
+typedef basic_json_lines_reader<wjson> wjson_lines_reader;
+
+}
+
+#endif
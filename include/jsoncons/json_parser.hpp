@@ -13,12 +13,15 @@
 #include <vector>
 #include <istream>
 #include <cstdlib>
+#include <cstring>
 #include <stdexcept>
 #include <system_error>
 #include <jsoncons/json_exception.hpp>
 #include <jsoncons/json_input_handler.hpp>
 #include <jsoncons/parse_error_handler.hpp>
 #include <jsoncons/json_error_category.hpp>
+#include <jsoncons/insitu_string.hpp>
+#include <jsoncons/detail/simd_scan.hpp>
 
 #define JSONCONS_ILLEGAL_CONTROL_CHARACTER \
         case 0x00:case 0x01:case 0x02:case 0x03:case 0x04:case 0x05:case 0x06:case 0x07:case 0x08:case 0x0b: \
@@ -188,9 +191,11 @@ class basic_json_parser : private parsing_context
     const CharT* begin_input_;
     const CharT* end_input_;
     const CharT* p_;
+    CharT* insitu_input_;
 
     parse_state state_;
     std::vector<parse_state> state_stack_;
+    bool continue_;
 
     // Noncopyable and nonmoveable
     basic_json_parser(const basic_json_parser&) = delete;
@@ -212,7 +217,9 @@ public:
          begin_input_(nullptr),
          end_input_(nullptr),
          p_(nullptr),
-         state_(parse_state::start)
+         insitu_input_(nullptr),
+         state_(parse_state::start),
+         continue_(true)
     {
         max_depth_ = (std::numeric_limits<int>::max)();
 
@@ -234,7 +241,9 @@ public:
          begin_input_(nullptr),
          end_input_(nullptr),
          p_(nullptr),
-         state_(parse_state::start)
+         insitu_input_(nullptr),
+         state_(parse_state::start),
+         continue_(true)
     {
         max_depth_ = (std::numeric_limits<int>::max)();
 
@@ -256,7 +265,9 @@ public:
          begin_input_(nullptr),
          end_input_(nullptr),
          p_(nullptr),
-         state_(parse_state::start)
+         insitu_input_(nullptr),
+         state_(parse_state::start),
+         continue_(true)
     {
         max_depth_ = (std::numeric_limits<int>::max)();
 
@@ -279,7 +290,9 @@ public:
          begin_input_(nullptr),
          end_input_(nullptr),
          p_(nullptr),
-         state_(parse_state::start)
+         insitu_input_(nullptr),
+         state_(parse_state::start),
+         continue_(true)
     {
         max_depth_ = (std::numeric_limits<int>::max)();
 
@@ -337,25 +350,18 @@ public:
         return state_ == parse_state::done;
     }
 
+    // Called from a handler callback, makes parse return as soon as the
+    // current token is finished. The next call to parse resumes from there.
+    void stop()
+    {
+        continue_ = false;
+    }
+
     void skip_whitespace()
     {
-        const CharT* local_end_input = end_input_;
-        for (;;) 
-        {
-            if (JSONCONS_UNLIKELY(p_ == local_end_input)) 
-            {
-                return;
-            } 
-            else if (*p_ == ' ' || *p_ == '\t') 
-            {
-                ++p_;
-                ++column_;                     
-            } 
-            else 
-            {
-                return;
-            }
-        }
+        const CharT* p = detail::scan_blanks(p_, end_input_);
+        column_ += (p - p_);
+        p_ = p;
     }
 
     void do_begin_object(std::error_code& ec)
@@ -507,8 +513,9 @@ public:
     void parse(std::error_code& ec)
     {
         const CharT* local_end_input = end_input_;
+        continue_ = true;
 
-        while ((p_ < local_end_input) && (state_ != parse_state::done))
+        while ((p_ < local_end_input) && (state_ != parse_state::done) && continue_)
         {
             switch (state_)
             {
@@ -1991,9 +1998,10 @@ exp3:
         }
 
 string_u1:
+        p_ = detail::scan_string_chars(p_, local_end_input);
         if (JSONCONS_UNLIKELY(p_ >= local_end_input)) // Buffer exhausted               
         {
-            auto result = unicons::validate(sb,p_);
+            auto result = validate_string(sb,p_);
             if (result.ec != unicons::conv_errc())
             {
                 translate_conv_errc(result.ec,ec);
@@ -2017,7 +2025,7 @@ string_u1:
                     return;
                 }
                 // recovery - skip
-                auto result = unicons::validate(sb,p_);
+                auto result = validate_string(sb,p_);
                 if (result.ec != unicons::conv_errc())
                 {
                     translate_conv_errc(result.ec,ec);
@@ -2039,7 +2047,7 @@ string_u1:
                     return;
                 }
                 // recovery - keep
-                auto result = unicons::validate(sb,p_);
+                auto result = validate_string(sb,p_);
                 if (result.ec != unicons::conv_errc())
                 {
                     translate_conv_errc(result.ec,ec);
@@ -2062,7 +2070,7 @@ string_u1:
                     return;
                 }
                 // recovery - keep
-                auto result = unicons::validate(sb,p_);
+                auto result = validate_string(sb,p_);
                 if (result.ec != unicons::conv_errc())
                 {
                     translate_conv_errc(result.ec,ec);
@@ -2085,7 +2093,7 @@ string_u1:
                     return;
                 }
                 // recovery - keep
-                auto result = unicons::validate(sb,p_);
+                auto result = validate_string(sb,p_);
                 if (result.ec != unicons::conv_errc())
                 {
                     translate_conv_errc(result.ec,ec);
@@ -2099,7 +2107,7 @@ string_u1:
             }
             case '\\': 
             {
-                auto result = unicons::validate(sb,p_);
+                auto result = validate_string(sb,p_);
                 if (result.ec != unicons::conv_errc())
                 {
                     translate_conv_errc(result.ec,ec);
@@ -2113,7 +2121,7 @@ string_u1:
             }
             case '\"':
             {
-                auto result = unicons::validate(sb,p_);
+                auto result = validate_string(sb,p_);
                 if (result.ec != unicons::conv_errc())
                 {
                     translate_conv_errc(result.ec,ec);
@@ -2122,13 +2130,22 @@ string_u1:
                 }
                 if (string_buffer_.length() == 0)
                 {
+                    if (insitu_input_ != nullptr)
+                    {
+                        sb = end_insitu_string(sb,p_-sb);
+                    }
                     end_string_value(sb,p_-sb, ec);
                     if (ec) {return;}
                 }
                 else
                 {
                     string_buffer_.append(sb,p_-sb);
-                    end_string_value(string_buffer_.data(),string_buffer_.length(), ec);
+                    const CharT* s = string_buffer_.data();
+                    if (insitu_input_ != nullptr)
+                    {
+                        s = end_insitu_string(s,string_buffer_.length());
+                    }
+                    end_string_value(s,string_buffer_.length(), ec);
                     string_buffer_.clear();
                     if (ec) {return;}
                 }
@@ -2404,6 +2421,12 @@ escape_u9:
         JSONCONS_UNREACHABLE();               
     }
 
+    unicons::convert_result<const CharT*> validate_string(const CharT* first, const CharT* last)
+    {
+        // Only the part from the first non-ascii character needs validating
+        return unicons::validate(detail::scan_ascii(first, last), last);
+    }
+
     void translate_conv_errc(unicons::conv_errc result, std::error_code& ec)
     {
         switch (result)
@@ -2512,13 +2535,24 @@ escape_u9:
         begin_input_ = input;
         end_input_ = input + length;
         p_ = begin_input_;
+        insitu_input_ = nullptr;
+    }
+
+    // The whole text, which the parser may modify. Decoded strings are
+    // written back over the text, each followed by a null character in 
+    // place of its closing quote, and the names and string values reported
+    // to the handler are views of the text that remain valid after parsing.
+    void set_source(CharT* input, size_t length, insitu_arg_t)
+    {
+        set_source(input, length);
+        insitu_input_ = input;
     }
 private:
     void end_fraction_value(std::error_code& ec)
     {
         try
         {
-            double d = str_to_double_(string_buffer_.data(), precision_);
+            double d = str_to_double_(string_buffer_.data(), string_buffer_.length());
             if (is_negative_)
                 d = -d;
             handler_.double_value(d, static_cast<uint8_t>(precision_), *this);
@@ -2671,6 +2705,21 @@ private:
         }
     }
 
+    // Moves a decoded string to end just before its closing quote, which is
+    // at p_, and replaces the quote with a null. A decoded string is never 
+    // longer than its escaped text.
+    const CharT* end_insitu_string(const CharT* s, size_t length)
+    {
+        CharT* last = insitu_input_ + (p_ - begin_input_);
+        CharT* first = last - length;
+        if (s != first)
+        {
+            std::memmove(first, s, length*sizeof(CharT));
+        }
+        *last = 0;
+        return first;
+    }
+
     void end_string_value(const CharT* s, size_t length, std::error_code& ec) 
     {
         switch (parent())
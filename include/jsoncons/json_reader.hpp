@@ -142,7 +142,7 @@ class basic_json_reader
     static const size_t default_max_buffer_length = 16384;
 
     basic_json_parser<CharT> parser_;
-    std::basic_istream<CharT>& is_;
+    std::basic_istream<CharT>* is_;
     bool eof_;
     std::vector<CharT> buffer_;
     size_t buffer_length_;
@@ -153,10 +153,12 @@ class basic_json_reader
     basic_json_reader& operator=(const basic_json_reader&) = delete;
 
 public:
+    typedef CharT char_type;
+    typedef typename basic_json_input_handler<CharT>::string_view_type string_view_type;
 
     basic_json_reader(std::basic_istream<CharT>& is)
         : parser_(),
-          is_(is),
+          is_(std::addressof(is)),
           eof_(false),
           buffer_length_(default_max_buffer_length),
           begin_(true)
@@ -167,7 +169,7 @@ public:
     basic_json_reader(std::basic_istream<CharT>& is,
                       parse_error_handler& err_handler)
        : parser_(err_handler),
-         is_(is),
+         is_(std::addressof(is)),
          eof_(false),
          buffer_length_(default_max_buffer_length),
          begin_(true)
@@ -178,7 +180,7 @@ public:
     basic_json_reader(std::basic_istream<CharT>& is, 
                       basic_json_input_handler<CharT>& handler)
         : parser_(handler),
-          is_(is),
+          is_(std::addressof(is)),
           eof_(false),
           buffer_length_(default_max_buffer_length),
           begin_(true)
@@ -190,7 +192,7 @@ public:
                       basic_json_input_handler<CharT>& handler,
                       parse_error_handler& err_handler)
        : parser_(handler,err_handler),
-         is_(is),
+         is_(std::addressof(is)),
          eof_(false),
          buffer_length_(default_max_buffer_length),
          begin_(true)
@@ -198,6 +200,32 @@ public:
         buffer_.reserve(buffer_length_);
     }
 
+    // Reads from text held in memory, for example a mapped_file. The whole
+    // text is given to the parser at once and is not copied, so it must
+    // outlive the reader.
+    basic_json_reader(string_view_type s, 
+                      basic_json_input_handler<CharT>& handler)
+        : parser_(handler),
+          is_(nullptr),
+          eof_(false),
+          buffer_length_(default_max_buffer_length),
+          begin_(true)
+    {
+        set_text(s);
+    }
+
+    basic_json_reader(string_view_type s,
+                      basic_json_input_handler<CharT>& handler,
+                      parse_error_handler& err_handler)
+       : parser_(handler,err_handler),
+         is_(nullptr),
+         eof_(false),
+         buffer_length_(default_max_buffer_length),
+         begin_(true)
+    {
+        set_text(s);
+    }
+
     size_t buffer_length() const
     {
         return buffer_length_;
@@ -233,8 +261,8 @@ public:
     {
         buffer_.clear();
         buffer_.resize(buffer_length_);
-        is_.read(buffer_.data(), buffer_length_);
-        buffer_.resize(static_cast<size_t>(is_.gcount()));
+        is_->read(buffer_.data(), buffer_length_);
+        buffer_.resize(static_cast<size_t>(is_->gcount()));
         if (buffer_.size() == 0)
         {
             eof_ = true;
@@ -264,9 +292,9 @@ public:
         {
             if (parser_.source_exhausted())
             {
-                if (!is_.eof())
+                if (is_ != nullptr && !is_->eof())
                 {
-                    if (is_.fail())
+                    if (is_->fail())
                     {
                         ec = json_parser_errc::source_error;
                         return;
@@ -325,9 +353,9 @@ public:
             {
                 if (parser_.source_exhausted())
                 {
-                    if (!is_.eof())
+                    if (is_ != nullptr && !is_->eof())
                     {
-                        if (is_.fail())
+                        if (is_->fail())
                         {
                             ec = json_parser_errc::source_error;
                             return;
@@ -393,6 +421,18 @@ public:
 #endif
 
 private:
+
+    void set_text(string_view_type s)
+    {
+        auto result = unicons::skip_bom(s.begin(), s.end());
+        if (result.ec != unicons::encoding_errc())
+        {
+            throw parse_error(result.ec,1,1);
+        }
+        size_t offset = result.it - s.begin();
+        parser_.set_source(s.data()+offset,s.size()-offset);
+        begin_ = false;
+    }
 };
 
 typedef basic_json_reader<char> json_reader;
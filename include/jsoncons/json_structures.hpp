@@ -18,6 +18,7 @@
 #include <sstream>
 #include <iomanip>
 #include <utility>
+#include <limits>
 #include <initializer_list>
 #include <jsoncons/json_exception.hpp>
 #include <jsoncons/json_traits.hpp>
@@ -100,6 +101,11 @@ public:
     {
     }
 
+    Json_string_(const char_type* data, size_t length, insitu_arg_t, allocator_type allocator)
+        : string_(detail::insitu_string_storage<string_storage_type>(data, length, char_allocator_type(allocator)))
+    {
+    }
+
     const char_type* data() const
     {
         return string_.data();
@@ -398,6 +404,27 @@ private:
 
 // json_object
 
+// Like std::stable_sort, but sorts the short sequences that most objects
+// have by insertion, without the temporary buffer std::stable_sort allocates
+template <class RandomIt,class Compare>
+void stable_sort_members(RandomIt first, RandomIt last, Compare comp)
+{
+    const std::ptrdiff_t insertion_sort_threshold = 32;
+    if (last - first > insertion_sort_threshold)
+    {
+        std::stable_sort(first, last, comp);
+        return;
+    }
+    for (auto it = first; it != last; ++it)
+    {
+        auto pos = std::upper_bound(first, it, *it, comp);
+        if (pos != it)
+        {
+            std::rotate(pos, it, it + 1);
+        }
+    }
+}
+
 template <class BidirectionalIt,class BinaryPredicate>
 BidirectionalIt last_wins_unique_sequence(BidirectionalIt first, BidirectionalIt last, BinaryPredicate compare)
 {
@@ -832,8 +859,8 @@ public:
         {
             this->members_.emplace_back(pred(*s));
         }
-        std::stable_sort(this->members_.begin(),this->members_.end(),
-                         [](const value_type& a, const value_type& b){return a.key().compare(b.key()) < 0;});
+        stable_sort_members(this->members_.begin(),this->members_.end(),
+                            [](const value_type& a, const value_type& b){return a.key().compare(b.key()) < 0;});
         auto it = std::unique(this->members_.rbegin(), this->members_.rend(),
                               [](const value_type& a, const value_type& b){ return !(a.key().compare(b.key()));});
         this->members_.erase(this->members_.begin(),it.base());
@@ -1373,6 +1400,12 @@ private:
 };
 
 // Preserve order
+
+// Members are kept in insertion order. Objects with at least the traits'
+// object_index_threshold members also have a hash index, an open addressing
+// table of member positions, so that finding a member by name doesn't scan
+// the members. The index is brought up to date by every change, so const
+// lookups don't modify the object.
 template <class KeyT,class Json>
 class json_object<KeyT,Json,true> : public Json_object_<KeyT,Json>
 {
@@ -1388,33 +1421,47 @@ public:
     using typename Json_object_<KeyT,Json>::iterator;
     using typename Json_object_<KeyT,Json>::const_iterator;
     using Json_object_<KeyT,Json>::get_allocator;
+private:
+    static const size_t index_threshold = Json::json_traits_type::object_index_threshold;
+
+    typedef typename std::allocator_traits<allocator_type>:: template rebind_alloc<uint32_t> index_allocator_type;
+    typedef typename Json::json_traits_type::template array_storage<uint32_t,index_allocator_type> index_storage_type;
+
+    // Member position + 1 for each occupied slot, 0 for an empty slot
+    index_storage_type index_;
+public:
 
     json_object()
         : Json_object_<KeyT,Json>()
     {
     }
     json_object(const allocator_type& allocator)
-        : Json_object_<KeyT,Json>(allocator)
+        : Json_object_<KeyT,Json>(allocator),
+          index_(index_allocator_type(allocator))
     {
     }
 
     json_object(const json_object& val)
-        : Json_object_<KeyT,Json>(val)
+        : Json_object_<KeyT,Json>(val),
+          index_(val.index_)
     {
     }
 
     json_object(json_object&& val)
-        : Json_object_<KeyT,Json>(std::forward<json_object>(val))
+        : Json_object_<KeyT,Json>(std::forward<json_object>(val)),
+          index_(std::move(val.index_))
     {
     }
 
     json_object(const json_object& val, const allocator_type& allocator) 
-        : Json_object_<KeyT,Json>(val,allocator)
+        : Json_object_<KeyT,Json>(val,allocator),
+          index_(val.index_,index_allocator_type(allocator))
     {
     }
 
     json_object(json_object&& val,const allocator_type& allocator) 
-        : Json_object_<KeyT,Json>(std::forward<json_object>(val),allocator)
+        : Json_object_<KeyT,Json>(std::forward<json_object>(val),allocator),
+          index_(std::move(val.index_),index_allocator_type(allocator))
     {
     }
 
@@ -1437,7 +1484,8 @@ public:
 
     json_object(std::initializer_list<typename Json::array> init, 
                 const allocator_type& allocator)
-        : Json_object_<KeyT,Json>(allocator)
+        : Json_object_<KeyT,Json>(allocator),
+          index_(index_allocator_type(allocator))
     {
         for (const auto& element : init)
         {
@@ -1456,6 +1504,7 @@ public:
     void swap(json_object& val)
     {
         Json_object_<KeyT,Json>::swap(val);
+        index_.swap(val.index_);
     }
 
     iterator begin()
@@ -1482,7 +1531,11 @@ public:
 
     size_t capacity() const {return this->members_.capacity();}
 
-    void clear() {this->members_.clear();}
+    void clear() 
+    {
+        this->members_.clear();
+        index_.clear();
+    }
 
     void shrink_to_fit() 
     {
@@ -1515,31 +1568,32 @@ public:
 
     iterator find(string_view_type name)
     {
-        return std::find_if(this->members_.begin(),this->members_.end(), 
-                            [name](const value_type& kv){return kv.key() == name;});
+        return this->members_.begin() + find_position(name);
     }
 
     const_iterator find(string_view_type name) const
     {
-        return std::find_if(this->members_.begin(),this->members_.end(), 
-                            [name](const value_type& kv){return kv.key() == name;});
+        return this->members_.begin() + find_position(name);
     }
 
     void erase(const_iterator first, const_iterator last) 
     {
         this->members_.erase(first,last);
+        rebuild_index();
     }
 
     void erase(string_view_type name) 
     {
-        auto it = std::find_if(this->members_.begin(),this->members_.end(), 
-                              [name](const value_type& kv){return kv.key() == name;});
-        if (it != this->members_.end())
+        size_t pos = find_position(name);
+        if (pos != this->members_.size())
         {
-            this->members_.erase(it);
+            this->members_.erase(this->members_.begin() + pos);
+            rebuild_index();
         }
     }
 
+    // If a name occurs more than once, the last member with that name is kept,
+    // at its position
     template<class InputIt, class UnaryPredicate>
     void insert(InputIt first, InputIt last, UnaryPredicate pred)
     {
@@ -1547,11 +1601,16 @@ public:
         this->members_.reserve(this->members_.size() + count);
         for (auto s = first; s != last; ++s)
         {
-            this->members_.emplace_back(pred(*s));
+            value_type member(pred(*s));
+            size_t pos = find_position(member.key());
+            if (pos != this->members_.size())
+            {
+                this->members_.erase(this->members_.begin() + pos);
+                rebuild_index();
+            }
+            this->members_.emplace_back(std::move(member));
+            index_appended();
         }
-        auto it = last_wins_unique_sequence(this->members_.begin(), this->members_.end(),
-                              [](const value_type& a, const value_type& b){ return a.key().compare(b.key());});
-        this->members_.erase(it,this->members_.end());
     }
 
     // insert_or_assign
@@ -1561,13 +1620,13 @@ public:
     insert_or_assign(string_view_type name, T&& value)
     {
         bool inserted;
-        auto it = std::find_if(this->members_.begin(),this->members_.end(), 
-                               [name](const value_type& a){return a.key() == name;});
+        auto it = find(name);
 
         if (it == this->members_.end())
         {
             this->members_.emplace_back(key_storage_type(name.begin(),name.end()), 
                                         std::forward<T>(value));
+            index_appended();
             it = this->members_.begin() + this->members_.size() - 1;
             inserted = true;
         }
@@ -1584,13 +1643,13 @@ public:
     insert_or_assign(string_view_type name, T&& value)
     {
         bool inserted;
-        auto it = std::find_if(this->members_.begin(),this->members_.end(), 
-                               [name](const value_type& a){return a.key() == name;});
+        auto it = find(name);
 
         if (it == this->members_.end())
         {
             this->members_.emplace_back(key_storage_type(name.begin(),name.end(),get_allocator()), 
                                         std::forward<T>(value),get_allocator());
+            index_appended();
             it = this->members_.begin() + this->members_.size() - 1;
             inserted = true;
         }
@@ -1614,13 +1673,13 @@ public:
         }
         else
         {
-            it = std::find_if(this->members_.begin(),this->members_.end(), 
-                              [key](const value_type& a){return a.key() == key;});
+            it = find(key);
 
             if (it == this->members_.end())
             {
                 this->members_.emplace_back(key_storage_type(key.begin(),key.end()), 
                                             std::forward<T>(value));
+                index_appended();
                 it = this->members_.begin() + this->members_.size() - 1;
             }
             else
@@ -1643,13 +1702,13 @@ public:
         }
         else
         {
-            it = std::find_if(this->members_.begin(),this->members_.end(), 
-                              [key](const value_type& a){return a.key() == key;});
+            it = find(key);
 
             if (it == this->members_.end())
             {
                 this->members_.emplace_back(key_storage_type(key.begin(),key.end(),get_allocator()), 
                                             std::forward<T>(value),get_allocator());
+                index_appended();
                 it = this->members_.begin() + this->members_.size() - 1;
             }
             else
@@ -1676,11 +1735,10 @@ public:
         auto end = std::make_move_iterator(source.end());
         for (; it != end; ++it)
         {
-            auto pos = std::find_if(this->members_.begin(),this->members_.end(), 
-                                    [it](const value_type& a){return a.key() == it->key();});
-            if (pos == this->members_.end() )
+            if (find_position(it->key()) == this->members_.size())
             {
                 this->members_.emplace_back(*it);
+                index_appended();
             }
         }
     }
@@ -1699,11 +1757,9 @@ public:
         auto end = std::make_move_iterator(source.end());
         for (; it != end; ++it)
         {
-            auto pos = std::find_if(this->members_.begin(),this->members_.end(), 
-                                    [it](const value_type& a){return a.key() == it->key();});
-            if (pos == this->members_.end() )
+            if (find_position(it->key()) == this->members_.size())
             {
-                hint = this->members_.emplace(hint,*it);
+                hint = emplace_at(hint,*it);
             }
         }
     }
@@ -1724,11 +1780,11 @@ public:
         auto end = std::make_move_iterator(source.end());
         for (; it != end; ++it)
         {
-            auto pos = std::find_if(this->members_.begin(),this->members_.end(), 
-                                    [it](const value_type& a){return a.key() == it->key();});
+            auto pos = find(it->key());
             if (pos == this->members_.end() )
             {
                 this->members_.emplace_back(*it);
+                index_appended();
             }
             else
             {
@@ -1751,11 +1807,10 @@ public:
         auto end = std::make_move_iterator(source.end());
         for (; it != end; ++it)
         {
-            auto pos = std::find_if(this->members_.begin(),this->members_.end(), 
-                                    [it](const value_type& a){return a.key() == it->key();});
+            auto pos = find(it->key());
             if (pos == this->members_.end() )
             {
-                hint = this->members_.emplace(hint,*it);
+                hint = emplace_at(hint,*it);
             }
             else
             {
@@ -1771,13 +1826,13 @@ public:
     try_emplace(string_view_type key, Args&&... args)
     {
         bool inserted;
-        auto it = std::find_if(this->members_.begin(),this->members_.end(), 
-                               [key](const value_type& a){return a.key() == key;});
+        auto it = find(key);
 
         if (it == this->members_.end())
         {
             this->members_.emplace_back(key_storage_type(key.begin(),key.end()), 
                                         std::forward<Args>(args)...);
+            index_appended();
             it = this->members_.begin() + this->members_.size() - 1;
             inserted = true;
 
@@ -1794,13 +1849,13 @@ public:
     try_emplace(string_view_type key, Args&&... args)
     {
         bool inserted;
-        auto it = std::find_if(this->members_.begin(),this->members_.end(), 
-                               [key](const value_type& a){return a.key() == key;});
+        auto it = find(key);
 
         if (it == this->members_.end())
         {
             this->members_.emplace_back(key_storage_type(key.begin(),key.end(), get_allocator()), 
                                         std::forward<Args>(args)...);
+            index_appended();
             it = this->members_.begin() + this->members_.size() - 1;
             inserted = true;
 
@@ -1816,23 +1871,13 @@ public:
     typename std::enable_if<is_stateless<A>::value,iterator>::type
     try_emplace(iterator hint, string_view_type key, Args&&... args)
     {
-        auto it = std::find_if(this->members_.begin(),this->members_.end(), 
-                               [key](const value_type& a){return a.key() == key;});
+        auto it = find(key);
 
         if (it == this->members_.end())
         {
-            if (hint == this->members_.end())
-            {
-                this->members_.emplace_back(key_storage_type(key.begin(),key.end()), 
-                                            std::forward<Args>(args)...);
-                it = this->members_.begin() + (this->members_.size() - 1);
-            }
-            else
-            {
-                it = this->members_.emplace(hint, 
-                                            key_storage_type(key.begin(),key.end()), 
-                                            std::forward<Args>(args)...);
-            }
+            it = emplace_at(hint, 
+                            key_storage_type(key.begin(),key.end()), 
+                            std::forward<Args>(args)...);
         }
         return it;
     }
@@ -1841,23 +1886,13 @@ public:
     typename std::enable_if<!is_stateless<A>::value,iterator>::type
     try_emplace(iterator hint, string_view_type key, Args&&... args)
     {
-        auto it = std::find_if(this->members_.begin(),this->members_.end(), 
-                               [key](const value_type& a){return a.key() == key;});
+        auto it = find(key);
 
         if (it == this->members_.end())
         {
-            if (hint == this->members_.end())
-            {
-                this->members_.emplace_back(key_storage_type(key.begin(),key.end(), get_allocator()), 
-                                            std::forward<Args>(args)...);
-                it = this->members_.begin() + (this->members_.size() - 1);
-            }
-            else
-            {
-                it = this->members_.emplace(hint, 
-                                            key_storage_type(key.begin(),key.end(), get_allocator()), 
-                                            std::forward<Args>(args)...);
-            }
+            it = emplace_at(hint, 
+                            key_storage_type(key.begin(),key.end(), get_allocator()), 
+                            std::forward<Args>(args)...);
         }
         return it;
     }
@@ -1868,14 +1903,13 @@ public:
     typename std::enable_if<is_stateless<A>::value,void>::type 
     set_(key_storage_type&& key, T&& value)
     {
-        string_view_type s(key.data(),key.size());
-        auto it = std::find_if(this->members_.begin(),this->members_.end(), 
-                               [s](const value_type& a){return a.key().compare(s) == 0;});
+        auto it = find(string_view_type(key.data(),key.size()));
 
         if (it == this->members_.end())
         {
             this->members_.emplace_back(std::forward<key_storage_type>(key), 
                                   std::forward<T>(value));
+            index_appended();
         }
         else
         {
@@ -1887,14 +1921,13 @@ public:
     typename std::enable_if<!is_stateless<A>::value,void>::type 
     set_(key_storage_type&& key, T&& value)
     {
-        string_view_type s(key.data(),key.size());
-        auto it = std::find_if(this->members_.begin(),this->members_.end(), 
-                               [s](const value_type& a){return a.key().compare(s) == 0;});
+        auto it = find(string_view_type(key.data(),key.size()));
 
         if (it == this->members_.end())
         {
             this->members_.emplace_back(std::forward<key_storage_type>(key), 
                                   std::forward<T>(value),get_allocator());
+            index_appended();
         }
         else
         {
@@ -1912,6 +1945,7 @@ public:
         {
             this->members_.emplace_back(std::forward<key_storage_type>(key), 
                                   std::forward<T>(value));
+            index_appended();
             it = this->members_.begin() + (this->members_.size() - 1);
         }
         else if (it->key() == key)
@@ -1920,9 +1954,9 @@ public:
         }
         else
         {
-            it = this->members_.emplace(it,
-                                  std::forward<key_storage_type>(key),
-                                  std::forward<T>(value));
+            it = emplace_at(it,
+                            std::forward<key_storage_type>(key),
+                            std::forward<T>(value));
         }
         return it;
     }
@@ -1937,6 +1971,7 @@ public:
         {
             this->members_.emplace_back(std::forward<key_storage_type>(key), 
                                   std::forward<T>(value), get_allocator());
+            index_appended();
             it = this->members_.begin() + (this->members_.size() - 1);
         }
         else if (it->key() == key)
@@ -1945,9 +1980,9 @@ public:
         }
         else
         {
-            it = this->members_.emplace(it,
-                                  std::forward<key_storage_type>(key),
-                                  std::forward<T>(value), get_allocator());
+            it = emplace_at(it,
+                            std::forward<key_storage_type>(key),
+                            std::forward<T>(value), get_allocator());
         }
         return it;
     }
@@ -1960,9 +1995,8 @@ public:
         }
         for (auto it = this->members_.begin(); it != this->members_.end(); ++it)
         {
-            auto rhs_it = std::find_if(rhs.begin(),rhs.end(), 
-                                       [it](const value_type& a){return a.key() == it->key();});
-            if (rhs_it == rhs.end() || rhs_it->key() != it->key() || rhs_it->value() != it->value())
+            auto rhs_it = rhs.find(it->key());
+            if (rhs_it == rhs.end() || rhs_it->value() != it->value())
             {
                 return false;
             }
@@ -1971,6 +2005,115 @@ public:
     }
 private:
     json_object& operator=(const json_object&) = delete;
+
+    static size_t hash_key(string_view_type name)
+    {
+        // FNV-1a
+        uint64_t h = 14695981039346656037ULL;
+        for (auto c : name)
+        {
+            h ^= static_cast<uint64_t>(c);
+            h *= 1099511628211ULL;
+        }
+        return static_cast<size_t>(h ^ (h >> 32));
+    }
+
+    // The position of the member with this name, or size() if there is none
+    size_t find_position(string_view_type name) const
+    {
+        const size_t n = this->members_.size();
+        if (index_.empty())
+        {
+            for (size_t i = 0; i < n; ++i)
+            {
+                if (this->members_[i].key() == name)
+                {
+                    return i;
+                }
+            }
+            return n;
+        }
+        const size_t mask = index_.size() - 1;
+        for (size_t slot = hash_key(name) & mask; index_[slot] != 0; slot = (slot + 1) & mask)
+        {
+            size_t pos = index_[slot] - 1;
+            if (this->members_[pos].key() == name)
+            {
+                return pos;
+            }
+        }
+        return n;
+    }
+
+    template <class... Args>
+    iterator emplace_at(iterator hint, Args&&... args)
+    {
+        iterator it;
+        if (hint == this->members_.end())
+        {
+            this->members_.emplace_back(std::forward<Args>(args)...);
+            index_appended();
+            it = this->members_.begin() + (this->members_.size() - 1);
+        }
+        else
+        {
+            size_t pos = hint - this->members_.begin();
+            this->members_.emplace(hint, std::forward<Args>(args)...);
+            rebuild_index();
+            it = this->members_.begin() + pos;
+        }
+        return it;
+    }
+
+    void index_insert(size_t pos)
+    {
+        const size_t mask = index_.size() - 1;
+        size_t slot = hash_key(this->members_[pos].key()) & mask;
+        while (index_[slot] != 0)
+        {
+            slot = (slot + 1) & mask;
+        }
+        index_[slot] = static_cast<uint32_t>(pos + 1);
+    }
+
+    // Called after a member has been added at the end
+    void index_appended()
+    {
+        const size_t n = this->members_.size();
+        if (n < index_threshold)
+        {
+            return;
+        }
+        if (index_.empty() || n*2 > index_.size())
+        {
+            rebuild_index();
+        }
+        else
+        {
+            index_insert(n - 1);
+        }
+    }
+
+    // Called after members have been removed, or inserted before the end
+    void rebuild_index()
+    {
+        const size_t n = this->members_.size();
+        if (n < index_threshold || n >= (std::numeric_limits<uint32_t>::max)())
+        {
+            index_.clear();
+            return;
+        }
+        size_t capacity = 8;
+        while (capacity < n*4)
+        {
+            capacity *= 2;
+        }
+        index_.assign(capacity, 0);
+        for (size_t i = 0; i < n; ++i)
+        {
+            index_insert(i);
+        }
+    }
 };
 
 }
@@ -14,6 +14,7 @@
 
 #include <jsoncons/serialization_options.hpp>
 #include <jsoncons/parse_error_handler.hpp>
+#include <jsoncons/insitu_string.hpp>
 #include <string>
 #include <vector>
 
@@ -24,6 +25,10 @@ struct json_traits
 {
     static const bool preserve_order = false;
 
+    // Objects that preserve order and have at least this many members
+    // are indexed by a hash table
+    static const size_t object_index_threshold = 16;
+
     typedef CharT char_type;
 
     template <class T,class Allocator>
@@ -49,6 +54,30 @@ struct o_json_traits : public json_traits<CharT>
     static const bool preserve_order = true;
 };
 
+// Objects keep their members in insertion order and are always hash 
+// indexed, so building an object with many members one at a time 
+// takes linear time
+template <class CharT>
+struct hashed_json_traits : public json_traits<CharT>
+{
+    static const bool preserve_order = true;
+
+    static const size_t object_index_threshold = 1;
+};
+
+// Strings and keys read by parse_insitu are views of the parsed text
+template <class CharT>
+struct insitu_json_traits : public json_traits<CharT>
+{
+    typedef typename json_traits<CharT>::char_traits_type char_traits_type;
+
+    template <class Allocator>
+    using key_storage = basic_insitu_string<CharT,char_traits_type,Allocator>;
+
+    template <class Allocator>
+    using string_storage = basic_insitu_string<CharT,char_traits_type,Allocator>;
+};
+
 }
 
 #endif
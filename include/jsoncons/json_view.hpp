@@ -0,0 +1,939 @@
+// Copyright 2017 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_JSON_VIEW_HPP
+#define JSONCONS_JSON_VIEW_HPP
+
+#include <string>
+#include <vector>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+#include <system_error>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_parser.hpp>
+#include <jsoncons/detail/structural_index.hpp>
+
+namespace jsoncons {
+
+// A read-only view of a JSON text, parsed in two stages. Stage one finds
+// the structural characters (detail::structural_indexer), stage two
+// checks the grammar and records every value as an entry on a flat tape.
+// Strings are validated and unescaped, and numbers converted, only when
+// read.
+
+enum class json_tape_kind : uint8_t
+{
+    begin_object,
+    end_object,
+    begin_array,
+    end_array,
+    string,
+    integer,
+    uinteger,
+    floating,
+    true_value,
+    false_value,
+    null_value
+};
+
+namespace detail {
+
+struct tape_entry
+{
+    json_tape_kind kind;
+    // begin_object, begin_array: number of members or elements
+    uint32_t size;
+    // Position in the text of the bracket, the first character after the
+    // opening quote of a string, or the first character of other values
+    uint32_t offset;
+    // begin_object, begin_array: tape index past the matching end
+    // end_object, end_array: tape index of the matching begin
+    // Other values: length in characters
+    uint32_t extra;
+};
+
+template <class CharT>
+class string_value_handler : public basic_null_json_input_handler<CharT>
+{
+public:
+    typedef typename basic_json_input_handler<CharT>::string_view_type string_view_type;
+
+    std::basic_string<CharT> value;
+private:
+    void do_string_value(string_view_type s, const parsing_context&) override
+    {
+        value.assign(s.data(),s.length());
+    }
+};
+
+inline
+uint32_t next_tape_index(const tape_entry* tape, uint32_t index)
+{
+    return (tape[index].kind == json_tape_kind::begin_object || tape[index].kind == json_tape_kind::begin_array) ? tape[index].extra : index + 1;
+}
+
+}
+
+template <class CharT>
+class basic_json_view;
+
+// basic_json_document
+
+template <class CharT>
+class basic_json_document
+{
+public:
+    typedef CharT char_type;
+    typedef typename basic_json_input_handler<CharT>::string_view_type string_view_type;
+private:
+    const CharT* text_;
+    size_t length_;
+    std::vector<detail::tape_entry> tape_;
+    std::vector<uint32_t> structurals_;
+    std::vector<uint32_t> stack_;
+    size_t line_;
+    size_t column_;
+
+    enum class tape_state
+    {
+        value,
+        first_value_or_end,
+        first_name_or_end,
+        name,
+        colon,
+        comma_or_end,
+        done
+    };
+
+public:
+    basic_json_document()
+        : text_(nullptr), length_(0), line_(1), column_(1)
+    {
+    }
+
+    basic_json_document(const basic_json_document&) = default;
+    basic_json_document(basic_json_document&&) = default;
+    basic_json_document& operator=(const basic_json_document&) = default;
+    basic_json_document& operator=(basic_json_document&&) = default;
+
+    // The text is not copied and must outlive the document and its views
+    static basic_json_document parse(string_view_type s)
+    {
+        basic_json_document doc;
+        std::error_code ec;
+        doc.build(s, ec);
+        if (ec)
+        {
+            throw parse_error(ec,doc.line_,doc.column_);
+        }
+        return doc;
+    }
+
+    static basic_json_document parse(string_view_type s, std::error_code& ec)
+    {
+        basic_json_document doc;
+        doc.build(s, ec);
+        return doc;
+    }
+
+    // Parses s into this document, reusing its buffers
+    void assign(string_view_type s, std::error_code& ec)
+    {
+        build(s, ec);
+    }
+
+    basic_json_view<CharT> root() const
+    {
+        JSONCONS_ASSERT(!tape_.empty());
+        return basic_json_view<CharT>(text_, tape_.data(), 0);
+    }
+
+    size_t tape_size() const
+    {
+        return tape_.size();
+    }
+
+    size_t line_number() const
+    {
+        return line_;
+    }
+
+    size_t column_number() const
+    {
+        return column_;
+    }
+
+private:
+    static bool is_delimiter(CharT c)
+    {
+        switch (c)
+        {
+        case ' ': case '\t': case '\n': case '\r':
+        case '{': case '}': case '[': case ']': case ',': case ':': case '\"':
+            return true;
+        default:
+            return false;
+        }
+    }
+
+    static bool is_digit(CharT c)
+    {
+        return c >= '0' && c <= '9';
+    }
+
+    void fail(std::error_code& ec, json_parser_errc errc, size_t offset)
+    {
+        ec = errc;
+        line_ = 1;
+        column_ = 1;
+        for (size_t i = 0; i < offset && i < length_; ++i)
+        {
+            if (text_[i] == '\n')
+            {
+                ++line_;
+                column_ = 1;
+            }
+            else
+            {
+                ++column_;
+            }
+        }
+        tape_.clear();
+    }
+
+    void push(json_tape_kind kind, size_t offset, size_t extra)
+    {
+        detail::tape_entry entry;
+        entry.kind = kind;
+        entry.size = 0;
+        entry.offset = static_cast<uint32_t>(offset);
+        entry.extra = static_cast<uint32_t>(extra);
+        tape_.push_back(entry);
+    }
+
+    void build(string_view_type s, std::error_code& ec)
+    {
+        text_ = s.data();
+        length_ = s.length();
+        line_ = 1;
+        column_ = 1;
+        tape_.clear();
+        structurals_.clear();
+        stack_.clear();
+
+        if (length_ >= (std::numeric_limits<uint32_t>::max)())
+        {
+            ec = json_parser_errc::source_error;
+            return;
+        }
+
+        detail::structural_indexer indexer;
+        if (!indexer.index(text_, length_, structurals_))
+        {
+            fail(ec, json_parser_errc::unexpected_eof, length_);
+            return;
+        }
+        tape_.reserve(structurals_.size());
+
+        tape_state state = tape_state::value;
+        const size_t count = structurals_.size();
+        size_t k = 0;
+        while (k < count)
+        {
+            size_t pos = structurals_[k++];
+            CharT c = text_[pos];
+            switch (state)
+            {
+            case tape_state::done:
+                fail(ec, json_parser_errc::extra_character, pos);
+                return;
+            case tape_state::first_name_or_end:
+            case tape_state::name:
+                if (c == '\"')
+                {
+                    ++tape_[stack_.back()].size;
+                    size_t close = structurals_[k++];
+                    push(json_tape_kind::string, pos+1, close-pos-1);
+                    state = tape_state::colon;
+                }
+                else if (c == '}' && state == tape_state::first_name_or_end)
+                {
+                    end_container(json_tape_kind::end_object, pos);
+                    state = stack_.empty() ? tape_state::done : tape_state::comma_or_end;
+                }
+                else if (c == '}')
+                {
+                    fail(ec, json_parser_errc::extra_comma, pos);
+                    return;
+                }
+                else
+                {
+                    fail(ec, json_parser_errc::expected_name, pos);
+                    return;
+                }
+                break;
+            case tape_state::colon:
+                if (c != ':')
+                {
+                    fail(ec, json_parser_errc::expected_colon, pos);
+                    return;
+                }
+                state = tape_state::value;
+                break;
+            case tape_state::comma_or_end:
+            {
+                bool in_object = tape_[stack_.back()].kind == json_tape_kind::begin_object;
+                if (c == ',')
+                {
+                    state = in_object ? tape_state::name : tape_state::value;
+                }
+                else if (c == '}' && in_object)
+                {
+                    end_container(json_tape_kind::end_object, pos);
+                    state = stack_.empty() ? tape_state::done : tape_state::comma_or_end;
+                }
+                else if (c == ']' && !in_object)
+                {
+                    end_container(json_tape_kind::end_array, pos);
+                    state = stack_.empty() ? tape_state::done : tape_state::comma_or_end;
+                }
+                else
+                {
+                    fail(ec, in_object ? json_parser_errc::expected_comma_or_right_brace : json_parser_errc::expected_comma_or_right_bracket, pos);
+                    return;
+                }
+                break;
+            }
+            case tape_state::first_value_or_end:
+                if (c == ']')
+                {
+                    end_container(json_tape_kind::end_array, pos);
+                    state = stack_.empty() ? tape_state::done : tape_state::comma_or_end;
+                    break;
+                }
+                state = tape_state::value;
+                // fall through
+            case tape_state::value:
+            {
+                bool in_array = !stack_.empty() && tape_[stack_.back()].kind == json_tape_kind::begin_array;
+                if (in_array)
+                {
+                    ++tape_[stack_.back()].size;
+                }
+                switch (c)
+                {
+                case '{':
+                    stack_.push_back(static_cast<uint32_t>(tape_.size()));
+                    push(json_tape_kind::begin_object, pos, 0);
+                    state = tape_state::first_name_or_end;
+                    continue;
+                case '[':
+                    stack_.push_back(static_cast<uint32_t>(tape_.size()));
+                    push(json_tape_kind::begin_array, pos, 0);
+                    state = tape_state::first_value_or_end;
+                    continue;
+                case '\"':
+                {
+                    size_t close = structurals_[k++];
+                    push(json_tape_kind::string, pos+1, close-pos-1);
+                    break;
+                }
+                case ']':
+                    fail(ec, in_array ? json_parser_errc::extra_comma : json_parser_errc::expected_value, pos);
+                    return;
+                case 't':
+                case 'f':
+                case 'n':
+                    if (!literal(pos, c, ec))
+                    {
+                        return;
+                    }
+                    break;
+                default:
+                    if (c == '-' || is_digit(c))
+                    {
+                        if (!number(pos, ec))
+                        {
+                            return;
+                        }
+                    }
+                    else
+                    {
+                        fail(ec, json_parser_errc::expected_value, pos);
+                        return;
+                    }
+                    break;
+                }
+                state = stack_.empty() ? tape_state::done : tape_state::comma_or_end;
+                break;
+            }
+            }
+        }
+        if (state != tape_state::done)
+        {
+            fail(ec, json_parser_errc::unexpected_eof, length_);
+        }
+    }
+
+    void end_container(json_tape_kind kind, size_t pos)
+    {
+        uint32_t begin = stack_.back();
+        stack_.pop_back();
+        push(kind, pos, begin);
+        tape_[begin].extra = static_cast<uint32_t>(tape_.size());
+    }
+
+    bool literal(size_t pos, CharT c, std::error_code& ec)
+    {
+        static const CharT true_literal[] = {'t','r','u','e'};
+        static const CharT false_literal[] = {'f','a','l','s','e'};
+        static const CharT null_literal[] = {'n','u','l','l'};
+
+        const CharT* expected = c == 't' ? true_literal : (c == 'f' ? false_literal : null_literal);
+        size_t expected_length = c == 'f' ? 5 : 4;
+
+        size_t end = pos;
+        while (end < length_ && !is_delimiter(text_[end]))
+        {
+            ++end;
+        }
+        if (end - pos != expected_length || !std::equal(expected, expected + expected_length, text_ + pos))
+        {
+            fail(ec, json_parser_errc::invalid_value, pos);
+            return false;
+        }
+        push(c == 't' ? json_tape_kind::true_value : (c == 'f' ? json_tape_kind::false_value : json_tape_kind::null_value), pos, expected_length);
+        return true;
+    }
+
+    bool number(size_t pos, std::error_code& ec)
+    {
+        size_t end = pos;
+        while (end < length_ && !is_delimiter(text_[end]))
+        {
+            ++end;
+        }
+        const CharT* p = text_ + pos;
+        const CharT* last = text_ + end;
+        bool negative = *p == '-';
+        if (negative)
+        {
+            ++p;
+        }
+        const CharT* digits = p;
+        if (p < last && *p == '0')
+        {
+            ++p;
+            if (p < last && is_digit(*p))
+            {
+                fail(ec, json_parser_errc::leading_zero, pos);
+                return false;
+            }
+        }
+        else
+        {
+            if (!(p < last && is_digit(*p)))
+            {
+                fail(ec, json_parser_errc::invalid_number, pos);
+                return false;
+            }
+            while (p < last && is_digit(*p))
+            {
+                ++p;
+            }
+        }
+        size_t integer_length = p - digits;
+        bool is_floating = false;
+        if (p < last && *p == '.')
+        {
+            is_floating = true;
+            ++p;
+            if (!(p < last && is_digit(*p)))
+            {
+                fail(ec, json_parser_errc::invalid_number, pos);
+                return false;
+            }
+            while (p < last && is_digit(*p))
+            {
+                ++p;
+            }
+        }
+        if (p < last && (*p == 'e' || *p == 'E'))
+        {
+            is_floating = true;
+            ++p;
+            if (p < last && (*p == '+' || *p == '-'))
+            {
+                ++p;
+            }
+            if (!(p < last && is_digit(*p)))
+            {
+                fail(ec, json_parser_errc::invalid_number, pos);
+                return false;
+            }
+            while (p < last && is_digit(*p))
+            {
+                ++p;
+            }
+        }
+        if (p != last)
+        {
+            fail(ec, json_parser_errc::invalid_number, pos);
+            return false;
+        }
+
+        json_tape_kind kind;
+        if (is_floating)
+        {
+            kind = json_tape_kind::floating;
+        }
+        else if (integer_length < 19)
+        {
+            kind = negative ? json_tape_kind::integer : json_tape_kind::uinteger;
+        }
+        else if (negative)
+        {
+            int64_t n;
+            kind = try_string_to_integer(true, digits, integer_length, n) ? json_tape_kind::integer : json_tape_kind::floating;
+        }
+        else
+        {
+            uint64_t n;
+            kind = try_string_to_uinteger(digits, integer_length, n) ? json_tape_kind::uinteger : json_tape_kind::floating;
+        }
+        push(kind, pos, end - pos);
+        return true;
+    }
+};
+
+// basic_json_view
+
+template <class CharT>
+class basic_json_view
+{
+public:
+    typedef CharT char_type;
+    typedef typename basic_json_input_handler<CharT>::string_view_type string_view_type;
+
+    class member;
+    class array_iterator;
+    class object_iterator;
+private:
+    const CharT* text_;
+    const detail::tape_entry* tape_;
+    uint32_t index_;
+
+    friend class basic_json_document<CharT>;
+public:
+    basic_json_view(const CharT* text, const detail::tape_entry* tape, uint32_t index)
+        : text_(text), tape_(tape), index_(index)
+    {
+    }
+
+    json_tape_kind kind() const
+    {
+        return tape_[index_].kind;
+    }
+
+    bool is_null() const
+    {
+        return kind() == json_tape_kind::null_value;
+    }
+
+    bool is_bool() const
+    {
+        return kind() == json_tape_kind::true_value || kind() == json_tape_kind::false_value;
+    }
+
+    bool is_string() const
+    {
+        return kind() == json_tape_kind::string;
+    }
+
+    bool is_integer() const
+    {
+        return kind() == json_tape_kind::integer ||
+               (kind() == json_tape_kind::uinteger && as_uinteger() <= static_cast<uint64_t>((std::numeric_limits<int64_t>::max)()));
+    }
+
+    bool is_uinteger() const
+    {
+        return kind() == json_tape_kind::uinteger;
+    }
+
+    bool is_double() const
+    {
+        return kind() == json_tape_kind::floating;
+    }
+
+    bool is_number() const
+    {
+        return kind() == json_tape_kind::integer || kind() == json_tape_kind::uinteger || kind() == json_tape_kind::floating;
+    }
+
+    bool is_object() const
+    {
+        return kind() == json_tape_kind::begin_object;
+    }
+
+    bool is_array() const
+    {
+        return kind() == json_tape_kind::begin_array;
+    }
+
+    // Number of members or elements, 0 for other values
+    size_t size() const
+    {
+        return (is_object() || is_array()) ? tape_[index_].size : 0;
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    basic_json_view operator[](size_t i) const
+    {
+        return at(i);
+    }
+
+    basic_json_view at(size_t i) const
+    {
+        if (!is_array())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Index on non-array value not supported");
+        }
+        if (i >= size())
+        {
+            JSONCONS_THROW_EXCEPTION(std::out_of_range,"Invalid array subscript");
+        }
+        uint32_t index = index_ + 1;
+        for (; i > 0; --i)
+        {
+            index = detail::next_tape_index(tape_, index);
+        }
+        return basic_json_view(text_, tape_, index);
+    }
+
+    basic_json_view operator[](string_view_type name) const
+    {
+        return at(name);
+    }
+
+    basic_json_view at(string_view_type name) const
+    {
+        uint32_t index;
+        if (!find(name, index))
+        {
+            JSONCONS_THROW_EXCEPTION_1(std::out_of_range,"%s not found", name);
+        }
+        return basic_json_view(text_, tape_, index);
+    }
+
+    bool has_key(string_view_type name) const
+    {
+        uint32_t index;
+        return find(name, index);
+    }
+
+    range<array_iterator> array_range() const
+    {
+        if (!is_array())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not an array");
+        }
+        return range<array_iterator>(array_iterator(text_, tape_, index_ + 1),
+                                     array_iterator(text_, tape_, tape_[index_].extra - 1));
+    }
+
+    range<object_iterator> object_range() const
+    {
+        if (!is_object())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not an object");
+        }
+        return range<object_iterator>(object_iterator(text_, tape_, index_ + 1),
+                                      object_iterator(text_, tape_, tape_[index_].extra - 1));
+    }
+
+    std::basic_string<CharT> as_string() const
+    {
+        if (!is_string())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not a string");
+        }
+        return decode_string(index_);
+    }
+
+    bool as_bool() const
+    {
+        if (!is_bool())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not a bool");
+        }
+        return kind() == json_tape_kind::true_value;
+    }
+
+    int64_t as_integer() const
+    {
+        const detail::tape_entry& entry = tape_[index_];
+        const CharT* p = text_ + entry.offset;
+        switch (entry.kind)
+        {
+        case json_tape_kind::integer:
+        {
+            int64_t n = 0;
+            try_string_to_integer(true, p + 1, entry.extra - 1, n);
+            return n;
+        }
+        case json_tape_kind::uinteger:
+            return static_cast<int64_t>(as_uinteger());
+        case json_tape_kind::floating:
+            return static_cast<int64_t>(as_double());
+        default:
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not an integer");
+        }
+    }
+
+    uint64_t as_uinteger() const
+    {
+        const detail::tape_entry& entry = tape_[index_];
+        const CharT* p = text_ + entry.offset;
+        switch (entry.kind)
+        {
+        case json_tape_kind::integer:
+            return static_cast<uint64_t>(as_integer());
+        case json_tape_kind::uinteger:
+        {
+            uint64_t n = 0;
+            try_string_to_uinteger(p, entry.extra, n);
+            return n;
+        }
+        case json_tape_kind::floating:
+            return static_cast<uint64_t>(as_double());
+        default:
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not an unsigned integer");
+        }
+    }
+
+    double as_double() const
+    {
+        if (!is_number())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not a double");
+        }
+        const detail::tape_entry& entry = tape_[index_];
+        double d = 0;
+        jsoncons::detail::decimal_to_double(text_ + entry.offset, entry.extra, d);
+        return d;
+    }
+
+    // The text of this value, as it appears in the document
+    string_view_type text() const
+    {
+        const detail::tape_entry& entry = tape_[index_];
+        switch (entry.kind)
+        {
+        case json_tape_kind::begin_object:
+        case json_tape_kind::begin_array:
+            return string_view_type(text_ + entry.offset, tape_[entry.extra - 1].offset + 1 - entry.offset);
+        case json_tape_kind::string:
+            return string_view_type(text_ + entry.offset - 1, entry.extra + 2);
+        default:
+            return string_view_type(text_ + entry.offset, entry.extra);
+        }
+    }
+
+    // Materializes this value and everything below it
+    template <class Json>
+    Json as_json() const
+    {
+        return Json::parse(text());
+    }
+
+    class member
+    {
+        basic_json_view name_;
+        basic_json_view value_;
+    public:
+        member(const basic_json_view& name, const basic_json_view& value)
+            : name_(name), value_(value)
+        {
+        }
+
+        std::basic_string<CharT> key() const
+        {
+            return name_.as_string();
+        }
+
+        const basic_json_view& value() const
+        {
+            return value_;
+        }
+    };
+
+    class array_iterator
+    {
+        const CharT* text_;
+        const detail::tape_entry* tape_;
+        uint32_t index_;
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef basic_json_view value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const basic_json_view* pointer;
+        typedef basic_json_view reference;
+
+        array_iterator(const CharT* text, const detail::tape_entry* tape, uint32_t index)
+            : text_(text), tape_(tape), index_(index)
+        {
+        }
+
+        basic_json_view operator*() const
+        {
+            return basic_json_view(text_, tape_, index_);
+        }
+
+        array_iterator& operator++()
+        {
+            index_ = detail::next_tape_index(tape_, index_);
+            return *this;
+        }
+
+        array_iterator operator++(int)
+        {
+            array_iterator temp(*this);
+            ++*this;
+            return temp;
+        }
+
+        friend bool operator==(const array_iterator& lhs, const array_iterator& rhs)
+        {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend bool operator!=(const array_iterator& lhs, const array_iterator& rhs)
+        {
+            return lhs.index_ != rhs.index_;
+        }
+    };
+
+    class object_iterator
+    {
+        const CharT* text_;
+        const detail::tape_entry* tape_;
+        uint32_t index_;
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef member value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const member* pointer;
+        typedef member reference;
+
+        object_iterator(const CharT* text, const detail::tape_entry* tape, uint32_t index)
+            : text_(text), tape_(tape), index_(index)
+        {
+        }
+
+        member operator*() const
+        {
+            return member(basic_json_view(text_, tape_, index_), basic_json_view(text_, tape_, index_ + 1));
+        }
+
+        object_iterator& operator++()
+        {
+            index_ = detail::next_tape_index(tape_, index_ + 1);
+            return *this;
+        }
+
+        object_iterator operator++(int)
+        {
+            object_iterator temp(*this);
+            ++*this;
+            return temp;
+        }
+
+        friend bool operator==(const object_iterator& lhs, const object_iterator& rhs)
+        {
+            return lhs.index_ == rhs.index_;
+        }
+
+        friend bool operator!=(const object_iterator& lhs, const object_iterator& rhs)
+        {
+            return lhs.index_ != rhs.index_;
+        }
+    };
+
+private:
+
+    // Index of the value of member name
+    bool find(string_view_type name, uint32_t& result) const
+    {
+        if (!is_object())
+        {
+            return false;
+        }
+        uint32_t end = tape_[index_].extra - 1;
+        for (uint32_t index = index_ + 1; index < end; index = detail::next_tape_index(tape_, index + 1))
+        {
+            const detail::tape_entry& entry = tape_[index];
+            const CharT* first = text_ + entry.offset;
+            const CharT* last = first + entry.extra;
+            bool matches;
+            if (jsoncons::detail::scan_string_chars(first, last) == last)
+            {
+                matches = entry.extra == name.length() && std::equal(first, last, name.data());
+            }
+            else
+            {
+                std::basic_string<CharT> key = decode_string(index);
+                matches = key.length() == name.length() && std::equal(key.begin(), key.end(), name.data());
+            }
+            if (matches)
+            {
+                result = index + 1;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::basic_string<CharT> decode_string(uint32_t index) const
+    {
+        const detail::tape_entry& entry = tape_[index];
+        const CharT* first = text_ + entry.offset;
+        const CharT* last = first + entry.extra;
+
+        // No escapes or control characters, only the encoding to check
+        if (jsoncons::detail::scan_string_chars(first, last) == last)
+        {
+            auto result = unicons::validate(jsoncons::detail::scan_ascii(first, last), last);
+            if (result.ec == unicons::conv_errc())
+            {
+                return std::basic_string<CharT>(first, last);
+            }
+        }
+
+        // Let the parser decode (or report) the rest
+        detail::string_value_handler<CharT> handler;
+        basic_json_parser<CharT> parser(handler);
+        parser.set_source(first - 1, entry.extra + 2);
+        parser.parse();
+        parser.end_parse();
+        return handler.value;
+    }
+};
+
+typedef basic_json_document<char> json_document;
+typedef basic_json_document<wchar_t> wjson_document;
+
+typedef basic_json_view<char> json_view;
+typedef basic_json_view<wchar_t> wjson_view;
+
+}
+
+#endif
@@ -0,0 +1,207 @@
+// Copyright 2017 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_MAPPED_FILE_HPP
+#define JSONCONS_MAPPED_FILE_HPP
+
+#include <string>
+#include <vector>
+#include <fstream>
+#include <system_error>
+#include <cerrno>
+#include <jsoncons/detail/jsoncons_config.hpp>
+#include <jsoncons/json_exception.hpp>
+
+#if defined(JSONCONS_HAS_MMAP)
+#include <sys/types.h>
+#include <sys/stat.h>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace jsoncons {
+
+// The contents of a file as one contiguous, read-only region of characters.
+// With JSONCONS_HAS_MMAP the file is mapped into memory and paged in by the
+// kernel as it is read, otherwise it is read into a buffer.
+
+class mapped_file
+{
+    const char* data_;
+    size_t size_;
+#if defined(JSONCONS_HAS_MMAP)
+    void* mapping_;
+#endif
+    std::vector<char> buffer_;
+
+    // Noncopyable
+    mapped_file(const mapped_file&) = delete;
+    mapped_file& operator=(const mapped_file&) = delete;
+public:
+    mapped_file()
+        : data_(nullptr), size_(0)
+#if defined(JSONCONS_HAS_MMAP)
+          , mapping_(nullptr)
+#endif
+    {
+    }
+
+    explicit mapped_file(const std::string& filename)
+        : data_(nullptr), size_(0)
+#if defined(JSONCONS_HAS_MMAP)
+          , mapping_(nullptr)
+#endif
+    {
+        std::error_code ec;
+        open(filename, ec);
+        if (ec)
+        {
+            JSONCONS_THROW_EXCEPTION_1(std::runtime_error,"Cannot open file %s",filename);
+        }
+    }
+
+    mapped_file(const std::string& filename, std::error_code& ec)
+        : data_(nullptr), size_(0)
+#if defined(JSONCONS_HAS_MMAP)
+          , mapping_(nullptr)
+#endif
+    {
+        open(filename, ec);
+    }
+
+    mapped_file(mapped_file&& other)
+        : data_(other.data_), size_(other.size_),
+#if defined(JSONCONS_HAS_MMAP)
+          mapping_(other.mapping_),
+#endif
+          buffer_(std::move(other.buffer_))
+    {
+        other.data_ = nullptr;
+        other.size_ = 0;
+#if defined(JSONCONS_HAS_MMAP)
+        other.mapping_ = nullptr;
+#endif
+    }
+
+    ~mapped_file()
+    {
+        close();
+    }
+
+    mapped_file& operator=(mapped_file&& other)
+    {
+        if (this != &other)
+        {
+            close();
+            data_ = other.data_;
+            size_ = other.size_;
+#if defined(JSONCONS_HAS_MMAP)
+            mapping_ = other.mapping_;
+            other.mapping_ = nullptr;
+#endif
+            buffer_ = std::move(other.buffer_);
+            other.data_ = nullptr;
+            other.size_ = 0;
+        }
+        return *this;
+    }
+
+    void open(const std::string& filename, std::error_code& ec)
+    {
+        close();
+#if defined(JSONCONS_HAS_MMAP)
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd == -1)
+        {
+            ec = std::error_code(errno, std::system_category());
+            return;
+        }
+        struct stat st;
+        if (::fstat(fd, &st) == -1)
+        {
+            ec = std::error_code(errno, std::system_category());
+            ::close(fd);
+            return;
+        }
+        if (S_ISREG(st.st_mode))
+        {
+            if (st.st_size > 0)
+            {
+                void* p = ::mmap(nullptr, static_cast<size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+                if (p == MAP_FAILED)
+                {
+                    ec = std::error_code(errno, std::system_category());
+                    ::close(fd);
+                    return;
+                }
+#if defined(MADV_SEQUENTIAL)
+                ::madvise(p, static_cast<size_t>(st.st_size), MADV_SEQUENTIAL);
+#endif
+                mapping_ = p;
+                data_ = static_cast<const char*>(p);
+                size_ = static_cast<size_t>(st.st_size);
+            }
+            ::close(fd);
+            return;
+        }
+        // Pipes and devices can't be mapped
+        ::close(fd);
+#endif
+        std::ifstream is(filename, std::ios::in | std::ios::binary);
+        if (!is)
+        {
+            ec = std::make_error_code(std::errc::no_such_file_or_directory);
+            return;
+        }
+        char chunk[16384];
+        while (is.read(chunk, sizeof(chunk)) || is.gcount() > 0)
+        {
+            buffer_.insert(buffer_.end(), chunk, chunk + is.gcount());
+        }
+        if (is.bad())
+        {
+            buffer_.clear();
+            ec = std::make_error_code(std::errc::io_error);
+            return;
+        }
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+    }
+
+    void close()
+    {
+#if defined(JSONCONS_HAS_MMAP)
+        if (mapping_ != nullptr)
+        {
+            ::munmap(mapping_, size_);
+            mapping_ = nullptr;
+        }
+#endif
+        buffer_.clear();
+        data_ = nullptr;
+        size_ = 0;
+    }
+
+    const char* data() const
+    {
+        return data_;
+    }
+
+    size_t size() const
+    {
+        return size_;
+    }
+
+    bool empty() const
+    {
+        return size_ == 0;
+    }
+};
+
+}
+
+#endif
@@ -0,0 +1,251 @@
+// Copyright 2017 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_MONOTONIC_ARENA_HPP
+#define JSONCONS_MONOTONIC_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <new>
+#include <memory>
+#include <type_traits>
+#include <jsoncons/detail/jsoncons_config.hpp>
+
+namespace jsoncons {
+
+// A bump pointer arena. Memory is handed out from blocks that grow
+// geometrically and is only given back, all at once, by release() or
+// the destructor. Not thread safe, use one arena per thread or request.
+
+class monotonic_arena
+{
+    struct block
+    {
+        block* next;
+        size_t size;
+    };
+
+    static const size_t default_block_size = 4096;
+
+    block* blocks_;
+    char* initial_buffer_;
+    size_t initial_size_;
+    char* ptr_;
+    char* end_;
+    size_t next_block_size_;
+    size_t bytes_allocated_;
+
+    // Noncopyable and nonmoveable
+    monotonic_arena(const monotonic_arena&) = delete;
+    monotonic_arena& operator=(const monotonic_arena&) = delete;
+public:
+    explicit monotonic_arena(size_t initial_block_size = default_block_size)
+        : blocks_(nullptr),
+          initial_buffer_(nullptr),
+          initial_size_(0),
+          ptr_(nullptr),
+          end_(nullptr),
+          next_block_size_(initial_block_size > 0 ? initial_block_size : default_block_size),
+          bytes_allocated_(0)
+    {
+    }
+
+    // Allocates from buffer first, which must outlive the arena
+    monotonic_arena(void* buffer, size_t size)
+        : blocks_(nullptr),
+          initial_buffer_(static_cast<char*>(buffer)),
+          initial_size_(size),
+          ptr_(static_cast<char*>(buffer)),
+          end_(static_cast<char*>(buffer) + size),
+          next_block_size_(size > 0 ? size*2 : default_block_size),
+          bytes_allocated_(0)
+    {
+    }
+
+    ~monotonic_arena()
+    {
+        free_blocks();
+    }
+
+    void* allocate(size_t bytes, size_t alignment)
+    {
+        char* p = aligned_fit(bytes, alignment);
+        if (p == nullptr)
+        {
+            if (bytes > (std::numeric_limits<size_t>::max)() - alignment)
+            {
+                throw std::bad_alloc();
+            }
+            add_block(bytes + alignment);
+            p = aligned_fit(bytes, alignment);
+            if (p == nullptr)
+            {
+                throw std::bad_alloc();
+            }
+        }
+        ptr_ = p + bytes;
+        bytes_allocated_ += bytes;
+        return p;
+    }
+
+    // Gives back all memory obtained by the arena and starts again, from the
+    // initial buffer if there is one
+    void release()
+    {
+        free_blocks();
+        ptr_ = initial_buffer_;
+        end_ = initial_buffer_ + initial_size_;
+        bytes_allocated_ = 0;
+    }
+
+    // The number of bytes handed out since construction or the last release
+    size_t bytes_allocated() const
+    {
+        return bytes_allocated_;
+    }
+
+private:
+    // The first address in the current block that is aligned and has room
+    // for bytes, or null. Compared as integers, so that aligning ptr_ never
+    // forms a pointer past end_.
+    char* aligned_fit(size_t bytes, size_t alignment) const
+    {
+        if (ptr_ == nullptr)
+        {
+            return nullptr;
+        }
+        const uintptr_t first = reinterpret_cast<uintptr_t>(ptr_);
+        const uintptr_t available = reinterpret_cast<uintptr_t>(end_) - first;
+        const uintptr_t padding = (alignment - (first % alignment)) % alignment;
+        if (padding > available || bytes > available - padding)
+        {
+            return nullptr;
+        }
+        return ptr_ + padding;
+    }
+
+    void add_block(size_t min_size)
+    {
+        size_t size = next_block_size_ > min_size ? next_block_size_ : min_size;
+        size_t header = sizeof(block) + JSONCONS_ALIGNOF(std::max_align_t);
+        block* b = static_cast<block*>(::operator new(header + size));
+        b->next = blocks_;
+        b->size = size;
+        blocks_ = b;
+        ptr_ = reinterpret_cast<char*>(b) + header;
+        end_ = ptr_ + size;
+        next_block_size_ = size*2;
+    }
+
+    void free_blocks()
+    {
+        while (blocks_ != nullptr)
+        {
+            block* next = blocks_->next;
+            ::operator delete(blocks_);
+            blocks_ = next;
+        }
+    }
+};
+
+// Allocates from a monotonic_arena, deallocate does nothing. A default
+// constructed arena_allocator has no arena and uses new and delete.
+
+template <class T>
+class arena_allocator
+{
+    monotonic_arena* arena_;
+public:
+    typedef T value_type;
+    typedef T* pointer;
+    typedef const T* const_pointer;
+    typedef T& reference;
+    typedef const T& const_reference;
+    typedef size_t size_type;
+    typedef ptrdiff_t difference_type;
+
+    // Containers keep the arena of the value they are moved or swapped from
+    typedef std::true_type propagate_on_container_move_assignment;
+    typedef std::true_type propagate_on_container_swap;
+
+    template <class U>
+    struct rebind
+    {
+        typedef arena_allocator<U> other;
+    };
+
+    arena_allocator() JSONCONS_NOEXCEPT
+        : arena_(nullptr)
+    {
+    }
+
+    arena_allocator(monotonic_arena& arena) JSONCONS_NOEXCEPT
+        : arena_(std::addressof(arena))
+    {
+    }
+
+    template <class U>
+    arena_allocator(const arena_allocator<U>& other) JSONCONS_NOEXCEPT
+        : arena_(other.arena())
+    {
+    }
+
+    T* allocate(size_t n)
+    {
+        if (arena_ == nullptr)
+        {
+            return static_cast<T*>(::operator new(n*sizeof(T)));
+        }
+        return static_cast<T*>(arena_->allocate(n*sizeof(T), JSONCONS_ALIGNOF(T)));
+    }
+
+    void deallocate(T* p, size_t)
+    {
+        if (arena_ == nullptr)
+        {
+            ::operator delete(p);
+        }
+    }
+
+    monotonic_arena* arena() const
+    {
+        return arena_;
+    }
+
+    size_t max_size() const
+    {
+        return size_t(-1) / sizeof(T);
+    }
+
+    template <class U, class... Args>
+    void construct(U* p, Args&&... args)
+    {
+        ::new(static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+
+    template <class U>
+    void destroy(U* p)
+    {
+        p->~U();
+    }
+};
+
+template <class T, class U>
+bool operator==(const arena_allocator<T>& lhs, const arena_allocator<U>& rhs) JSONCONS_NOEXCEPT
+{
+    return lhs.arena() == rhs.arena();
+}
+
+template <class T, class U>
+bool operator!=(const arena_allocator<T>& lhs, const arena_allocator<U>& rhs) JSONCONS_NOEXCEPT
+{
+    return lhs.arena() != rhs.arena();
+}
+
+}
+
+#endif
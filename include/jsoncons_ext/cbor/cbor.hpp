@@ -15,8 +15,16 @@
 #include <memory>
 #include <limits>
 #include <cassert>
+#include <cmath>
+#include <cfloat>
+#include <unordered_map>
 #include <jsoncons/json.hpp>
 #include <jsoncons_ext/detail/binary_utilities.hpp>
+#include <jsoncons_ext/cbor/cbor_options.hpp>
+#include <jsoncons_ext/cbor/cbor_typed_array.hpp>
+#include <jsoncons_ext/cbor/cbor_serializer.hpp>
+#include <jsoncons_ext/cbor/cbor_reader.hpp>
+#include <jsoncons_ext/cbor/cbor_view.hpp>
 
 namespace jsoncons { namespace cbor {
 
@@ -27,6 +35,11 @@ struct Encode_cbor_
     {
         detail::binary::to_big_endian(val,v);
     }
+
+    void operator()(const uint8_t* data, size_t length, std::vector<uint8_t>& v)
+    {
+        v.insert(v.end(), data, data + length);
+    }
 };
 
 struct Calculate_size_
@@ -36,22 +49,76 @@ struct Calculate_size_
     {
         size += sizeof(T);
     }
+
+    void operator()(const uint8_t*, size_t length, size_t& size)
+    {
+        size += length;
+    }
 };
+
+// The shortest string that is added to a stringref table holding size
+// strings, a reference to a shorter one would be no shorter than the string
+inline
+size_t stringref_min_length(size_t size)
+{
+    return size < 24 ? 3 : size < 256 ? 4 : size < 65536 ? 5 : size < 4294967296ULL ? 7 : 11;
+}
   
 template<class Json>
 struct cbor_Encoder_
 {
     typedef typename Json::string_view_type string_view_type;
 
+    // The strings of a stringref namespace, by their UTF-8 bytes
+    struct string_table
+    {
+        std::unordered_map<std::string,size_t> text_strings;
+        size_t size;
+
+        string_table()
+            : size(0)
+        {
+        }
+    };
+
     static size_t calculate_size(const Json& j)
+    {
+        return calculate_size(j, cbor_options());
+    }
+
+    static size_t calculate_size(const Json& j, const cbor_options& options)
     {
         size_t n = 0;
-        cbor_Encoder_<Json>::encode(j,Calculate_size_(),n);
+        cbor_Encoder_<Json>::encode(j,options,Calculate_size_(),n);
         return n;
     }
 
     template <class Action, class Result>
     static void encode(const Json& jval, Action action, Result& v)
+    {
+        encode(jval, cbor_options(), action, v);
+    }
+
+    template <class Action, class Result>
+    static void encode(const Json& jval, const cbor_options& options, Action action, Result& v)
+    {
+        if (options.pack_strings())
+        {
+            // Tag 256 (two-byte uint16_t follows), a stringref namespace
+            action(static_cast<uint8_t>(0xd9), v);
+            action(static_cast<uint16_t>(256), v);
+            string_table strings;
+            encode_value(jval, options, &strings, action, v);
+        }
+        else
+        {
+            encode_value(jval, options, nullptr, action, v);
+        }
+    }
+
+    template <class Action, class Result>
+    static void encode_value(const Json& jval, const cbor_options& options, string_table* strings, 
+                             Action action, Result& v)
     {
         switch (jval.type_id())
         {
@@ -168,12 +235,16 @@ struct cbor_Encoder_
             case value_type::small_string_t:
             case value_type::string_t:
             {
-                encode_string(jval.as_string_view(), action, v);
+                encode_string(jval.as_string_view(), strings, action, v);
                 break;
             }
 
             case value_type::array_t:
             {
+                if (options.enable_typed_arrays() && encode_typed_array(jval, strings, action, v))
+                {
+                    break;
+                }
                 const auto length = jval.array_value().size();
                 if (length <= 0x17)
                 {
@@ -203,7 +274,7 @@ struct cbor_Encoder_
                 // append each element
                 for (const auto& el : jval.array_range())
                 {
-                    encode(el,action,v);
+                    encode_value(el,options,strings,action,v);
                 }
                 break;
             }
@@ -239,8 +310,8 @@ struct cbor_Encoder_
                 // append each element
                 for (const auto& kv: jval.object_range())
                 {
-                    encode_string(kv.key(), action, v);
-                    encode(kv.value(), action, v);
+                    encode_string(kv.key(), strings, action, v);
+                    encode_value(kv.value(), options, strings, action, v);
                 }
                 break;
             }
@@ -252,10 +323,203 @@ struct cbor_Encoder_
         }
     }
 
+    struct double_of
+    {
+        double operator()(const Json& j) const
+        {
+            return j.as_double();
+        }
+    };
+
+    struct integer_of
+    {
+        int64_t operator()(const Json& j) const
+        {
+            return j.as_integer();
+        }
+    };
+
+    struct uinteger_of
+    {
+        uint64_t operator()(const Json& j) const
+        {
+            return j.as_uinteger();
+        }
+    };
+
+    // Writes an array whose elements are all integers, or all doubles, as a
+    // typed array of the smallest little endian element type that holds
+    // every element exactly. Returns false for other arrays.
+    template <class Action, class Result>
+    static bool encode_typed_array(const Json& jval, string_table* strings, Action action, Result& v)
+    {
+        if (jval.size() == 0)
+        {
+            return false;
+        }
+        bool all_doubles = true;
+        bool all_integers = true;
+        bool floats_exact = true;
+        int64_t min_value = 0;
+        uint64_t max_value = 0;
+        for (const auto& el : jval.array_range())
+        {
+            switch (el.type_id())
+            {
+                case value_type::double_t:
+                {
+                    all_integers = false;
+                    const double d = el.as_double();
+                    if (floats_exact && !std::isnan(d) && !std::isinf(d) &&
+                        (std::fabs(d) > FLT_MAX || static_cast<double>(static_cast<float>(d)) != d))
+                    {
+                        floats_exact = false;
+                    }
+                    break;
+                }
+                case value_type::integer_t:
+                {
+                    all_doubles = false;
+                    const int64_t n = el.as_integer();
+                    if (n < 0)
+                    {
+                        min_value = (std::min)(min_value, n);
+                    }
+                    else
+                    {
+                        max_value = (std::max)(max_value, static_cast<uint64_t>(n));
+                    }
+                    break;
+                }
+                case value_type::uinteger_t:
+                    all_doubles = false;
+                    max_value = (std::max)(max_value, el.as_uinteger());
+                    break;
+                default:
+                    return false;
+            }
+            if (!all_doubles && !all_integers)
+            {
+                return false;
+            }
+        }
+
+        typedef typed_array_format::element_kind element_kind;
+        if (all_doubles)
+        {
+            if (floats_exact)
+            {
+                encode_elements<float>(jval, strings, element_kind::floating, double_of(), action, v);
+            }
+            else
+            {
+                encode_elements<double>(jval, strings, element_kind::floating, double_of(), action, v);
+            }
+        }
+        else if (min_value >= 0)
+        {
+            if (max_value <= (std::numeric_limits<uint8_t>::max)())
+            {
+                encode_elements<uint8_t>(jval, strings, element_kind::uinteger, uinteger_of(), action, v);
+            }
+            else if (max_value <= (std::numeric_limits<uint16_t>::max)())
+            {
+                encode_elements<uint16_t>(jval, strings, element_kind::uinteger, uinteger_of(), action, v);
+            }
+            else if (max_value <= (std::numeric_limits<uint32_t>::max)())
+            {
+                encode_elements<uint32_t>(jval, strings, element_kind::uinteger, uinteger_of(), action, v);
+            }
+            else
+            {
+                encode_elements<uint64_t>(jval, strings, element_kind::uinteger, uinteger_of(), action, v);
+            }
+        }
+        else
+        {
+            if (max_value > static_cast<uint64_t>((std::numeric_limits<int64_t>::max)()))
+            {
+                return false;
+            }
+            const int64_t max_signed = static_cast<int64_t>(max_value);
+            if (min_value >= (std::numeric_limits<int8_t>::min)() && max_signed <= (std::numeric_limits<int8_t>::max)())
+            {
+                encode_elements<int8_t>(jval, strings, element_kind::integer, integer_of(), action, v);
+            }
+            else if (min_value >= (std::numeric_limits<int16_t>::min)() && max_signed <= (std::numeric_limits<int16_t>::max)())
+            {
+                encode_elements<int16_t>(jval, strings, element_kind::integer, integer_of(), action, v);
+            }
+            else if (min_value >= (std::numeric_limits<int32_t>::min)() && max_signed <= (std::numeric_limits<int32_t>::max)())
+            {
+                encode_elements<int32_t>(jval, strings, element_kind::integer, integer_of(), action, v);
+            }
+            else
+            {
+                encode_elements<int64_t>(jval, strings, element_kind::integer, integer_of(), action, v);
+            }
+        }
+        return true;
+    }
+
+    template <class T, class ValueOf, class Action, class Result>
+    static void encode_elements(const Json& jval, string_table* strings, typed_array_format::element_kind kind, 
+                                ValueOf value_of, Action action, Result& v)
+    {
+        // Tag (one-byte uint8_t follows)
+        action(static_cast<uint8_t>(0xd8), v);
+        action(typed_array_format::tag_for(kind, sizeof(T)), v);
+
+        const uint64_t length = static_cast<uint64_t>(jval.size()) * sizeof(T);
+        // Byte strings take a place in the stringref table too, but aren't shared
+        if (strings != nullptr && length >= stringref_min_length(strings->size))
+        {
+            ++strings->size;
+        }
+        if (length <= 0x17)
+        {
+            action(static_cast<uint8_t>(0x40 + length), v);
+        }
+        else if (length <= 0xff)
+        {
+            action(static_cast<uint8_t>(0x58), v);
+            action(static_cast<uint8_t>(length), v);
+        }
+        else if (length <= 0xffff)
+        {
+            action(static_cast<uint8_t>(0x59), v);
+            action(static_cast<uint16_t>(length), v);
+        }
+        else if (length <= 0xffffffff)
+        {
+            action(static_cast<uint8_t>(0x5a), v);
+            action(static_cast<uint32_t>(length), v);
+        }
+        else
+        {
+            action(static_cast<uint8_t>(0x5b), v);
+            action(static_cast<uint64_t>(length), v);
+        }
+
+        uint8_t buffer[512];
+        size_t pos = 0;
+        for (const auto& el : jval.array_range())
+        {
+            typed_array_format::store_little_endian(static_cast<T>(value_of(el)), buffer + pos);
+            pos += sizeof(T);
+            if (pos == sizeof(buffer))
+            {
+                action(buffer, pos, v);
+                pos = 0;
+            }
+        }
+        action(buffer, pos, v);
+    }
+
     template <class Action,class Result>
-    static void encode_string(string_view_type sv, Action action, Result& v)
+    static void encode_string(string_view_type sv, string_table* strings, Action action, Result& v)
     {
-        std::basic_string<uint8_t> target;
+        std::string target;
         auto result = unicons::convert(
             sv.begin(), sv.end(), std::back_inserter(target), 
             unicons::conv_flags::strict);
@@ -265,6 +529,20 @@ struct cbor_Encoder_
         }
 
         const size_t length = target.length();
+        if (strings != nullptr)
+        {
+            auto it = strings->text_strings.find(target);
+            if (it != strings->text_strings.end())
+            {
+                encode_stringref(it->second, action, v);
+                return;
+            }
+            if (length >= stringref_min_length(strings->size))
+            {
+                strings->text_strings.emplace(target, strings->size++);
+            }
+        }
+
         if (length <= 0x17)
         {
             // fixstr stores a byte array whose length is upto 31 bytes
@@ -291,9 +569,38 @@ struct cbor_Encoder_
             action(static_cast<uint64_t>(length),v);
         }
 
-        for (size_t i = 0; i < length; ++i)
+        action(reinterpret_cast<const uint8_t*>(target.data()), length, v);
+    }
+
+    // Tag 25 and the index of a string in the stringref table
+    template <class Action,class Result>
+    static void encode_stringref(size_t index, Action action, Result& v)
+    {
+        action(static_cast<uint8_t>(0xd8), v);
+        action(static_cast<uint8_t>(0x19), v);
+        if (index <= 0x17)
+        {
+            action(static_cast<uint8_t>(index), v);
+        }
+        else if (index <= 0xff)
+        {
+            action(static_cast<uint8_t>(0x18), v);
+            action(static_cast<uint8_t>(index), v);
+        }
+        else if (index <= 0xffff)
+        {
+            action(static_cast<uint8_t>(0x19), v);
+            action(static_cast<uint16_t>(index), v);
+        }
+        else if (index <= 0xffffffff)
+        {
+            action(static_cast<uint8_t>(0x1a), v);
+            action(static_cast<uint32_t>(index), v);
+        }
+        else
         {
-            action(static_cast<uint8_t>(target.data()[i]), v);
+            action(static_cast<uint8_t>(0x1b), v);
+            action(static_cast<uint64_t>(index), v);
         }
     }
 };
@@ -303,11 +610,23 @@ struct cbor_Encoder_
 template<class Json>
 class Decode_cbor_
 {
+public:
+    typedef typename Json::char_type char_type;
+private:
+    // A string in a stringref namespace, text decoded once, or the bytes
+    // of a byte string
+    struct stringref_entry
+    {
+        bool is_text;
+        std::basic_string<char_type> text;
+        std::string bytes;
+    };
+
     const uint8_t* begin_;
     const uint8_t* end_;
     const uint8_t* it_;
+    std::vector<std::vector<stringref_entry>> namespaces_;
 public:
-    typedef typename Json::char_type char_type;
 
     Decode_cbor_(const uint8_t* begin, const uint8_t* end)
         : begin_(begin), end_(end), it_(begin)
@@ -471,6 +790,7 @@ public:
                     {
                         JSONCONS_THROW_EXCEPTION(std::runtime_error,"Illegal unicode");
                     }
+                    add_text_string(s.size(), target);
                     return Json(target);
                 }
             // UTF-8 string (one-byte uint8_t for n follows)
@@ -486,6 +806,7 @@ public:
                     {
                         JSONCONS_THROW_EXCEPTION(std::runtime_error,"Illegal unicode");
                     }
+                    add_text_string(s.size(), target);
                     return Json(target);
                 }
             // UTF-8 string (two-byte uint16_t for n follow)
@@ -501,6 +822,7 @@ public:
                     {
                         JSONCONS_THROW_EXCEPTION(std::runtime_error,"Illegal unicode");
                     }
+                    add_text_string(s.size(), target);
                     return Json(target);
                 }
             // UTF-8 string (four-byte uint32_t for n follow)
@@ -516,6 +838,7 @@ public:
                     {
                         JSONCONS_THROW_EXCEPTION(std::runtime_error,"Illegal unicode");
                     }
+                    add_text_string(s.size(), target);
                     return Json(target);
                 }
             // UTF-8 string (eight-byte uint64_t for n follow)
@@ -531,13 +854,14 @@ public:
                     {
                         JSONCONS_THROW_EXCEPTION(std::runtime_error,"Illegal unicode");
                     }
+                    add_text_string(s.size(), target);
                     return Json(target);
                 }
             // UTF-8 string (indefinite length)
             case 0x7f: 
             {
                 std::string s;
-                while (*it_ != 0xff)
+                while (it_ == end_ || *it_ != 0xff)
                 {
                     if (it_ == end_)
                     {
@@ -546,6 +870,7 @@ public:
                     std::string ss = get_string();
                     s.append(std::move(ss));
                 }
+                ++it_; // break
                 std::basic_string<char_type> target;
                 auto result = unicons::convert(
                     s.begin(),s.end(),std::back_inserter(target),unicons::conv_flags::strict);
@@ -621,11 +946,15 @@ public:
             case 0x9f: 
             {
                 Json result = typename Json::array();
-                while (*pos != 0xff)
+                while (it_ < end_ && *it_ != 0xff)
                 {
                     result.push_back(decode());
-                    pos = it_;
                 }
+                if (it_ == end_)
+                {
+                    JSONCONS_THROW_EXCEPTION(std::invalid_argument,"eof");
+                }
+                ++it_; // break
                 return result;
             }
 
@@ -694,12 +1023,56 @@ public:
             case 0xbf: 
             {
                 Json result = typename Json::object();
-                while (*pos != 0xff)
+                while (it_ < end_ && *it_ != 0xff)
+                {
+                    get_member(result);
+                }
+                if (it_ == end_)
+                {
+                    JSONCONS_THROW_EXCEPTION(std::invalid_argument,"eof");
+                }
+                ++it_; // break
+                return result;
+            }
+
+            // Tag (one-byte uint8_t follows)
+            case 0xd8:
+            {
+                if (it_ == end_)
+                {
+                    JSONCONS_THROW_EXCEPTION(std::invalid_argument,"eof");
+                }
+                const uint8_t tag = *it_++;
+                if (tag == 25)
+                {
+                    const stringref_entry& entry = get_stringref();
+                    if (!entry.is_text)
+                    {
+                        JSONCONS_THROW_EXCEPTION_1(std::invalid_argument,"Error decoding a cbor at position %s", std::to_string(end_-pos));
+                    }
+                    return Json(entry.text);
+                }
+                if (!typed_array_format::is_supported(tag))
+                {
+                    JSONCONS_THROW_EXCEPTION_1(std::invalid_argument,"Error decoding a cbor at position %s", std::to_string(end_-pos));
+                }
+                return get_typed_array(typed_array_format(tag));
+            }
+
+            // Tag (two-byte uint16_t follows)
+            case 0xd9:
+            {
+                const auto tag = detail::binary::from_big_endian<uint16_t>(it_,end_);
+                it_ += sizeof(uint16_t);
+                if (tag != 256)
                 {
-                    auto j = decode();
-                    result.set(j.as_string_view(),decode());
-                    pos = it_;
+                    JSONCONS_THROW_EXCEPTION_1(std::invalid_argument,"Error decoding a cbor at position %s", std::to_string(end_-pos));
                 }
+                // A stringref namespace, strings in the tagged item may refer 
+                // back to the strings before them
+                namespaces_.emplace_back();
+                Json result = decode();
+                namespaces_.pop_back();
                 return result;
             }
 
@@ -841,33 +1214,212 @@ public:
         return result;
     }
 
+    // A typed array is a definite length byte string of packed elements,
+    // or a stringref to one
+    Json get_typed_array(const typed_array_format& format)
+    {
+        if (it_ == end_)
+        {
+            JSONCONS_THROW_EXCEPTION(std::invalid_argument,"eof");
+        }
+        const uint8_t* pos = it_;
+        const uint8_t* data;
+        uint64_t length;
+        if (!namespaces_.empty() && end_ - it_ >= 2 && it_[0] == 0xd8 && it_[1] == 0x19)
+        {
+            it_ += 2;
+            const stringref_entry& entry = get_stringref();
+            if (entry.is_text)
+            {
+                JSONCONS_THROW_EXCEPTION_1(std::invalid_argument,"Error decoding a cbor at position %s", std::to_string(end_-pos));
+            }
+            data = reinterpret_cast<const uint8_t*>(entry.bytes.data());
+            length = entry.bytes.size();
+        }
+        else
+        {
+            ++it_;
+            if (*pos >= 0x40 && *pos <= 0x57)
+            {
+                // byte string (0x00..0x17 bytes follow)
+                length = *pos & 0x1f;
+            }
+            else if (*pos == 0x58)
+            {
+                length = detail::binary::from_big_endian<uint8_t>(it_,end_);
+                it_ += sizeof(uint8_t);
+            }
+            else if (*pos == 0x59)
+            {
+                length = detail::binary::from_big_endian<uint16_t>(it_,end_);
+                it_ += sizeof(uint16_t);
+            }
+            else if (*pos == 0x5a)
+            {
+                length = detail::binary::from_big_endian<uint32_t>(it_,end_);
+                it_ += sizeof(uint32_t);
+            }
+            else if (*pos == 0x5b)
+            {
+                length = detail::binary::from_big_endian<uint64_t>(it_,end_);
+                it_ += sizeof(uint64_t);
+            }
+            else
+            {
+                JSONCONS_THROW_EXCEPTION_1(std::invalid_argument,"Error decoding a cbor at position %s", std::to_string(end_-pos));
+            }
+            if (it_ > end_ || length > static_cast<uint64_t>(end_ - it_))
+            {
+                JSONCONS_THROW_EXCEPTION(std::invalid_argument,"eof");
+            }
+            data = it_;
+            it_ += static_cast<size_t>(length);
+            add_byte_string(data, static_cast<size_t>(length));
+        }
+        const size_t element_size = format.element_size();
+        if (length % element_size != 0)
+        {
+            JSONCONS_THROW_EXCEPTION_1(std::invalid_argument,"Error decoding a cbor at position %s", std::to_string(end_-pos));
+        }
+        const size_t count = static_cast<size_t>(length) / element_size;
+
+        Json result = typename Json::array();
+        result.reserve(count);
+        for (size_t i = 0; i < count; ++i, data += element_size)
+        {
+            switch (format.kind())
+            {
+                case typed_array_format::element_kind::floating:
+                    result.push_back(Json(format.as_double(data)));
+                    break;
+                case typed_array_format::element_kind::integer:
+                    result.push_back(Json(format.as_integer(data)));
+                    break;
+                default:
+                    result.push_back(Json(format.as_uinteger(data)));
+                    break;
+            }
+        }
+        return result;
+    }
+
     template<typename T>
     Json get_cbor_object(const T len)
     {
         Json result = typename Json::object();
         result.reserve(len);
         for (T i = 0; i < len; ++i)
+        {
+            get_member(result);
+        }
+        return result;
+    }
+
+    // A key given by a stringref is set from the table without a temporary
+    void get_member(Json& result)
+    {
+        if (!namespaces_.empty() && end_ - it_ >= 2 && it_[0] == 0xd8 && it_[1] == 0x19)
+        {
+            const uint8_t* pos = it_;
+            it_ += 2;
+            const stringref_entry& entry = get_stringref();
+            if (!entry.is_text)
+            {
+                JSONCONS_THROW_EXCEPTION_1(std::invalid_argument,"Error decoding a cbor at position %s", std::to_string(end_-pos));
+            }
+            // The table may grow while the value is decoded
+            const size_t index = &entry - namespaces_.back().data();
+            Json value = decode();
+            result.set(namespaces_.back()[index].text, std::move(value));
+        }
+        else
         {
             auto j = decode();
             result.set(j.as_string_view(),decode());
         }
-        return result;
+    }
+
+    void add_text_string(size_t length, const std::basic_string<char_type>& text)
+    {
+        if (!namespaces_.empty() && length >= stringref_min_length(namespaces_.back().size()))
+        {
+            namespaces_.back().push_back(stringref_entry{true, text, std::string()});
+        }
+    }
+
+    void add_byte_string(const uint8_t* data, size_t length)
+    {
+        if (!namespaces_.empty() && length >= stringref_min_length(namespaces_.back().size()))
+        {
+            namespaces_.back().push_back(stringref_entry{false, std::basic_string<char_type>(), 
+                                                         std::string(data, data + length)});
+        }
+    }
+
+    // The string referred to by the unsigned integer after tag 25
+    const stringref_entry& get_stringref()
+    {
+        if (it_ >= end_)
+        {
+            JSONCONS_THROW_EXCEPTION(std::invalid_argument,"eof");
+        }
+        const uint8_t* pos = it_++;
+        uint64_t index;
+        if (*pos <= 0x17)
+        {
+            index = *pos;
+        }
+        else if (*pos == 0x18)
+        {
+            index = detail::binary::from_big_endian<uint8_t>(it_,end_);
+            it_ += sizeof(uint8_t);
+        }
+        else if (*pos == 0x19)
+        {
+            index = detail::binary::from_big_endian<uint16_t>(it_,end_);
+            it_ += sizeof(uint16_t);
+        }
+        else if (*pos == 0x1a)
+        {
+            index = detail::binary::from_big_endian<uint32_t>(it_,end_);
+            it_ += sizeof(uint32_t);
+        }
+        else if (*pos == 0x1b)
+        {
+            index = detail::binary::from_big_endian<uint64_t>(it_,end_);
+            it_ += sizeof(uint64_t);
+        }
+        else
+        {
+            JSONCONS_THROW_EXCEPTION_1(std::invalid_argument,"Error decoding a cbor at position %s", std::to_string(end_-pos));
+        }
+        if (namespaces_.empty() || index >= namespaces_.back().size())
+        {
+            JSONCONS_THROW_EXCEPTION_1(std::invalid_argument,"Error decoding a cbor at position %s", std::to_string(end_-pos));
+        }
+        return namespaces_.back()[static_cast<size_t>(index)];
     }
 };
 
 template<class Json>
-std::vector<uint8_t> encode_cbor(const Json& j)
+std::vector<uint8_t> encode_cbor(const Json& j, const cbor_options& options)
 {
     size_t n = 0;
-    cbor_Encoder_<Json>::encode(j,Calculate_size_(),n);
+    cbor_Encoder_<Json>::encode(j,options,Calculate_size_(),n);
 
     std::vector<uint8_t> v;
     v.reserve(n);
 
-    cbor_Encoder_<Json>::encode(j,Encode_cbor_(),v);
+    cbor_Encoder_<Json>::encode(j,options,Encode_cbor_(),v);
     return v;
 }
 
+template<class Json>
+std::vector<uint8_t> encode_cbor(const Json& j)
+{
+    return encode_cbor(j, cbor_options());
+}
+
 template<class Json>
 Json decode_cbor(const std::vector<uint8_t>& v)
 {
@@ -875,6 +1427,16 @@ Json decode_cbor(const std::vector<uint8_t>& v)
     return decoder.decode();
 }
 
+// Reads one data item from a stream without holding the encoded bytes
+template<class Json>
+Json decode_cbor(std::istream& is)
+{
+    json_decoder<Json> decoder;
+    basic_cbor_reader<typename Json::char_type> reader(is, decoder);
+    reader.read();
+    return decoder.get_result();
+}
+
 }}
 
 #endif
@@ -0,0 +1,92 @@
+/// Copyright 2017 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_CBOR_CBOR_ERROR_CATEGORY_HPP
+#define JSONCONS_CBOR_CBOR_ERROR_CATEGORY_HPP
+
+#include <system_error>
+#include <jsoncons/json_exception.hpp>
+
+namespace jsoncons { namespace cbor {
+
+enum class cbor_parser_errc : int
+{
+    unexpected_eof = 1,
+    source_error,
+    unsupported_item,
+    unexpected_break,
+    illegal_chunked_string,
+    expected_text_key,
+    invalid_utf8_text_string,
+    length_too_large,
+    max_depth_exceeded,
+    extra_byte,
+    invalid_typed_array
+};
+
+class cbor_error_category_impl
+   : public std::error_category
+{
+public:
+    virtual const char* name() const JSONCONS_NOEXCEPT
+    {
+        return "cbor";
+    }
+    virtual std::string message(int ev) const
+    {
+        switch (static_cast<cbor_parser_errc>(ev))
+        {
+        case cbor_parser_errc::unexpected_eof:
+            return "Unexpected end of file";
+        case cbor_parser_errc::source_error:
+            return "Source error";
+        case cbor_parser_errc::unsupported_item:
+            return "Unsupported or malformed CBOR data item";
+        case cbor_parser_errc::unexpected_break:
+            return "Unexpected break byte";
+        case cbor_parser_errc::illegal_chunked_string:
+            return "Chunks of an indefinite length text string must be definite length text strings";
+        case cbor_parser_errc::expected_text_key:
+            return "Expected a text string map key";
+        case cbor_parser_errc::invalid_utf8_text_string:
+            return "Illegal UTF-8 in text string";
+        case cbor_parser_errc::length_too_large:
+            return "Length of data item too large";
+        case cbor_parser_errc::max_depth_exceeded:
+            return "Maximum nesting depth exceeded";
+        case cbor_parser_errc::extra_byte:
+            return "Unexpected byte after CBOR data item";
+        case cbor_parser_errc::invalid_typed_array:
+            return "A typed array tag must be followed by a definite length byte string of whole elements";
+        default:
+            return "Unknown CBOR parser error";
+        }
+    }
+};
+
+inline
+const std::error_category& cbor_error_category()
+{
+  static cbor_error_category_impl instance;
+  return instance;
+}
+
+inline 
+std::error_code make_error_code(cbor_parser_errc result)
+{
+    return std::error_code(static_cast<int>(result),cbor_error_category());
+}
+
+}}
+
+namespace std {
+    template<>
+    struct is_error_code_enum<jsoncons::cbor::cbor_parser_errc> : public true_type
+    {
+    };
+}
+
+#endif
@@ -0,0 +1,55 @@
+// Copyright 2017 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_CBOR_CBOR_OPTIONS_HPP
+#define JSONCONS_CBOR_CBOR_OPTIONS_HPP
+
+namespace jsoncons { namespace cbor {
+
+class cbor_options
+{
+    bool enable_typed_arrays_;
+    bool pack_strings_;
+public:
+//  Constructors
+
+    cbor_options()
+        : enable_typed_arrays_(false), pack_strings_(false)
+    {
+    }
+
+//  Properties
+
+    bool enable_typed_arrays() const
+    {
+        return enable_typed_arrays_;
+    }
+
+    // Write arrays whose elements are all integers, or all doubles, as 
+    // RFC 8746 typed arrays
+    cbor_options& enable_typed_arrays(bool value)
+    {
+        enable_typed_arrays_ = value;
+        return *this;
+    }
+
+    bool pack_strings() const
+    {
+        return pack_strings_;
+    }
+
+    // Write each repeated string once, and later occurrences as references 
+    // to it, using the stringref extension (tags 256 and 25)
+    cbor_options& pack_strings(bool value)
+    {
+        pack_strings_ = value;
+        return *this;
+    }
+};
+
+}}
+
+#endif
@@ -0,0 +1,635 @@
+// Copyright 2017 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_CBOR_CBOR_PARSER_HPP
+#define JSONCONS_CBOR_CBOR_PARSER_HPP
+
+#include <string>
+#include <vector>
+#include <cstdlib>
+#include <limits>
+#include <system_error>
+#include <type_traits>
+#include <jsoncons/json_exception.hpp>
+#include <jsoncons/json_input_handler.hpp>
+#include <jsoncons/parse_error_handler.hpp>
+#include <jsoncons_ext/detail/binary_utilities.hpp>
+#include <jsoncons_ext/cbor/cbor_error_category.hpp>
+#include <jsoncons_ext/cbor/cbor_typed_array.hpp>
+
+namespace jsoncons { namespace cbor {
+
+// Parses CBOR data items given in pieces and reports them to a
+// json_input_handler. A data item may be split across calls to
+// set_source at any byte; the bytes of an incomplete head or string
+// are kept until the rest arrives, so the caller may reuse its buffer
+// once the source is exhausted. Arrays and maps are tracked on an
+// explicit stack, and no json values are built. RFC 8746 typed arrays
+// are reported as arrays of numbers.
+template <class CharT>
+class basic_cbor_parser : private parsing_context
+{
+public:
+    typedef CharT char_type;
+    typedef typename basic_json_input_handler<CharT>::string_view_type string_view_type;
+private:
+    enum class frame_type {array, map, indefinite_array, indefinite_map, indefinite_string};
+
+    struct frame
+    {
+        frame_type type;
+        uint64_t length; // data items in a definite length array or map
+        uint64_t count;  // data items seen so far
+    };
+
+    basic_null_json_input_handler<CharT> default_input_handler_;
+    basic_json_input_handler<CharT>& handler_;
+
+    std::vector<frame> stack_;
+    size_t max_depth_;
+    const uint8_t* p_;
+    const uint8_t* end_input_;
+    std::vector<uint8_t> pending_;
+    std::string text_buffer_;
+    std::basic_string<CharT> string_buffer_;
+    size_t position_;
+    size_t item_position_;
+    uint8_t typed_array_tag_; // the tag before a typed array's byte string, or 0
+    bool done_;
+
+    // Noncopyable and nonmoveable
+    basic_cbor_parser(const basic_cbor_parser&) = delete;
+    basic_cbor_parser& operator=(const basic_cbor_parser&) = delete;
+
+public:
+    basic_cbor_parser()
+       : handler_(default_input_handler_),
+         max_depth_((std::numeric_limits<size_t>::max)()),
+         p_(nullptr),
+         end_input_(nullptr),
+         position_(0),
+         item_position_(0),
+         typed_array_tag_(0),
+         done_(false)
+    {
+    }
+
+    basic_cbor_parser(basic_json_input_handler<CharT>& handler)
+       : handler_(handler),
+         max_depth_((std::numeric_limits<size_t>::max)()),
+         p_(nullptr),
+         end_input_(nullptr),
+         position_(0),
+         item_position_(0),
+         typed_array_tag_(0),
+         done_(false)
+    {
+    }
+
+    size_t line_number() const
+    {
+        return 1;
+    }
+
+    // One plus the offset of the data item being parsed
+    size_t column_number() const
+    {
+        return item_position_ + 1;
+    }
+
+    size_t max_nesting_depth() const
+    {
+        return max_depth_;
+    }
+
+    void max_nesting_depth(size_t max_nesting_depth)
+    {
+        max_depth_ = max_nesting_depth;
+    }
+
+    bool source_exhausted() const
+    {
+        return p_ == end_input_;
+    }
+
+    bool done() const
+    {
+        return done_;
+    }
+
+    // Readies the parser for the next data item, keeping the rest of the source
+    void reset()
+    {
+        stack_.clear();
+        pending_.clear();
+        text_buffer_.clear();
+        typed_array_tag_ = 0;
+        done_ = false;
+    }
+
+    void set_source(const uint8_t* input, size_t length)
+    {
+        p_ = input;
+        end_input_ = input + length;
+    }
+
+    void parse()
+    {
+        std::error_code ec;
+        parse(ec);
+        if (ec)
+        {
+            throw parse_error(ec,line_number(),column_number());
+        }
+    }
+
+    // Parses until the source is exhausted or a complete data item has
+    // been reported
+    void parse(std::error_code& ec)
+    {
+        while (!done_ && p_ < end_input_)
+        {
+            if (!pending_.empty())
+            {
+                uint64_t needed = item_length(pending_.data(), pending_.data() + pending_.size());
+                while (needed > pending_.size() && p_ < end_input_)
+                {
+                    if (needed > (std::numeric_limits<size_t>::max)())
+                    {
+                        ec = cbor_parser_errc::length_too_large;
+                        return;
+                    }
+                    size_t n = (std::min)(static_cast<size_t>(needed) - pending_.size(),
+                                          static_cast<size_t>(end_input_ - p_));
+                    pending_.insert(pending_.end(), p_, p_ + n);
+                    p_ += n;
+                    needed = item_length(pending_.data(), pending_.data() + pending_.size());
+                }
+                if (needed > pending_.size())
+                {
+                    return;
+                }
+                parse_item(pending_.data(), ec);
+                position_ += pending_.size();
+                pending_.clear();
+            }
+            else
+            {
+                uint64_t needed = item_length(p_, end_input_);
+                if (needed > static_cast<uint64_t>(end_input_ - p_))
+                {
+                    pending_.assign(p_, end_input_);
+                    p_ = end_input_;
+                    return;
+                }
+                parse_item(p_, ec);
+                p_ += needed;
+                position_ += static_cast<size_t>(needed);
+            }
+            if (ec)
+            {
+                return;
+            }
+        }
+    }
+
+    void end_parse()
+    {
+        std::error_code ec;
+        end_parse(ec);
+        if (ec)
+        {
+            throw parse_error(ec,line_number(),column_number());
+        }
+    }
+
+    void end_parse(std::error_code& ec)
+    {
+        if (!done_)
+        {
+            item_position_ = position_;
+            ec = cbor_parser_errc::unexpected_eof;
+        }
+    }
+
+    void check_done()
+    {
+        std::error_code ec;
+        check_done(ec);
+        if (ec)
+        {
+            throw parse_error(ec,line_number(),column_number());
+        }
+    }
+
+    void check_done(std::error_code& ec)
+    {
+        if (p_ != end_input_)
+        {
+            item_position_ = position_;
+            ec = cbor_parser_errc::extra_byte;
+        }
+    }
+
+private:
+    static size_t head_length(uint8_t initial_byte)
+    {
+        switch (initial_byte & 0x1f)
+        {
+            case 0x18:
+                return 1 + sizeof(uint8_t);
+            case 0x19:
+                return 1 + sizeof(uint16_t);
+            case 0x1a:
+                return 1 + sizeof(uint32_t);
+            case 0x1b:
+                return 1 + sizeof(uint64_t);
+            default:
+                return 1;
+        }
+    }
+
+    // The value, length or count in the head that starts at first
+    static uint64_t get_argument(const uint8_t* first)
+    {
+        switch (*first & 0x1f)
+        {
+            case 0x18:
+                return detail::binary::from_big_endian<uint8_t>(first+1,first+2);
+            case 0x19:
+                return detail::binary::from_big_endian<uint16_t>(first+1,first+3);
+            case 0x1a:
+                return detail::binary::from_big_endian<uint32_t>(first+1,first+5);
+            case 0x1b:
+                return detail::binary::from_big_endian<uint64_t>(first+1,first+9);
+            default:
+                return *first & 0x1f;
+        }
+    }
+
+    // The number of bytes in the head of the data item that starts at
+    // first, plus the content of a definite length string. If [first,last)
+    // is too short to tell, the number of bytes needed to tell.
+    static uint64_t item_length(const uint8_t* first, const uint8_t* last)
+    {
+        const size_t head = head_length(*first);
+        const uint8_t major_type = *first >> 5;
+        if (static_cast<size_t>(last - first) < head ||
+            (major_type != 2 && major_type != 3) || (*first & 0x1f) == 0x1f)
+        {
+            return head;
+        }
+        const uint64_t length = get_argument(first);
+        return length <= (std::numeric_limits<uint64_t>::max)() - head
+            ? head + length
+            : (std::numeric_limits<uint64_t>::max)();
+    }
+
+    bool expecting_key() const
+    {
+        return !stack_.empty() &&
+               (stack_.back().type == frame_type::map || stack_.back().type == frame_type::indefinite_map) &&
+               stack_.back().count % 2 == 0;
+    }
+
+    void parse_item(const uint8_t* p, std::error_code& ec)
+    {
+        item_position_ = position_;
+        const uint8_t major_type = *p >> 5;
+        const uint8_t info = *p & 0x1f;
+        const size_t head = head_length(*p);
+
+        if (!stack_.empty() && stack_.back().type == frame_type::indefinite_string)
+        {
+            if (*p == 0xff)
+            {
+                stack_.pop_back();
+                end_text_string(text_buffer_.data(), text_buffer_.size(), ec);
+                if (ec) return;
+                end_value();
+            }
+            else if (major_type != 3 || info > 0x1b)
+            {
+                ec = cbor_parser_errc::illegal_chunked_string;
+            }
+            else
+            {
+                const char* first = reinterpret_cast<const char*>(p + head);
+                text_buffer_.append(first, first + static_cast<size_t>(get_argument(p)));
+            }
+            return;
+        }
+        if (typed_array_tag_ != 0)
+        {
+            if (major_type != 2 || info > 0x1b)
+            {
+                ec = cbor_parser_errc::invalid_typed_array;
+                return;
+            }
+            typed_array_format format(typed_array_tag_);
+            typed_array_tag_ = 0;
+            parse_typed_array(format, p + head, get_argument(p), ec);
+            return;
+        }
+        if (*p == 0xff)
+        {
+            if (stack_.empty() ||
+                (stack_.back().type != frame_type::indefinite_array && stack_.back().type != frame_type::indefinite_map) ||
+                (stack_.back().type == frame_type::indefinite_map && stack_.back().count % 2 != 0))
+            {
+                ec = cbor_parser_errc::unexpected_break;
+                return;
+            }
+            frame_type type = stack_.back().type;
+            stack_.pop_back();
+            if (type == frame_type::indefinite_array)
+            {
+                handler_.end_array(*this);
+            }
+            else
+            {
+                handler_.end_object(*this);
+            }
+            end_value();
+            return;
+        }
+        if (expecting_key() && major_type != 3)
+        {
+            ec = cbor_parser_errc::expected_text_key;
+            return;
+        }
+        if (info > 0x1b && (info != 0x1f || major_type < 2 || major_type == 6 || major_type == 7))
+        {
+            ec = cbor_parser_errc::unsupported_item;
+            return;
+        }
+        if (stack_.empty())
+        {
+            handler_.begin_json();
+        }
+
+        switch (major_type)
+        {
+            // Unsigned integer
+            case 0:
+                handler_.uinteger_value(get_argument(p), *this);
+                end_value();
+                break;
+            // Negative integer -1-n
+            case 1:
+            {
+                const uint64_t x = get_argument(p);
+                if (x <= static_cast<uint64_t>((std::numeric_limits<int64_t>::max)()))
+                {
+                    handler_.integer_value(static_cast<int64_t>(-1) - static_cast<int64_t>(x), *this);
+                }
+                else
+                {
+                    handler_.double_value(-1.0 - static_cast<double>(x), 0, *this);
+                }
+                end_value();
+                break;
+            }
+            // UTF-8 string
+            case 3:
+                if (info == 0x1f)
+                {
+                    text_buffer_.clear();
+                    stack_.push_back(frame{frame_type::indefinite_string, 0, 0});
+                }
+                else
+                {
+                    end_text_string(reinterpret_cast<const char*>(p + head), static_cast<size_t>(get_argument(p)), ec);
+                    if (ec) return;
+                    end_value();
+                }
+                break;
+            // array
+            case 4:
+                if (stack_.size() >= max_depth_)
+                {
+                    ec = cbor_parser_errc::max_depth_exceeded;
+                    return;
+                }
+                handler_.begin_array(*this);
+                if (info == 0x1f)
+                {
+                    stack_.push_back(frame{frame_type::indefinite_array, 0, 0});
+                }
+                else
+                {
+                    begin_definite(frame_type::array, get_argument(p));
+                }
+                break;
+            // map
+            case 5:
+            {
+                if (stack_.size() >= max_depth_)
+                {
+                    ec = cbor_parser_errc::max_depth_exceeded;
+                    return;
+                }
+                handler_.begin_object(*this);
+                if (info == 0x1f)
+                {
+                    stack_.push_back(frame{frame_type::indefinite_map, 0, 0});
+                }
+                else
+                {
+                    const uint64_t length = get_argument(p);
+                    if (length > (std::numeric_limits<uint64_t>::max)()/2)
+                    {
+                        ec = cbor_parser_errc::length_too_large;
+                        return;
+                    }
+                    begin_definite(frame_type::map, 2*length);
+                }
+                break;
+            }
+            // Tag, of which only typed arrays are supported
+            case 6:
+                if (!typed_array_format::is_supported(get_argument(p)))
+                {
+                    ec = cbor_parser_errc::unsupported_item;
+                    return;
+                }
+                if (stack_.size() >= max_depth_)
+                {
+                    ec = cbor_parser_errc::max_depth_exceeded;
+                    return;
+                }
+                typed_array_tag_ = static_cast<uint8_t>(get_argument(p));
+                break;
+            case 7:
+                switch (*p)
+                {
+                    // False
+                    case 0xf4:
+                        handler_.bool_value(false, *this);
+                        break;
+                    // True
+                    case 0xf5:
+                        handler_.bool_value(true, *this);
+                        break;
+                    // Null
+                    case 0xf6:
+                        handler_.null_value(*this);
+                        break;
+                    // Half-Precision Float (two-byte IEEE 754)
+                    case 0xf9:
+                        handler_.double_value(detail::binary::decode_half(static_cast<uint16_t>(get_argument(p))), 0, *this);
+                        break;
+                    // Single-Precision Float (four-byte IEEE 754)
+                    case 0xfa:
+                        handler_.double_value(detail::binary::from_big_endian<float>(p+1,p+5), 0, *this);
+                        break;
+                    // Double-Precision Float (eight-byte IEEE 754)
+                    case 0xfb:
+                        handler_.double_value(detail::binary::from_big_endian<double>(p+1,p+9), 0, *this);
+                        break;
+                    default:
+                        ec = cbor_parser_errc::unsupported_item;
+                        return;
+                }
+                end_value();
+                break;
+            // Byte strings other than typed arrays, which decode_cbor doesn't support either
+            default:
+                ec = cbor_parser_errc::unsupported_item;
+                break;
+        }
+    }
+
+    void parse_typed_array(const typed_array_format& format, const uint8_t* data, uint64_t length, std::error_code& ec)
+    {
+        const size_t element_size = format.element_size();
+        if (length % element_size != 0)
+        {
+            ec = cbor_parser_errc::invalid_typed_array;
+            return;
+        }
+        const size_t count = static_cast<size_t>(length) / element_size;
+        handler_.begin_array(*this);
+        for (size_t i = 0; i < count; ++i, data += element_size)
+        {
+            switch (format.kind())
+            {
+                case typed_array_format::element_kind::floating:
+                    handler_.double_value(format.as_double(data), 0, *this);
+                    break;
+                case typed_array_format::element_kind::integer:
+                    handler_.integer_value(format.as_integer(data), *this);
+                    break;
+                default:
+                    handler_.uinteger_value(format.as_uinteger(data), *this);
+                    break;
+            }
+        }
+        handler_.end_array(*this);
+        end_value();
+    }
+
+    void begin_definite(frame_type type, uint64_t length)
+    {
+        if (length == 0)
+        {
+            if (type == frame_type::array)
+            {
+                handler_.end_array(*this);
+            }
+            else
+            {
+                handler_.end_object(*this);
+            }
+            end_value();
+        }
+        else
+        {
+            stack_.push_back(frame{type, length, 0});
+        }
+    }
+
+    // Counts a completed data item in its array or map, and ends the
+    // definite length arrays and maps that it completes
+    void end_value()
+    {
+        while (!stack_.empty())
+        {
+            frame& f = stack_.back();
+            ++f.count;
+            if (f.count != f.length || (f.type != frame_type::array && f.type != frame_type::map))
+            {
+                return;
+            }
+            frame_type type = f.type;
+            stack_.pop_back();
+            if (type == frame_type::array)
+            {
+                handler_.end_array(*this);
+            }
+            else
+            {
+                handler_.end_object(*this);
+            }
+        }
+        handler_.end_json();
+        done_ = true;
+    }
+
+    void end_text_string(const char* s, size_t length, std::error_code& ec)
+    {
+        auto result = unicons::validate(s, s + length);
+        if (result.ec != unicons::conv_errc())
+        {
+            ec = cbor_parser_errc::invalid_utf8_text_string;
+            return;
+        }
+        end_text_string(s, length, std::is_same<CharT,char>());
+    }
+
+    void end_text_string(const char* s, size_t length, std::true_type)
+    {
+        if (expecting_key())
+        {
+            handler_.name(string_view_type(s, length), *this);
+        }
+        else
+        {
+            handler_.string_value(string_view_type(s, length), *this);
+        }
+    }
+
+    void end_text_string(const char* s, size_t length, std::false_type)
+    {
+        string_buffer_.clear();
+        unicons::convert(s, s + length, std::back_inserter(string_buffer_), unicons::conv_flags::strict);
+        if (expecting_key())
+        {
+            handler_.name(string_buffer_, *this);
+        }
+        else
+        {
+            handler_.string_value(string_buffer_, *this);
+        }
+    }
+
+    size_t do_line_number() const override
+    {
+        return line_number();
+    }
+
+    size_t do_column_number() const override
+    {
+        return column_number();
+    }
+};
+
+typedef basic_cbor_parser<char> cbor_parser;
+typedef basic_cbor_parser<wchar_t> wcbor_parser;
+
+}}
+
+#endif
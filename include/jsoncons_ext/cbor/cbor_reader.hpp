@@ -0,0 +1,189 @@
+// Copyright 2017 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_CBOR_CBOR_READER_HPP
+#define JSONCONS_CBOR_CBOR_READER_HPP
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <istream>
+#include <cstdlib>
+#include <system_error>
+#include <jsoncons/json_exception.hpp>
+#include <jsoncons/json_input_handler.hpp>
+#include <jsoncons/parse_error_handler.hpp>
+#include <jsoncons_ext/cbor/cbor_error_category.hpp>
+#include <jsoncons_ext/cbor/cbor_parser.hpp>
+
+namespace jsoncons { namespace cbor {
+
+template<class CharT>
+class basic_cbor_reader
+{
+    static const size_t default_max_buffer_length = 16384;
+
+    basic_cbor_parser<CharT> parser_;
+    std::istream* is_;
+    bool eof_;
+    std::vector<uint8_t> buffer_;
+    size_t buffer_length_;
+
+    // Noncopyable and nonmoveable
+    basic_cbor_reader(const basic_cbor_reader&) = delete;
+    basic_cbor_reader& operator=(const basic_cbor_reader&) = delete;
+
+public:
+    typedef CharT char_type;
+
+    basic_cbor_reader(std::istream& is,
+                      basic_json_input_handler<CharT>& handler)
+        : parser_(handler),
+          is_(std::addressof(is)),
+          eof_(false),
+          buffer_length_(default_max_buffer_length)
+    {
+        buffer_.reserve(buffer_length_);
+    }
+
+    size_t buffer_length() const
+    {
+        return buffer_length_;
+    }
+
+    void buffer_length(size_t length)
+    {
+        buffer_length_ = length;
+        buffer_.reserve(buffer_length_);
+    }
+
+    size_t max_nesting_depth() const
+    {
+        return parser_.max_nesting_depth();
+    }
+
+    void max_nesting_depth(size_t depth)
+    {
+        parser_.max_nesting_depth(depth);
+    }
+
+    size_t line_number() const
+    {
+        return parser_.line_number();
+    }
+
+    size_t column_number() const
+    {
+        return parser_.column_number();
+    }
+
+    bool eof() const
+    {
+        return eof_;
+    }
+
+    void read_next()
+    {
+        std::error_code ec;
+        read_next(ec);
+        if (ec)
+        {
+            throw parse_error(ec,parser_.line_number(),parser_.column_number());
+        }
+    }
+
+    // Reads the next data item, leaving any bytes that follow it to later reads
+    void read_next(std::error_code& ec)
+    {
+        parser_.reset();
+        while (!eof_ && !parser_.done())
+        {
+            if (parser_.source_exhausted())
+            {
+                read_buffer(ec);
+                if (ec) return;
+            }
+            if (!eof_)
+            {
+                parser_.parse(ec);
+                if (ec) return;
+            }
+        }
+        if (eof_)
+        {
+            parser_.end_parse(ec);
+        }
+    }
+
+    void check_done()
+    {
+        std::error_code ec;
+        check_done(ec);
+        if (ec)
+        {
+            throw parse_error(ec,parser_.line_number(),parser_.column_number());
+        }
+    }
+
+    // Fails unless the stream ends after the last data item read
+    void check_done(std::error_code& ec)
+    {
+        if (!eof_ && parser_.source_exhausted())
+        {
+            read_buffer(ec);
+            if (ec) return;
+        }
+        parser_.check_done(ec);
+    }
+
+    void read()
+    {
+        read_next();
+        check_done();
+    }
+
+    void read(std::error_code& ec)
+    {
+        read_next(ec);
+        if (!ec)
+        {
+            check_done(ec);
+        }
+    }
+
+private:
+    void read_buffer(std::error_code& ec)
+    {
+        if (is_->eof())
+        {
+            eof_ = true;
+            return;
+        }
+        if (is_->fail())
+        {
+            ec = cbor_parser_errc::source_error;
+            return;
+        }
+        buffer_.resize(buffer_length_);
+        is_->read(reinterpret_cast<char*>(buffer_.data()), buffer_length_);
+        buffer_.resize(static_cast<size_t>(is_->gcount()));
+        if (buffer_.size() == 0)
+        {
+            eof_ = true;
+        }
+        else
+        {
+            parser_.set_source(buffer_.data(),buffer_.size());
+        }
+    }
+};
+
+typedef basic_cbor_reader<char> cbor_reader;
+typedef basic_cbor_reader<wchar_t> wcbor_reader;
+
+}}
+
+#endif
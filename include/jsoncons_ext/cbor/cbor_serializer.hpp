@@ -0,0 +1,205 @@
+// Copyright 2017 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_CBOR_CBOR_SERIALIZER_HPP
+#define JSONCONS_CBOR_CBOR_SERIALIZER_HPP
+
+#include <string>
+#include <vector>
+#include <ostream>
+#include <cstdlib>
+#include <limits>
+#include <jsoncons/json_exception.hpp>
+#include <jsoncons/json_output_handler.hpp>
+#include <jsoncons_ext/detail/binary_utilities.hpp>
+
+namespace jsoncons { namespace cbor {
+
+// Encodes events as CBOR as they arrive. Sizes aren't known until an
+// object or array ends, so maps and arrays are written with indefinite
+// lengths. Output to a stream is buffered, and the buffer is flushed
+// when it is full and at end_json.
+class cbor_serializer : public basic_json_output_handler<char>
+{
+public:
+    using typename basic_json_output_handler<char>::string_view_type;
+private:
+    static const size_t default_buffer_length = 16384;
+
+    std::ostream* os_;
+    std::vector<uint8_t> buffer_;
+    std::vector<uint8_t>& result_;
+
+    // Noncopyable and nonmoveable
+    cbor_serializer(const cbor_serializer&) = delete;
+    cbor_serializer& operator=(const cbor_serializer&) = delete;
+public:
+    explicit cbor_serializer(std::ostream& os)
+        : os_(std::addressof(os)), result_(buffer_)
+    {
+        buffer_.reserve(default_buffer_length);
+    }
+
+    explicit cbor_serializer(std::vector<uint8_t>& v)
+        : os_(nullptr), result_(v)
+    {
+    }
+
+    ~cbor_serializer()
+    {
+        flush();
+    }
+
+    void flush()
+    {
+        if (os_ != nullptr && !buffer_.empty())
+        {
+            os_->write(reinterpret_cast<const char*>(buffer_.data()), buffer_.size());
+            buffer_.clear();
+        }
+    }
+
+private:
+    // Writes the initial byte of a data item of the given major type,
+    // with its argument (a value, length or count) in the fewest bytes
+    static void write_head(uint8_t major_type, uint64_t value, std::vector<uint8_t>& v)
+    {
+        const uint8_t type = static_cast<uint8_t>(major_type << 5);
+        if (value <= 0x17)
+        {
+            v.push_back(static_cast<uint8_t>(type | value));
+        }
+        else if (value <= (std::numeric_limits<uint8_t>::max)())
+        {
+            v.push_back(static_cast<uint8_t>(type | 0x18));
+            v.push_back(static_cast<uint8_t>(value));
+        }
+        else if (value <= (std::numeric_limits<uint16_t>::max)())
+        {
+            v.push_back(static_cast<uint8_t>(type | 0x19));
+            jsoncons::detail::binary::to_big_endian(static_cast<uint16_t>(value), v);
+        }
+        else if (value <= (std::numeric_limits<uint32_t>::max)())
+        {
+            v.push_back(static_cast<uint8_t>(type | 0x1a));
+            jsoncons::detail::binary::to_big_endian(static_cast<uint32_t>(value), v);
+        }
+        else
+        {
+            v.push_back(static_cast<uint8_t>(type | 0x1b));
+            jsoncons::detail::binary::to_big_endian(static_cast<uint64_t>(value), v);
+        }
+    }
+
+    void check_flush()
+    {
+        if (os_ != nullptr && buffer_.size() >= default_buffer_length)
+        {
+            flush();
+        }
+    }
+
+    void write_string(string_view_type sv)
+    {
+        auto result = unicons::validate(sv.begin(), sv.end());
+        if (result.ec != unicons::conv_errc())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Illegal unicode");
+        }
+        write_head(3, sv.length(), result_);
+        result_.insert(result_.end(),
+                       reinterpret_cast<const uint8_t*>(sv.data()),
+                       reinterpret_cast<const uint8_t*>(sv.data()) + sv.length());
+    }
+
+    void do_begin_json() override
+    {
+    }
+
+    void do_end_json() override
+    {
+        flush();
+        if (os_ != nullptr)
+        {
+            os_->flush();
+        }
+    }
+
+    void do_begin_object() override
+    {
+        result_.push_back(0xbf);
+    }
+
+    void do_end_object() override
+    {
+        result_.push_back(0xff);
+        check_flush();
+    }
+
+    void do_begin_array() override
+    {
+        result_.push_back(0x9f);
+    }
+
+    void do_end_array() override
+    {
+        result_.push_back(0xff);
+        check_flush();
+    }
+
+    void do_name(string_view_type name) override
+    {
+        write_string(name);
+    }
+
+    void do_null_value() override
+    {
+        result_.push_back(0xf6);
+        check_flush();
+    }
+
+    void do_string_value(string_view_type value) override
+    {
+        write_string(value);
+        check_flush();
+    }
+
+    void do_double_value(double value, uint8_t) override
+    {
+        result_.push_back(0xfb);
+        jsoncons::detail::binary::to_big_endian(value, result_);
+        check_flush();
+    }
+
+    void do_integer_value(int64_t value) override
+    {
+        if (value >= 0)
+        {
+            write_head(0, static_cast<uint64_t>(value), result_);
+        }
+        else
+        {
+            write_head(1, static_cast<uint64_t>(-1 - value), result_);
+        }
+        check_flush();
+    }
+
+    void do_uinteger_value(uint64_t value) override
+    {
+        write_head(0, value, result_);
+        check_flush();
+    }
+
+    void do_bool_value(bool value) override
+    {
+        result_.push_back(value ? 0xf5 : 0xf4);
+        check_flush();
+    }
+};
+
+}}
+
+#endif
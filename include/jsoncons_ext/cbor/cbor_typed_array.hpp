@@ -0,0 +1,235 @@
+// Copyright 2017 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_CBOR_CBOR_TYPED_ARRAY_HPP
+#define JSONCONS_CBOR_CBOR_TYPED_ARRAY_HPP
+
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+#include <jsoncons_ext/detail/binary_utilities.hpp>
+
+namespace jsoncons { namespace cbor {
+
+// The element type of an RFC 8746 typed array, given by its tag. Tags 64
+// to 87 are 0b010fsell: f for floating point, s for signed, e for little
+// endian, and ll for the element size. Elements are packed in a byte 
+// string, and aren't aligned.
+class typed_array_format
+{
+public:
+    enum class element_kind {uinteger, integer, floating};
+private:
+    uint8_t tag_;
+public:
+    explicit typed_array_format(uint8_t tag)
+        : tag_(tag)
+    {
+    }
+
+    // Tags 64 to 86 other than the reserved 76 and the 128 bit floats
+    static bool is_supported(uint64_t tag)
+    {
+        return tag >= 64 && tag <= 86 && tag != 76 && tag != 83;
+    }
+
+    // The little endian format for elements of the given kind and size
+    static uint8_t tag_for(element_kind kind, size_t element_size)
+    {
+        uint8_t ll = element_size == 1 ? 0 : element_size == 2 ? 1 : element_size == 4 ? 2 : 3;
+        if (kind == element_kind::floating)
+        {
+            return static_cast<uint8_t>(0x54 + ll - 1);
+        }
+        return element_size == 1 
+            ? static_cast<uint8_t>(kind == element_kind::integer ? 0x48 : 0x40)
+            : static_cast<uint8_t>((kind == element_kind::integer ? 0x4c : 0x44) + ll);
+    }
+
+    uint8_t tag() const
+    {
+        return tag_;
+    }
+
+    element_kind kind() const
+    {
+        return (tag_ & 0x10) ? element_kind::floating : (tag_ & 0x08) ? element_kind::integer : element_kind::uinteger;
+    }
+
+    bool little_endian() const
+    {
+        return (tag_ & 0x04) != 0;
+    }
+
+    size_t element_size() const
+    {
+        return static_cast<size_t>(kind() == element_kind::floating ? 2 << (tag_ & 0x03) : 1 << (tag_ & 0x03));
+    }
+
+    double as_double(const uint8_t* p) const
+    {
+        switch (kind())
+        {
+        case element_kind::floating:
+            switch (element_size())
+            {
+            case 2:
+                return detail::binary::decode_half(load<uint16_t>(p));
+            case 4:
+                return load<float>(p);
+            default:
+                return load<double>(p);
+            }
+        case element_kind::integer:
+            return static_cast<double>(as_integer(p));
+        default:
+            return static_cast<double>(as_uinteger(p));
+        }
+    }
+
+    int64_t as_integer(const uint8_t* p) const
+    {
+        switch (kind())
+        {
+        case element_kind::integer:
+            switch (element_size())
+            {
+            case 1:
+                return load<int8_t>(p);
+            case 2:
+                return load<int16_t>(p);
+            case 4:
+                return load<int32_t>(p);
+            default:
+                return load<int64_t>(p);
+            }
+        case element_kind::uinteger:
+            return static_cast<int64_t>(as_uinteger(p));
+        default:
+            return static_cast<int64_t>(as_double(p));
+        }
+    }
+
+    uint64_t as_uinteger(const uint8_t* p) const
+    {
+        switch (kind())
+        {
+        case element_kind::uinteger:
+            switch (element_size())
+            {
+            case 1:
+                return load<uint8_t>(p);
+            case 2:
+                return load<uint16_t>(p);
+            case 4:
+                return load<uint32_t>(p);
+            default:
+                return load<uint64_t>(p);
+            }
+        case element_kind::integer:
+            return static_cast<uint64_t>(as_integer(p));
+        default:
+            return static_cast<uint64_t>(as_double(p));
+        }
+    }
+
+    // Copies count elements starting at data to out. When T is the
+    // element type, this is a memcpy, or a byte swap of each element if
+    // the byte order isn't the host's.
+    template <class T>
+    void copy(const uint8_t* data, size_t count, T* out) const
+    {
+        if (sizeof(T) == element_size() && 
+            (std::is_floating_point<T>::value ? kind() == element_kind::floating 
+                                              : kind() == (std::is_signed<T>::value ? element_kind::integer : element_kind::uinteger)))
+        {
+            if (little_endian() == host_is_little_endian())
+            {
+                std::memcpy(out, data, count*sizeof(T));
+            }
+            else
+            {
+                for (size_t i = 0; i < count; ++i)
+                {
+                    out[i] = load<T>(data + i*sizeof(T));
+                }
+            }
+            return;
+        }
+        const size_t size = element_size();
+        for (size_t i = 0; i < count; ++i, data += size)
+        {
+            out[i] = convert<T>(data);
+        }
+    }
+
+    // Writes value to p in little endian order
+    template <class T>
+    static void store_little_endian(T value, uint8_t* p)
+    {
+        typename unsigned_of_size<sizeof(T)>::type bits;
+        std::memcpy(&bits, &value, sizeof(T));
+        for (size_t i = 0; i < sizeof(T); ++i)
+        {
+            p[i] = static_cast<uint8_t>(bits >> (8*i));
+        }
+    }
+
+    static bool host_is_little_endian()
+    {
+        const uint16_t x = 1;
+        uint8_t b;
+        std::memcpy(&b, &x, 1);
+        return b == 1;
+    }
+private:
+    template <size_t N> struct unsigned_of_size;
+
+    template <class T>
+    typename std::enable_if<std::is_floating_point<T>::value,T>::type
+    convert(const uint8_t* p) const
+    {
+        return static_cast<T>(as_double(p));
+    }
+
+    template <class T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value,T>::type
+    convert(const uint8_t* p) const
+    {
+        return static_cast<T>(as_integer(p));
+    }
+
+    template <class T>
+    typename std::enable_if<std::is_integral<T>::value && !std::is_signed<T>::value,T>::type
+    convert(const uint8_t* p) const
+    {
+        return static_cast<T>(as_uinteger(p));
+    }
+
+    // The element of type T at p, in this format's byte order
+    template <class T>
+    T load(const uint8_t* p) const
+    {
+        typename unsigned_of_size<sizeof(T)>::type bits = 0;
+        for (size_t i = 0; i < sizeof(T); ++i)
+        {
+            const size_t shift = little_endian() ? 8*i : 8*(sizeof(T) - 1 - i);
+            bits |= static_cast<typename unsigned_of_size<sizeof(T)>::type>(static_cast<uint64_t>(p[i]) << shift);
+        }
+        T value;
+        std::memcpy(&value, &bits, sizeof(T));
+        return value;
+    }
+};
+
+template <> struct typed_array_format::unsigned_of_size<1> {typedef uint8_t type;};
+template <> struct typed_array_format::unsigned_of_size<2> {typedef uint16_t type;};
+template <> struct typed_array_format::unsigned_of_size<4> {typedef uint32_t type;};
+template <> struct typed_array_format::unsigned_of_size<8> {typedef uint64_t type;};
+
+}}
+
+#endif
@@ -0,0 +1,975 @@
+// Copyright 2017 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_CBOR_CBOR_VIEW_HPP
+#define JSONCONS_CBOR_CBOR_VIEW_HPP
+
+#include <string>
+#include <vector>
+#include <limits>
+#include <cstring>
+#include <iterator>
+#include <type_traits>
+#include <jsoncons/json.hpp>
+#include <jsoncons/parse_error_handler.hpp>
+#include <jsoncons_ext/detail/binary_utilities.hpp>
+#include <jsoncons_ext/cbor/cbor_error_category.hpp>
+#include <jsoncons_ext/cbor/cbor_parser.hpp>
+#include <jsoncons_ext/cbor/cbor_typed_array.hpp>
+
+namespace jsoncons { namespace cbor {
+
+// A read-only view of a CBOR data item in a buffer that the caller
+// keeps alive. Nothing is decoded until it is asked for: navigation
+// reads heads and skips nested items by their lengths, and strings are
+// compared and returned in place. Tags are passed over, except that a
+// byte string tagged as an RFC 8746 typed array is an array, whose
+// elements are decoded when they are indexed or iterated over, or can be
+// copied out in bulk. Malformed bytes are reported with
+// a parse_error when they are reached.
+class cbor_view
+{
+public:
+    typedef char char_type;
+    typedef basic_json_input_handler<char>::string_view_type string_view_type;
+
+    class member;
+    class array_iterator;
+    class object_iterator;
+private:
+    static const uint64_t indefinite_length = (std::numeric_limits<uint64_t>::max)();
+
+    template <class T>
+    struct is_vector_of_numbers : std::false_type {};
+
+    template <class T, class Allocator>
+    struct is_vector_of_numbers<std::vector<T,Allocator>> 
+        : std::integral_constant<bool,std::is_arithmetic<T>::value && !std::is_same<T,bool>::value> {};
+
+    const uint8_t* base_;
+    const uint8_t* first_;
+    const uint8_t* last_;
+    uint8_t typed_array_tag_;
+    // An element of a typed array, encoded as a CBOR number
+    uint8_t element_[9];
+
+    cbor_view(const uint8_t* base, const uint8_t* first, const uint8_t* last)
+        : base_(base), first_(skip_tags(base, first, last)), last_(last), 
+          typed_array_tag_(typed_array_tag(first, first_))
+    {
+    }
+
+    // A view of element p of a typed array, which has no data item of
+    // its own, so it is decoded into element_
+    cbor_view(const typed_array_format& format, const uint8_t* p)
+        : base_(element_), first_(element_), last_(element_ + sizeof(element_)), typed_array_tag_(0)
+    {
+        uint64_t value;
+        switch (format.kind())
+        {
+            case typed_array_format::element_kind::floating:
+            {
+                double d = format.as_double(p);
+                std::memcpy(&value, &d, sizeof(value));
+                element_[0] = 0xfb;
+                break;
+            }
+            case typed_array_format::element_kind::integer:
+            {
+                int64_t n = format.as_integer(p);
+                value = n < 0 ? static_cast<uint64_t>(-1 - n) : static_cast<uint64_t>(n);
+                element_[0] = n < 0 ? 0x3b : 0x1b;
+                break;
+            }
+            default:
+                value = format.as_uinteger(p);
+                element_[0] = 0x1b;
+                break;
+        }
+        for (size_t i = 1; i < sizeof(element_); ++i)
+        {
+            element_[i] = static_cast<uint8_t>(value >> (8*(sizeof(element_) - 1 - i)));
+        }
+    }
+public:
+    cbor_view(const uint8_t* buffer, size_t length)
+        : base_(buffer), first_(skip_tags(buffer, buffer, buffer + length)), last_(buffer + length), 
+          typed_array_tag_(typed_array_tag(buffer, first_))
+    {
+    }
+
+    explicit cbor_view(const std::vector<uint8_t>& v)
+        : cbor_view(v.data(), v.size())
+    {
+    }
+
+    cbor_view(const cbor_view& other)
+        : base_(other.base_), first_(other.first_), last_(other.last_), typed_array_tag_(other.typed_array_tag_)
+    {
+        rebase(other);
+    }
+
+    cbor_view& operator=(const cbor_view& other)
+    {
+        base_ = other.base_;
+        first_ = other.first_;
+        last_ = other.last_;
+        typed_array_tag_ = other.typed_array_tag_;
+        rebase(other);
+        return *this;
+    }
+
+    bool is_null() const
+    {
+        return *first_ == 0xf6;
+    }
+
+    bool is_bool() const
+    {
+        return *first_ == 0xf4 || *first_ == 0xf5;
+    }
+
+    bool is_string() const
+    {
+        return major_type() == 3;
+    }
+
+    bool is_integer() const
+    {
+        return (major_type() == 0 || major_type() == 1) &&
+               argument(first_) <= static_cast<uint64_t>((std::numeric_limits<int64_t>::max)());
+    }
+
+    bool is_uinteger() const
+    {
+        return major_type() == 0;
+    }
+
+    bool is_double() const
+    {
+        return *first_ == 0xf9 || *first_ == 0xfa || *first_ == 0xfb;
+    }
+
+    bool is_number() const
+    {
+        return major_type() == 0 || major_type() == 1 || is_double();
+    }
+
+    bool is_array() const
+    {
+        return major_type() == 4 || is_typed_array();
+    }
+
+    bool is_object() const
+    {
+        return major_type() == 5;
+    }
+
+    bool is_typed_array() const
+    {
+        return typed_array_tag_ != 0;
+    }
+
+    // Number of members or elements, 0 for other values. Indefinite
+    // length arrays and maps are counted by skipping their items.
+    size_t size() const
+    {
+        if (is_typed_array())
+        {
+            size_t count;
+            typed_array_data(count);
+            return count;
+        }
+        if (major_type() != 4 && !is_object())
+        {
+            return 0;
+        }
+        if (!is_indefinite(first_))
+        {
+            return static_cast<size_t>(argument(first_));
+        }
+        size_t count = 0;
+        const uint8_t* p = first_ + 1;
+        while (peek(p) != 0xff)
+        {
+            p = skip(p);
+            ++count;
+        }
+        return is_object() ? count/2 : count;
+    }
+
+    bool empty() const
+    {
+        return size() == 0;
+    }
+
+    cbor_view operator[](size_t i) const
+    {
+        return at(i);
+    }
+
+    cbor_view at(size_t i) const
+    {
+        if (!is_array())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Index on non-array value not supported");
+        }
+        if (is_typed_array())
+        {
+            size_t count;
+            const uint8_t* data = typed_array_data(count);
+            if (i >= count)
+            {
+                JSONCONS_THROW_EXCEPTION(std::out_of_range,"Invalid array subscript");
+            }
+            typed_array_format format(typed_array_tag_);
+            return cbor_view(format, data + i*format.element_size());
+        }
+        array_iterator it = array_range().begin();
+        for (; i > 0 && it != array_iterator(); --i)
+        {
+            ++it;
+        }
+        if (it == array_iterator())
+        {
+            JSONCONS_THROW_EXCEPTION(std::out_of_range,"Invalid array subscript");
+        }
+        return *it;
+    }
+
+    cbor_view operator[](string_view_type name) const
+    {
+        return at(name);
+    }
+
+    cbor_view at(string_view_type name) const
+    {
+        const uint8_t* p;
+        if (!find(name, p))
+        {
+            JSONCONS_THROW_EXCEPTION_1(std::out_of_range,"%s not found", name);
+        }
+        return cbor_view(base_, p, last_);
+    }
+
+    bool has_key(string_view_type name) const
+    {
+        const uint8_t* p;
+        return find(name, p);
+    }
+
+    range<array_iterator> array_range() const
+    {
+        if (!is_array())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not an array");
+        }
+        if (is_typed_array())
+        {
+            size_t count;
+            const uint8_t* data = typed_array_data(count);
+            return range<array_iterator>(array_iterator(base_, data, last_, count, typed_array_tag_),
+                                         array_iterator());
+        }
+        return range<array_iterator>(array_iterator(base_, first_ + head_length(first_), last_, item_count(first_)),
+                                     array_iterator());
+    }
+
+    range<object_iterator> object_range() const
+    {
+        if (!is_object())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not an object");
+        }
+        return range<object_iterator>(object_iterator(base_, first_ + head_length(first_), last_, item_count(first_)),
+                                      object_iterator());
+    }
+
+    // The text of a definite length string, in place
+    string_view_type as_string_view() const
+    {
+        if (!is_string())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not a string");
+        }
+        if (is_indefinite(first_))
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not a definite length string");
+        }
+        const uint64_t length = argument(first_);
+        const uint8_t* first = first_ + head_length(first_);
+        if (length > static_cast<uint64_t>(last_ - first))
+        {
+            fail(cbor_parser_errc::unexpected_eof, last_);
+        }
+        const char* s = reinterpret_cast<const char*>(first);
+        auto result = unicons::validate(s, s + static_cast<size_t>(length));
+        if (result.ec != unicons::conv_errc())
+        {
+            fail(cbor_parser_errc::invalid_utf8_text_string, first_);
+        }
+        return string_view_type(s, static_cast<size_t>(length));
+    }
+
+    std::string as_string() const
+    {
+        if (!is_string())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not a string");
+        }
+        std::string s;
+        append_string(first_, s);
+        auto result = unicons::validate(s.begin(), s.end());
+        if (result.ec != unicons::conv_errc())
+        {
+            fail(cbor_parser_errc::invalid_utf8_text_string, first_);
+        }
+        return s;
+    }
+
+    bool as_bool() const
+    {
+        if (!is_bool())
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not a bool");
+        }
+        return *first_ == 0xf5;
+    }
+
+    int64_t as_integer() const
+    {
+        switch (major_type())
+        {
+        case 0:
+            return static_cast<int64_t>(argument(first_));
+        case 1:
+            return static_cast<int64_t>(-1) - static_cast<int64_t>(argument(first_));
+        default:
+            if (is_double())
+            {
+                return static_cast<int64_t>(as_double());
+            }
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not an integer");
+        }
+    }
+
+    uint64_t as_uinteger() const
+    {
+        switch (major_type())
+        {
+        case 0:
+            return argument(first_);
+        case 1:
+            return static_cast<uint64_t>(as_integer());
+        default:
+            if (is_double())
+            {
+                return static_cast<uint64_t>(as_double());
+            }
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not an unsigned integer");
+        }
+    }
+
+    double as_double() const
+    {
+        switch (*first_)
+        {
+        case 0xf9:
+            return detail::binary::decode_half(static_cast<uint16_t>(argument(first_)));
+        case 0xfa:
+            return detail::binary::from_big_endian<float>(first_ + 1, last_);
+        case 0xfb:
+            return detail::binary::from_big_endian<double>(first_ + 1, last_);
+        default:
+            if (major_type() == 0)
+            {
+                return static_cast<double>(argument(first_));
+            }
+            if (major_type() == 1)
+            {
+                return -1.0 - static_cast<double>(argument(first_));
+            }
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not a double");
+        }
+    }
+
+    template <class T>
+    typename std::enable_if<std::is_same<T,bool>::value,T>::type
+    as() const
+    {
+        return as_bool();
+    }
+
+    template <class T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value,T>::type
+    as() const
+    {
+        return static_cast<T>(as_integer());
+    }
+
+    template <class T>
+    typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value && !std::is_same<T,bool>::value,T>::type
+    as() const
+    {
+        return static_cast<T>(as_uinteger());
+    }
+
+    template <class T>
+    typename std::enable_if<std::is_floating_point<T>::value,T>::type
+    as() const
+    {
+        return static_cast<T>(as_double());
+    }
+
+    template <class T>
+    typename std::enable_if<std::is_same<T,std::string>::value,T>::type
+    as() const
+    {
+        return as_string();
+    }
+
+    template <class T>
+    typename std::enable_if<std::is_same<T,string_view_type>::value,T>::type
+    as() const
+    {
+        return as_string_view();
+    }
+
+    // The elements of a typed array, copied in bulk, or of an array of numbers
+    template <class T>
+    typename std::enable_if<is_vector_of_numbers<T>::value,T>::type
+    as() const
+    {
+        typedef typename T::value_type value_type;
+        T v;
+        if (is_typed_array())
+        {
+            size_t count;
+            const uint8_t* data = typed_array_data(count);
+            v.resize(count);
+            if (count > 0)
+            {
+                typed_array_format(typed_array_tag_).copy(data, count, &v[0]);
+            }
+        }
+        else if (is_array())
+        {
+            if (!is_indefinite(first_))
+            {
+                v.reserve(size());
+            }
+            for (const auto& item : array_range())
+            {
+                v.push_back(item.as<value_type>());
+            }
+        }
+        else
+        {
+            JSONCONS_THROW_EXCEPTION(std::runtime_error,"Not an array");
+        }
+        return v;
+    }
+
+    // The bytes of this data item, without its tags
+    const uint8_t* data() const
+    {
+        return first_;
+    }
+
+    size_t encoded_size() const
+    {
+        return static_cast<size_t>(skip(first_) - first_);
+    }
+
+    // Decodes this value and everything below it
+    template <class Json>
+    Json as_json() const
+    {
+        if (is_typed_array())
+        {
+            return typed_array_as_json<Json>();
+        }
+        json_decoder<Json> decoder;
+        basic_cbor_parser<typename Json::char_type> parser(decoder);
+        parser.set_source(first_, encoded_size());
+        parser.parse();
+        parser.end_parse();
+        return decoder.get_result();
+    }
+
+    class member
+    {
+        const uint8_t* base_;
+        const uint8_t* name_;
+        const uint8_t* value_;
+        const uint8_t* last_;
+
+        member(const uint8_t* base, const uint8_t* name, const uint8_t* value, const uint8_t* last)
+            : base_(base), name_(name), value_(value), last_(last)
+        {
+        }
+
+        friend class cbor_view;
+        friend class object_iterator;
+    public:
+        std::string key() const
+        {
+            return name().as_string();
+        }
+
+        cbor_view name() const
+        {
+            return cbor_view(base_, name_, last_);
+        }
+
+        cbor_view value() const
+        {
+            return cbor_view(base_, value_, last_);
+        }
+    };
+
+    // Iterators count down the items of a definite length array or map,
+    // or stop at the break that ends an indefinite length one, so the
+    // end of a range is found without skipping over it
+    class array_iterator
+    {
+        const uint8_t* base_;
+        const uint8_t* p_;
+        const uint8_t* last_;
+        uint64_t remaining_;
+        uint8_t typed_array_tag_;
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef cbor_view value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const cbor_view* pointer;
+        typedef cbor_view reference;
+
+        friend class object_iterator;
+
+        array_iterator()
+            : base_(nullptr), p_(nullptr), last_(nullptr), remaining_(0), typed_array_tag_(0)
+        {
+        }
+
+        // The elements of a typed array are stepped over by their size
+        array_iterator(const uint8_t* base, const uint8_t* p, const uint8_t* last, uint64_t length, 
+                       uint8_t typed_array_tag = 0)
+            : base_(base), p_(p), last_(last), remaining_(length), typed_array_tag_(typed_array_tag)
+        {
+            check_break();
+        }
+
+        cbor_view operator*() const
+        {
+            return typed_array_tag_ != 0 ? cbor_view(typed_array_format(typed_array_tag_), p_) 
+                                         : cbor_view(base_, p_, last_);
+        }
+
+        array_iterator& operator++()
+        {
+            p_ = typed_array_tag_ != 0 ? p_ + typed_array_format(typed_array_tag_).element_size()
+                                       : cbor_view::skip(base_, p_, last_);
+            if (remaining_ != indefinite_length)
+            {
+                --remaining_;
+            }
+            check_break();
+            return *this;
+        }
+
+        array_iterator operator++(int)
+        {
+            array_iterator temp(*this);
+            ++*this;
+            return temp;
+        }
+
+        friend bool operator==(const array_iterator& lhs, const array_iterator& rhs)
+        {
+            return lhs.remaining_ == rhs.remaining_ && (lhs.remaining_ == 0 || lhs.p_ == rhs.p_);
+        }
+
+        friend bool operator!=(const array_iterator& lhs, const array_iterator& rhs)
+        {
+            return !(lhs == rhs);
+        }
+    private:
+        void check_break()
+        {
+            if (remaining_ == indefinite_length && cbor_view::peek(base_, p_, last_) == 0xff)
+            {
+                remaining_ = 0;
+            }
+        }
+    };
+
+    class object_iterator
+    {
+        array_iterator it_;
+    public:
+        typedef std::forward_iterator_tag iterator_category;
+        typedef member value_type;
+        typedef std::ptrdiff_t difference_type;
+        typedef const member* pointer;
+        typedef member reference;
+
+        object_iterator()
+        {
+        }
+
+        object_iterator(const uint8_t* base, const uint8_t* p, const uint8_t* last, uint64_t length)
+            : it_(base, p, last, length == indefinite_length ? length : 2*length)
+        {
+        }
+
+        member operator*() const
+        {
+            array_iterator value = it_;
+            ++value;
+            return member(it_.base_, it_.p_, value.p_, it_.last_);
+        }
+
+        object_iterator& operator++()
+        {
+            ++it_;
+            ++it_;
+            return *this;
+        }
+
+        object_iterator operator++(int)
+        {
+            object_iterator temp(*this);
+            ++*this;
+            return temp;
+        }
+
+        friend bool operator==(const object_iterator& lhs, const object_iterator& rhs)
+        {
+            return lhs.it_ == rhs.it_;
+        }
+
+        friend bool operator!=(const object_iterator& lhs, const object_iterator& rhs)
+        {
+            return !(lhs == rhs);
+        }
+    };
+
+private:
+    uint8_t major_type() const
+    {
+        return *first_ >> 5;
+    }
+
+    // Points a copy of an element of a typed array at its own element_
+    void rebase(const cbor_view& other)
+    {
+        if (other.first_ == other.element_)
+        {
+            std::memcpy(element_, other.element_, sizeof(element_));
+            base_ = first_ = element_;
+            last_ = element_ + sizeof(element_);
+        }
+    }
+
+    // The tag before the item at first if it is a typed array tag and the
+    // item is a definite length byte string, otherwise 0
+    static uint8_t typed_array_tag(const uint8_t* p, const uint8_t* first)
+    {
+        uint64_t tag = 0;
+        for (; p < first; p += head_length(p))
+        {
+            tag = argument(p);
+        }
+        return (*first >> 5) == 2 && !is_indefinite(first) && typed_array_format::is_supported(tag)
+            ? static_cast<uint8_t>(tag) : 0;
+    }
+
+    const uint8_t* typed_array_data(size_t& count) const
+    {
+        const uint64_t length = argument(first_);
+        const uint8_t* data = first_ + head_length(first_);
+        if (length > static_cast<uint64_t>(last_ - data))
+        {
+            fail(cbor_parser_errc::unexpected_eof, last_);
+        }
+        const size_t element_size = typed_array_format(typed_array_tag_).element_size();
+        if (length % element_size != 0)
+        {
+            fail(cbor_parser_errc::invalid_typed_array, first_);
+        }
+        count = static_cast<size_t>(length) / element_size;
+        return data;
+    }
+
+    template <class Json>
+    Json typed_array_as_json() const
+    {
+        typed_array_format format(typed_array_tag_);
+        size_t count;
+        const uint8_t* data = typed_array_data(count);
+
+        Json result = typename Json::array();
+        result.reserve(count);
+        for (size_t i = 0; i < count; ++i, data += format.element_size())
+        {
+            switch (format.kind())
+            {
+                case typed_array_format::element_kind::floating:
+                    result.push_back(Json(format.as_double(data)));
+                    break;
+                case typed_array_format::element_kind::integer:
+                    result.push_back(Json(format.as_integer(data)));
+                    break;
+                default:
+                    result.push_back(Json(format.as_uinteger(data)));
+                    break;
+            }
+        }
+        return result;
+    }
+
+    void fail(cbor_parser_errc errc, const uint8_t* p) const
+    {
+        throw parse_error(errc, 1, static_cast<size_t>(p - base_) + 1);
+    }
+
+    static void fail(cbor_parser_errc errc, const uint8_t* base, const uint8_t* p)
+    {
+        throw parse_error(errc, 1, static_cast<size_t>(p - base) + 1);
+    }
+
+    static uint8_t peek(const uint8_t* base, const uint8_t* p, const uint8_t* last)
+    {
+        if (p >= last)
+        {
+            fail(cbor_parser_errc::unexpected_eof, base, p);
+        }
+        return *p;
+    }
+
+    uint8_t peek(const uint8_t* p) const
+    {
+        return peek(base_, p, last_);
+    }
+
+    static size_t head_length(const uint8_t* p)
+    {
+        switch (*p & 0x1f)
+        {
+            case 0x18:
+                return 1 + sizeof(uint8_t);
+            case 0x19:
+                return 1 + sizeof(uint16_t);
+            case 0x1a:
+                return 1 + sizeof(uint32_t);
+            case 0x1b:
+                return 1 + sizeof(uint64_t);
+            default:
+                return 1;
+        }
+    }
+
+    // The value, length or count in a head that is known to be in the buffer
+    static uint64_t argument(const uint8_t* p)
+    {
+        switch (*p & 0x1f)
+        {
+            case 0x18:
+                return detail::binary::from_big_endian<uint8_t>(p+1,p+2);
+            case 0x19:
+                return detail::binary::from_big_endian<uint16_t>(p+1,p+3);
+            case 0x1a:
+                return detail::binary::from_big_endian<uint32_t>(p+1,p+5);
+            case 0x1b:
+                return detail::binary::from_big_endian<uint64_t>(p+1,p+9);
+            default:
+                return *p & 0x1f;
+        }
+    }
+
+    static bool is_indefinite(const uint8_t* p)
+    {
+        return (*p & 0x1f) == 0x1f;
+    }
+
+    // The number of items in an array, map or string, or indefinite_length
+    static uint64_t item_count(const uint8_t* p)
+    {
+        return is_indefinite(p) ? indefinite_length : argument(p);
+    }
+
+    // Checks that the head at p is well formed and in the buffer
+    static void check_head(const uint8_t* base, const uint8_t* p, const uint8_t* last)
+    {
+        if (peek(base, p, last) == 0xff)
+        {
+            fail(cbor_parser_errc::unexpected_break, base, p);
+        }
+        const uint8_t info = *p & 0x1f;
+        if ((info > 0x1b && info != 0x1f) || (info == 0x1f && ((*p >> 5) < 2 || (*p >> 5) == 6)))
+        {
+            fail(cbor_parser_errc::unsupported_item, base, p);
+        }
+        if (head_length(p) > static_cast<size_t>(last - p))
+        {
+            fail(cbor_parser_errc::unexpected_eof, base, p);
+        }
+    }
+
+    static const uint8_t* skip_tags(const uint8_t* base, const uint8_t* p, const uint8_t* last)
+    {
+        check_head(base, p, last);
+        while ((*p >> 5) == 6)
+        {
+            p += head_length(p);
+            check_head(base, p, last);
+        }
+        return p;
+    }
+
+    const uint8_t* skip(const uint8_t* p) const
+    {
+        return skip(base_, p, last_);
+    }
+
+    // Returns the end of the data item at p. Items in definite length
+    // arrays and maps are counted rather than recursed into; only
+    // indefinite length items need a stack.
+    static const uint8_t* skip(const uint8_t* base, const uint8_t* p, const uint8_t* last)
+    {
+        uint64_t remaining = 1;
+        std::vector<uint64_t> outer;
+        while (remaining > 0 || !outer.empty())
+        {
+            if (remaining == 0)
+            {
+                if (peek(base, p, last) == 0xff)
+                {
+                    ++p;
+                    remaining = outer.back();
+                    outer.pop_back();
+                    continue;
+                }
+                remaining = 1;
+            }
+            check_head(base, p, last);
+            --remaining;
+            const uint64_t length = argument(p);
+            const uint8_t major = *p >> 5;
+            const bool indefinite = is_indefinite(p);
+            p += head_length(p);
+            if (indefinite && major != 7)
+            {
+                outer.push_back(remaining);
+                remaining = 0;
+                continue;
+            }
+            uint64_t available = static_cast<uint64_t>(last - p);
+            switch (major)
+            {
+                case 2:
+                case 3:
+                    if (length > available)
+                    {
+                        fail(cbor_parser_errc::unexpected_eof, base, last);
+                    }
+                    p += static_cast<size_t>(length);
+                    break;
+                case 4:
+                case 6:
+                    if (major == 6 || length > 0)
+                    {
+                        const uint64_t n = major == 6 ? 1 : length;
+                        if (n > available)
+                        {
+                            fail(cbor_parser_errc::unexpected_eof, base, last);
+                        }
+                        remaining += n;
+                    }
+                    break;
+                case 5:
+                    if (length > available/2)
+                    {
+                        fail(cbor_parser_errc::unexpected_eof, base, last);
+                    }
+                    remaining += 2*length;
+                    break;
+                default:
+                    break;
+            }
+        }
+        return p;
+    }
+
+    void append_string(const uint8_t* p, std::string& s) const
+    {
+        const uint64_t length = argument(p);
+        const uint8_t* first = p + head_length(p);
+        if (!is_indefinite(p))
+        {
+            if (length > static_cast<uint64_t>(last_ - first))
+            {
+                fail(cbor_parser_errc::unexpected_eof, last_);
+            }
+            s.append(reinterpret_cast<const char*>(first), static_cast<size_t>(length));
+            return;
+        }
+        for (p = first; peek(p) != 0xff; )
+        {
+            check_head(base_, p, last_);
+            if ((*p >> 5) != 3 || is_indefinite(p))
+            {
+                fail(cbor_parser_errc::illegal_chunked_string, p);
+            }
+            append_string(p, s);
+            p += head_length(p) + static_cast<size_t>(argument(p));
+        }
+    }
+
+    // Position of the value of member name
+    bool find(string_view_type name, const uint8_t*& result) const
+    {
+        if (!is_object())
+        {
+            return false;
+        }
+        std::string buffer;
+        for (object_iterator it = object_range().begin(); it != object_iterator(); ++it)
+        {
+            member m = *it;
+            const cbor_view key = m.name();
+            if (!key.is_string())
+            {
+                continue;
+            }
+            // Bytes are compared without decoding, a key equal to name is valid UTF-8
+            bool matches;
+            const uint64_t length = argument(key.first_);
+            if (!is_indefinite(key.first_))
+            {
+                const char* first = reinterpret_cast<const char*>(key.first_ + head_length(key.first_));
+                matches = length == name.length() && std::equal(first, first + name.length(), name.data());
+            }
+            else
+            {
+                buffer.clear();
+                append_string(key.first_, buffer);
+                matches = buffer.length() == name.length() && std::equal(buffer.begin(), buffer.end(), name.data());
+            }
+            if (matches)
+            {
+                result = m.value_;
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+}}
+
+#endif
@@ -740,10 +740,16 @@ private:
                 break;
             case csv_column_type::float_t:
                 {
-                    std::istringstream iss(value);
                     double val;
-                    iss >> val;
-                    if (!iss.fail())
+                    bool is_valid = jsoncons::detail::decimal_to_double(value.data(), value.length(), val);
+                    if (!is_valid)
+                    {
+                        // Lenient fallback, e.g. surrounding blanks
+                        std::istringstream iss(value);
+                        iss >> val;
+                        is_valid = !iss.fail();
+                    }
+                    if (is_valid)
                     {
                         handler_.double_value(val, 0, *this);
                     }
@@ -843,7 +849,7 @@ private:
         stack_[top_] = mode;
     }
 
-    int peek()
+    csv_mode_type peek()
     {
         return stack_[top_];
     }
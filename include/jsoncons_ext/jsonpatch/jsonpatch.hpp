@@ -13,12 +13,20 @@
 #include <istream>
 #include <cstdlib>
 #include <memory>
+#include <cstring>
+#include <limits>
+#include <algorithm>
+#include <unordered_map>
 #include <jsoncons/json.hpp>
 #include <jsoncons_ext/jsonpointer/jsonpointer.hpp>
 #include <jsoncons_ext/jsonpatch/jsonpatch_error_category.hpp>
 
 namespace jsoncons { namespace jsonpatch {
 
+// How diff compares arrays: element by element at the same index, or
+// aligned on their common elements with add, remove and move operations
+enum class array_diff {positional, aligned};
+
 namespace detail {
 
     JSONCONS_DEFINE_LITERAL(test_literal,"test");
@@ -38,13 +46,12 @@ namespace detail {
     template <class Json>
     struct operation_unwinder
     {
-        typedef typename Json::string_type string_type;
-        typedef typename Json::string_view_type string_view_type;
+        typedef typename Json::char_type char_type;
 
         struct entry
         {
             op_type op;
-            string_type path;
+            jsonpointer::basic_pointer<char_type> path;
             Json value;
         };
 
@@ -93,87 +100,485 @@ namespace detail {
         }
     };
 
+    template <class String>
+    void append_index(String& path, size_t index)
+    {
+        path.push_back('/');
+        size_t first = path.size();
+        do
+        {
+            path.push_back(static_cast<typename String::value_type>('0' + index % 10));
+            index /= 10;
+        } while (index != 0);
+        std::reverse(path.begin() + first, path.end());
+    }
+
+    template <class String, class StringView>
+    void append_key(String& path, const StringView& key)
+    {
+        path.push_back('/');
+        for (auto c : key)
+        {
+            if (c == '~')
+            {
+                path.push_back('~');
+                path.push_back('0');
+            }
+            else if (c == '/')
+            {
+                path.push_back('~');
+                path.push_back('1');
+            }
+            else
+            {
+                path.push_back(c);
+            }
+        }
+    }
+
     template <class Json>
-    Json diff(const Json& source, const Json& target, const typename Json::string_type& path)
+    void add_operation(Json& result, 
+                       const typename Json::string_view_type& op, 
+                       const typename Json::string_type& path)
     {
         typedef typename Json::char_type char_type;
-        typedef typename Json::string_type string_type;
-        typedef typename Json::string_view_type string_view_type;
 
-        Json result = typename Json::array();
+        Json val = typename Json::object();
+        val.insert_or_assign(op_literal<char_type>(), op);
+        val.insert_or_assign(path_literal<char_type>(), path);
+        result.push_back(std::move(val));
+    }
 
-        if (source == target)
+    template <class Json>
+    void add_operation(Json& result, 
+                       const typename Json::string_view_type& op, 
+                       const typename Json::string_type& path, 
+                       const Json& value)
+    {
+        typedef typename Json::char_type char_type;
+
+        Json val = typename Json::object();
+        val.insert_or_assign(op_literal<char_type>(), op);
+        val.insert_or_assign(path_literal<char_type>(), path);
+        val.insert_or_assign(value_literal<char_type>(), value);
+        result.push_back(std::move(val));
+    }
+
+    // Counts the slots that are present in the array being patched
+    class slot_counter
+    {
+        std::vector<std::ptrdiff_t> tree_;
+    public:
+        explicit slot_counter(size_t n)
+            : tree_(n+1, 0)
+        {
+        }
+
+        void add(size_t pos, int delta)
         {
-            return result;
+            for (size_t i = pos + 1; i < tree_.size(); i += i & (~i + 1))
+            {
+                tree_[i] += delta;
+            }
+        }
+
+        // Number of present slots before pos
+        size_t count(size_t pos) const
+        {
+            std::ptrdiff_t n = 0;
+            for (size_t i = pos; i > 0; i -= i & (~i + 1))
+            {
+                n += tree_[i];
+            }
+            return static_cast<size_t>(n);
+        }
+    };
+
+    enum class edit_kind {keep,remove,add};
+
+    struct edit
+    {
+        edit_kind kind;
+        size_t i;
+        size_t j;
+    };
+
+    const size_t max_array_edits = 2000;
+
+    // Myers' O(ND) shortest edit script between a[first1,last1) and 
+    // b[first2,last2). Returns false if there are more than max_array_edits 
+    // differences.
+    template <class Equal>
+    bool shortest_edit_script(size_t first1, size_t last1, size_t first2, size_t last2, 
+                              Equal equal, std::vector<edit>& script)
+    {
+        const std::ptrdiff_t n = last1 - first1;
+        const std::ptrdiff_t m = last2 - first2;
+        const std::ptrdiff_t max_d = (std::min)(n + m, static_cast<std::ptrdiff_t>(max_array_edits));
+        const std::ptrdiff_t offset = max_d + 1;
+
+        std::vector<std::ptrdiff_t> v(2*max_d + 3, 0);
+        std::vector<std::vector<std::ptrdiff_t>> trace;
+        std::ptrdiff_t d = 0;
+        bool done = false;
+        for (; d <= max_d && !done; ++d)
+        {
+            trace.emplace_back(v.begin() + (offset - d - 1), v.begin() + (offset + d + 2));
+            for (std::ptrdiff_t k = -d; k <= d; k += 2)
+            {
+                std::ptrdiff_t x = (k == -d || (k != d && v[offset+k-1] < v[offset+k+1])) ? v[offset+k+1] : v[offset+k-1] + 1;
+                std::ptrdiff_t y = x - k;
+                while (x < n && y < m && equal(first1 + x, first2 + y))
+                {
+                    ++x;
+                    ++y;
+                }
+                v[offset+k] = x;
+                if (x >= n && y >= m)
+                {
+                    done = true;
+                    break;
+                }
+            }
+        }
+        if (!done)
+        {
+            return false;
+        }
+
+        std::vector<edit> reversed;
+        std::ptrdiff_t x = n;
+        std::ptrdiff_t y = m;
+        for (d = static_cast<std::ptrdiff_t>(trace.size()) - 1; d >= 0; --d)
+        {
+            const std::vector<std::ptrdiff_t>& prev = trace[d];
+            const std::ptrdiff_t base = d + 1;
+            std::ptrdiff_t k = x - y;
+            std::ptrdiff_t prev_k = (k == -d || (k != d && prev[base+k-1] < prev[base+k+1])) ? k + 1 : k - 1;
+            std::ptrdiff_t prev_x = d == 0 ? 0 : prev[base+prev_k];
+            std::ptrdiff_t prev_y = prev_x - prev_k;
+            while (x > prev_x && y > prev_y)
+            {
+                --x;
+                --y;
+                reversed.push_back({edit_kind::keep,first1+x,first2+y});
+            }
+            if (d > 0)
+            {
+                if (x == prev_x)
+                {
+                    reversed.push_back({edit_kind::add,first1+x,first2+y-1});
+                }
+                else
+                {
+                    reversed.push_back({edit_kind::remove,first1+x-1,first2+y});
+                }
+            }
+            x = prev_x;
+            y = prev_y;
+        }
+        script.insert(script.end(), reversed.rbegin(), reversed.rend());
+        return true;
+    }
+
+    template <class Json>
+    void diff(const Json& source, const Json& target, 
+              typename Json::string_type& path, array_diff mode, 
+              json_hash_cache<Json>& hashes, Json& result);
+
+    template <class Json>
+    void diff_positional(const Json& source, const Json& target, 
+                         typename Json::string_type& path, array_diff mode, 
+                         json_hash_cache<Json>& hashes, Json& result)
+    {
+        typedef typename Json::char_type char_type;
+
+        const size_t length = path.size();
+        size_t common = (std::min)(source.size(),target.size());
+        for (size_t i = 0; i < common; ++i)
+        {
+            append_index(path, i);
+            diff(source[i],target[i],path,mode,hashes,result);
+            path.resize(length);
+        }
+        for (size_t i = source.size(); i > common; --i)
+        {
+            append_index(path, i-1);
+            add_operation(result, remove_literal<char_type>(), path);
+            path.resize(length);
+        }
+        for (size_t i = common; i < target.size(); ++i)
+        {
+            append_index(path, i);
+            add_operation(result, add_literal<char_type>(), path, target[i]);
+            path.resize(length);
+        }
+    }
+
+    // Aligns the arrays on a longest common subsequence of equal elements. 
+    // Elements that were removed in one place and added in another become 
+    // moves, and the remaining removals and additions in a change are 
+    // paired off and diffed in place.
+    template <class Json>
+    void diff_aligned(const Json& source, const Json& target, 
+                      typename Json::string_type& path, array_diff mode, 
+                      json_hash_cache<Json>& hashes, Json& result)
+    {
+        typedef typename Json::char_type char_type;
+        const size_t npos = (std::numeric_limits<size_t>::max)();
+
+        const size_t n = source.size();
+        const size_t m = target.size();
+        std::vector<size_t> source_hashes(n);
+        for (size_t i = 0; i < n; ++i)
+        {
+            source_hashes[i] = hashes.hash(source[i]);
+        }
+        std::vector<size_t> target_hashes(m);
+        for (size_t j = 0; j < m; ++j)
+        {
+            target_hashes[j] = hashes.hash(target[j]);
+        }
+        auto equal = [&](size_t i, size_t j) 
+        {
+            return source_hashes[i] == target_hashes[j] && source[i] == target[j];
+        };
+
+        size_t prefix = 0;
+        while (prefix < n && prefix < m && equal(prefix, prefix))
+        {
+            ++prefix;
+        }
+        size_t suffix = 0;
+        while (suffix < n - prefix && suffix < m - prefix && equal(n-1-suffix, m-1-suffix))
+        {
+            ++suffix;
+        }
+
+        std::vector<edit> script;
+        if (prefix + suffix == n || prefix + suffix == m || 
+            !shortest_edit_script(prefix, n-suffix, prefix, m-suffix, equal, script))
+        {
+            script.clear();
+            for (size_t i = prefix; i < n-suffix; ++i)
+            {
+                script.push_back({edit_kind::remove,i,prefix});
+            }
+            for (size_t j = prefix; j < m-suffix; ++j)
+            {
+                script.push_back({edit_kind::add,n-suffix,j});
+            }
+        }
+
+        // Match removed elements with equal added elements
+        std::vector<size_t> moved_to(n, npos);
+        std::vector<size_t> moved_from(m, npos);
+        std::unordered_multimap<size_t,size_t> removed;
+        for (const auto& e : script)
+        {
+            if (e.kind == edit_kind::remove)
+            {
+                removed.emplace(source_hashes[e.i], e.i);
+            }
+        }
+        for (const auto& e : script)
+        {
+            if (e.kind == edit_kind::add)
+            {
+                auto range = removed.equal_range(target_hashes[e.j]);
+                for (auto it = range.first; it != range.second; ++it)
+                {
+                    if (source[it->second] == target[e.j])
+                    {
+                        moved_to[it->second] = e.j;
+                        moved_from[e.j] = it->second;
+                        removed.erase(it);
+                        break;
+                    }
+                }
+            }
+        }
+
+        // Lay out slots, each change as its removals followed by its additions
+        enum class slot_kind {keep,replace,remove,move_source,add,move_target};
+        struct slot
+        {
+            slot_kind kind;
+            size_t i;
+            size_t j;
+        };
+        std::vector<slot> slots;
+        std::vector<size_t> slot_of(n, npos);
+        std::vector<size_t> removes;
+        std::vector<size_t> adds;
+        for (size_t pos = 0; pos <= script.size(); ++pos)
+        {
+            if (pos < script.size() && script[pos].kind != edit_kind::keep)
+            {
+                if (script[pos].kind == edit_kind::remove)
+                {
+                    removes.push_back(script[pos].i);
+                }
+                else
+                {
+                    adds.push_back(script[pos].j);
+                }
+                continue;
+            }
+
+            // Pair plain removals with the plain additions that come before 
+            // the first move target, so the order of the result is kept
+            std::vector<size_t> replaced_by(removes.size(), npos);
+            size_t next_add = 0;
+            for (size_t r = 0; r < removes.size() && next_add < adds.size(); ++r)
+            {
+                if (moved_to[removes[r]] == npos)
+                {
+                    if (moved_from[adds[next_add]] != npos)
+                    {
+                        break;
+                    }
+                    replaced_by[r] = adds[next_add++];
+                }
+            }
+            for (size_t r = 0; r < removes.size(); ++r)
+            {
+                slot_of[removes[r]] = slots.size();
+                if (replaced_by[r] != npos)
+                {
+                    slots.push_back({slot_kind::replace,removes[r],replaced_by[r]});
+                }
+                else
+                {
+                    slots.push_back({moved_to[removes[r]] == npos ? slot_kind::remove : slot_kind::move_source,removes[r],npos});
+                }
+            }
+            for (size_t a = next_add; a < adds.size(); ++a)
+            {
+                slots.push_back({moved_from[adds[a]] == npos ? slot_kind::add : slot_kind::move_target,moved_from[adds[a]],adds[a]});
+            }
+            removes.clear();
+            adds.clear();
+
+            if (pos < script.size())
+            {
+                slots.push_back({slot_kind::keep,script[pos].i,script[pos].j});
+            }
+        }
+
+        slot_counter present(slots.size());
+        for (size_t s = 0; s < slots.size(); ++s)
+        {
+            if (slots[s].kind != slot_kind::add && slots[s].kind != slot_kind::move_target)
+            {
+                present.add(s, 1);
+            }
+        }
+
+        const size_t length = path.size();
+        for (size_t s = 0; s < slots.size(); ++s)
+        {
+            const slot& sl = slots[s];
+            switch (sl.kind)
+            {
+            case slot_kind::replace:
+                append_index(path, prefix + present.count(s));
+                diff(source[sl.i],target[sl.j],path,mode,hashes,result);
+                path.resize(length);
+                break;
+            case slot_kind::remove:
+                append_index(path, prefix + present.count(s));
+                add_operation(result, remove_literal<char_type>(), path);
+                path.resize(length);
+                present.add(s, -1);
+                break;
+            case slot_kind::add:
+                present.add(s, 1);
+                append_index(path, prefix + present.count(s));
+                add_operation(result, add_literal<char_type>(), path, target[sl.j]);
+                path.resize(length);
+                break;
+            case slot_kind::move_target:
+            {
+                size_t from = prefix + present.count(slot_of[sl.i]);
+                present.add(slot_of[sl.i], -1);
+                present.add(s, 1);
+                size_t to = prefix + present.count(s);
+                if (from != to)
+                {
+                    Json val = typename Json::object();
+                    val.insert_or_assign(op_literal<char_type>(), move_literal<char_type>());
+                    typename Json::string_type from_path(path);
+                    append_index(from_path, from);
+                    val.insert_or_assign(from_literal<char_type>(), from_path);
+                    append_index(path, to);
+                    val.insert_or_assign(path_literal<char_type>(), path);
+                    path.resize(length);
+                    result.push_back(std::move(val));
+                }
+                break;
+            }
+            default:
+                break;
+            }
+        }
+    }
+
+    template <class Json>
+    void diff(const Json& source, const Json& target, 
+              typename Json::string_type& path, array_diff mode, 
+              json_hash_cache<Json>& hashes, Json& result)
+    {
+        typedef typename Json::char_type char_type;
+
+        if (mode == array_diff::aligned ? hashes.equal(source, target) : source == target)
+        {
+            return;
         }
 
         if (source.is_array() && target.is_array())
         {
-            size_t common = (std::min)(source.size(),target.size());
-            for (size_t i = 0; i < common; ++i)
+            if (mode == array_diff::aligned)
             {
-                std::basic_ostringstream<char_type> ss; 
-                ss << path << '/' << i;
-                auto temp_diff = diff(source[i],target[i],ss.str());
-                result.insert(result.array_range().end(),temp_diff.array_range().begin(),temp_diff.array_range().end());
+                diff_aligned(source,target,path,mode,hashes,result);
             }
-            for (size_t i = common; i < source.size(); ++i)
+            else
             {
-                std::basic_ostringstream<char_type> ss; 
-                ss << path << '/' << i;
-                Json val = typename Json::object();
-                val.insert_or_assign(op_literal<char_type>(), remove_literal<char_type>());
-                val.insert_or_assign(path_literal<char_type>(), ss.str());
-                result.push_back(std::move(val));
+                diff_positional(source,target,path,mode,hashes,result);
             }
         }
         else if (source.is_object() && target.is_object())
         {
+            const size_t length = path.size();
             for (const auto& a : source.object_range())
             {
-                std::basic_ostringstream<char_type> ss; 
-                ss << path << '/';
-                jsonpointer::escape(a.key(),ss);
+                append_key(path, a.key());
                 auto it = target.find(a.key());
                 if (it != target.object_range().end())
                 {
-                    auto temp_diff = diff(a.value(),it->value(),ss.str());
-                    result.insert(result.array_range().end(),temp_diff.array_range().begin(),temp_diff.array_range().end());
+                    diff(a.value(),it->value(),path,mode,hashes,result);
                 }
                 else
                 {
-                    Json val = typename Json::object();
-                    val.insert_or_assign(op_literal<char_type>(), remove_literal<char_type>());
-                    val.insert_or_assign(path_literal<char_type>(), ss.str());
-                    result.push_back(std::move(val));
+                    add_operation(result, remove_literal<char_type>(), path);
                 }
+                path.resize(length);
             }
             for (const auto& a : target.object_range())
             {
                 auto it = source.find(a.key());
                 if (it == source.object_range().end())
                 {
-                    std::basic_ostringstream<char_type> ss; 
-                    ss << path << '/';
-                    jsonpointer::escape(a.key(),ss);
-                    Json val = typename Json::object();
-                    val.insert_or_assign(op_literal<char_type>(), add_literal<char_type>());
-                    val.insert_or_assign(path_literal<char_type>(), ss.str());
-                    val.insert_or_assign(value_literal<char_type>(), a.value());
-                    result.push_back(std::move(val));
+                    append_key(path, a.key());
+                    add_operation(result, add_literal<char_type>(), path, a.value());
+                    path.resize(length);
                 }
             }
         }
         else
         {
-            Json val = typename Json::object();
-            val.insert_or_assign(op_literal<char_type>(), replace_literal<char_type>());
-            val.insert_or_assign(path_literal<char_type>(), path);
-            val.insert_or_assign(value_literal<char_type>(), target);
-            result.push_back(std::move(val));
+            add_operation(result, replace_literal<char_type>(), path, target);
         }
-
-        return result;
     }
 }
 
@@ -203,12 +608,13 @@ std::tuple<jsonpatch_errc,typename Json::string_type> patch(Json& target, const
         {
             const string_view_type op = operation.at(detail::op_literal<char_type>()).as_string_view();
             const string_view_type path = operation.at(detail::path_literal<char_type>()).as_string_view();
+            const jsonpointer::basic_pointer<char_type> location(path);
 
             if (op == detail::test_literal<char_type>())
             {
                 Json val;
                 jsonpointer::jsonpointer_errc ec;
-                std::tie(val,ec) = jsonpointer::get(target,path);
+                std::tie(val,ec) = jsonpointer::get(target,location);
                 if (ec != jsonpointer::jsonpointer_errc())
                 {
                     patch_ec = jsonpatch_errc::test_failed;
@@ -235,7 +641,7 @@ std::tuple<jsonpatch_errc,typename Json::string_type> patch(Json& target, const
                 else
                 {
                     Json val = operation.at(detail::value_literal<char_type>());
-                    auto npath = jsonpointer::normalized_path(target,path);
+                    auto npath = jsonpointer::normalized_path(target,location);
                     auto insert_ec = jsonpointer::insert(target,npath,val); // try insert without replace
                     if (insert_ec == jsonpointer::jsonpointer_errc::key_already_exists) // try a replace
                     {
@@ -272,7 +678,7 @@ std::tuple<jsonpatch_errc,typename Json::string_type> patch(Json& target, const
             {
                 Json val;
                 jsonpointer::jsonpointer_errc ec;
-                std::tie(val,ec) = jsonpointer::get(target,path);
+                std::tie(val,ec) = jsonpointer::get(target,location);
                 if (ec != jsonpointer::jsonpointer_errc())
                 {
                     patch_ec = jsonpatch_errc::remove_failed;
@@ -280,7 +686,7 @@ std::tuple<jsonpatch_errc,typename Json::string_type> patch(Json& target, const
                 }
                 else
                 {
-                    ec = jsonpointer::erase(target,path);
+                    ec = jsonpointer::erase(target,location);
                     if (ec != jsonpointer::jsonpointer_errc())
                     {
                         patch_ec = jsonpatch_errc::remove_failed;
@@ -288,7 +694,7 @@ std::tuple<jsonpatch_errc,typename Json::string_type> patch(Json& target, const
                     }
                     else
                     {
-                        unwinder.stack.push_back({detail::op_type::add,path,val});
+                        unwinder.stack.push_back({detail::op_type::add,location,val});
                     }
                 }
             }
@@ -296,7 +702,7 @@ std::tuple<jsonpatch_errc,typename Json::string_type> patch(Json& target, const
             {
                 Json val;
                 jsonpointer::jsonpointer_errc ec;
-                std::tie(val,ec) = jsonpointer::get(target,path);
+                std::tie(val,ec) = jsonpointer::get(target,location);
                 if (ec != jsonpointer::jsonpointer_errc())
                 {
                     patch_ec = jsonpatch_errc::replace_failed;
@@ -307,14 +713,14 @@ std::tuple<jsonpatch_errc,typename Json::string_type> patch(Json& target, const
                     patch_ec = jsonpatch_errc::invalid_patch;
                     unwinder.state = detail::state_type::abort;
                 }
-                else if (jsonpointer::replace(target,path,operation.at(detail::value_literal<char_type>())) != jsonpointer::jsonpointer_errc())
+                else if (jsonpointer::replace(target,location,operation.at(detail::value_literal<char_type>())) != jsonpointer::jsonpointer_errc())
                 {
                     patch_ec = jsonpatch_errc::replace_failed;
                     unwinder.state = detail::state_type::abort;
                 }
                 else
                 {
-                    unwinder.stack.push_back({detail::op_type::replace,path,val});
+                    unwinder.stack.push_back({detail::op_type::replace,location,val});
                 }
             }
             else if (op == detail::move_literal<char_type>())
@@ -328,7 +734,7 @@ std::tuple<jsonpatch_errc,typename Json::string_type> patch(Json& target, const
                 {
                     Json val;
                     jsonpointer::jsonpointer_errc ec;
-                    string_view_type from = operation.at(detail::from_literal<char_type>()).as_string_view();
+                    const jsonpointer::basic_pointer<char_type> from(operation.at(detail::from_literal<char_type>()).as_string_view());
                     std::tie(val,ec) = jsonpointer::get(target,from);
                     if (ec != jsonpointer::jsonpointer_errc())
                     {
@@ -344,7 +750,7 @@ std::tuple<jsonpatch_errc,typename Json::string_type> patch(Json& target, const
                     {
                         unwinder.stack.push_back({detail::op_type::add,from,val});
                         // add
-                        auto npath = jsonpointer::normalized_path(target,path);
+                        auto npath = jsonpointer::normalized_path(target,location);
                         auto insert_ec = jsonpointer::insert(target,npath,val); // try insert without replace
                         if (insert_ec == jsonpointer::jsonpointer_errc::key_already_exists) // try a replace
                         {
@@ -389,7 +795,7 @@ std::tuple<jsonpatch_errc,typename Json::string_type> patch(Json& target, const
                 {
                     Json val;
                     jsonpointer::jsonpointer_errc ec;
-                    string_view_type from = operation.at(detail::from_literal<char_type>()).as_string_view();
+                    const jsonpointer::basic_pointer<char_type> from(operation.at(detail::from_literal<char_type>()).as_string_view());
                     std::tie(val,ec) = jsonpointer::get(target,from);
                     if (ec != jsonpointer::jsonpointer_errc())
                     {
@@ -399,7 +805,7 @@ std::tuple<jsonpatch_errc,typename Json::string_type> patch(Json& target, const
                     else
                     {
                         // add
-                        auto npath = jsonpointer::normalized_path(target,path);
+                        auto npath = jsonpointer::normalized_path(target,location);
                         auto insert_ec = jsonpointer::insert(target,npath,val); // try insert without replace
                         if (insert_ec == jsonpointer::jsonpointer_errc::key_already_exists) // try a replace
                         {
@@ -452,10 +858,13 @@ std::tuple<jsonpatch_errc,typename Json::string_type> patch(Json& target, const
 
 
 template <class Json>
-Json diff(const Json& source, const Json& target)
+Json diff(const Json& source, const Json& target, array_diff mode = array_diff::positional)
 {
     typename Json::string_type path;
-    return detail::diff(source, target, path);
+    Json result = typename Json::array();
+    json_hash_cache<Json> hashes;
+    detail::diff(source, target, path, mode, hashes, result);
+    return result;
 }
 
 }}
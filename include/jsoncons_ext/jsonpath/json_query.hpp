@@ -13,6 +13,10 @@
 #include <istream>
 #include <cstdlib>
 #include <memory>
+#include <deque>
+#include <map>
+#include <thread>
+#include <exception>
 #include <jsoncons/json.hpp>
 #include "jsonpath_filter.hpp"
 #include "jsonpath_error_category.hpp"
@@ -21,6 +25,31 @@ namespace jsoncons { namespace jsonpath {
 
 enum class result_type {value,path};
 
+class evaluation_options
+{
+    size_t thread_count_;
+    size_t parallel_threshold_;
+public:
+    static const size_t default_parallel_threshold = 10000;
+
+    evaluation_options()
+        : thread_count_(1),
+          parallel_threshold_(default_parallel_threshold)
+    {
+    }
+
+    // The number of threads that evaluate a path, 0 for one per hardware 
+    // thread. With 1, the default, paths are evaluated on the calling thread.
+    size_t thread_count() const {return thread_count_;}
+    evaluation_options& thread_count(size_t value) {thread_count_ = value; return *this;}
+
+    // The smallest number of selected nodes, or of elements of an array 
+    // reached by a wildcard, filter or recursive descent, that is split 
+    // across threads
+    size_t parallel_threshold() const {return parallel_threshold_;}
+    evaluation_options& parallel_threshold(size_t value) {parallel_threshold_ = value > 0 ? value : 1; return *this;}
+};
+
 template<class Json>
 Json json_query(const Json& root, typename Json::string_view_type path, result_type result_t = result_type::value)
 {
@@ -125,251 +154,75 @@ enum class path_state
     dot
 };
 
-template<class Json,
-         class JsonReference=const Json&,
-         class JsonPointer=const Json*,
-         class PathCons=PathConstructor<Json>>
-class jsonpath_evaluator : private parsing_context
+enum class selector_kind
+{
+    name,
+    slice,
+    expr,
+    filter
+};
+
+// One item of a bracket expression, e.g. 'name', 1:5:2, (@.length-1) or ?(@.price < 10)
+template <class Json>
+struct path_selector
 {
-private:
     typedef typename Json::char_type char_type;
     typedef typename Json::char_traits_type char_traits_type;
     typedef std::basic_string<char_type,char_traits_type> string_type;
-    typedef typename Json::key_storage_type key_storage_type;
-    typedef typename Json::string_view_type string_view_type;
-    typedef JsonReference json_reference;
-    typedef JsonPointer json_pointer;
-    typedef std::pair<string_type,json_pointer> node_type;
-    typedef std::vector<node_type> node_set;
-
-    static string_view_type length_literal() 
-    {
-        static const char_type data[] = {'l','e','n','g','t','h'};
-        return string_view_type{data,sizeof(data)/sizeof(char_type)};
-    }
-
-    class selector
-    {
-    public:
-        virtual ~selector()
-        {
-        }
-        virtual void select(const string_type& path, json_reference val, 
-                            node_set& nodes, std::vector<std::shared_ptr<Json>>& temp_json_values) = 0;
-    };
-
-    class expr_selector : public selector
-    {
-    private:
-         jsonpath_filter_expr<Json> result_;
-    public:
-        expr_selector(const jsonpath_filter_expr<Json>& result)
-            : result_(result)
-        {
-        }
 
-        void select(const string_type& path, json_reference val, 
-                    node_set& nodes, std::vector<std::shared_ptr<Json>>& temp_json_values) override
-        {
-            auto index = result_.eval(val);
-            if (index.template is<size_t>())
-            {
-                size_t start = index. template as<size_t>();
-                if (val.is_array() && start < val.size())
-                {
-                    nodes.emplace_back(PathCons()(path,start),std::addressof(val[start]));
-                }
-            }
-            else if (index.is_string())
-            {
-                name_selector selector(index.as_string_view(),true);
-                selector.select(path, val, nodes, temp_json_values);
-            }
-        }
-    };
+    selector_kind kind;
+    string_type name;
+    size_t start;
+    bool positive_start;
+    size_t end;
+    bool positive_end;
+    bool undefined_end;
+    size_t step;
+    bool positive_step;
+    std::shared_ptr<const jsonpath_filter_expr<Json>> expr;
 
-    class filter_selector : public selector
+    path_selector(selector_kind kind)
+        : kind(kind),
+          start(0), positive_start(true),
+          end(0), positive_end(true), undefined_end(false),
+          step(1), positive_step(true)
     {
-    private:
-         jsonpath_filter_expr<Json> result_;
-    public:
-        filter_selector(const jsonpath_filter_expr<Json>& result)
-            : result_(result)
-        {
-        }
-
-        void select(const string_type& path, json_reference val, node_set& nodes, std::vector<std::shared_ptr<Json>>&) override
-        {
-            if (val.is_array())
-            {
-                for (size_t i = 0; i < val.size(); ++i)
-                {
-                    if (result_.exists(val[i]))
-                    {
-                        nodes.emplace_back(PathCons()(path,i),std::addressof(val[i]));
-                    }
-                }
-            }
-            else if (val.is_object())
-            {
-                if (result_.exists(val))
-                {
-                    nodes.emplace_back(path, std::addressof(val));
-                }
-            }
-        }
-    };
+    }
+};
 
-    class name_selector : public selector
-    {
-    private:
-        string_type name_;
-        bool positive_start_;
-    public:
-        name_selector(string_view_type name, bool positive_start)
-            : name_(name), positive_start_(positive_start)
-        {
-        }
+// One step of a compiled path. A step selects, from each node selected by 
+// the previous step, all members or elements (.* or [*]), the member or 
+// element with an unquoted name, and the nodes matched by the selectors 
+// of a bracket expression. A recursive step (..) applies the name and 
+// selectors to all descendants as well.
+template <class Json>
+struct path_step
+{
+    typedef typename Json::char_type char_type;
+    typedef typename Json::char_traits_type char_traits_type;
+    typedef std::basic_string<char_type,char_traits_type> string_type;
 
-        void select(const string_type& path, json_reference val,
-            node_set& nodes,
-            std::vector<std::shared_ptr<Json>>& temp_json_values) override
-        {
-            if (val.is_object() && val.count(name_) > 0)
-            {
-                nodes.emplace_back(PathCons()(path,name_),std::addressof(val.at(name_)));
-            }
-            else if (val.is_array())
-            {
-                size_t pos = 0;
-                if (try_string_to_index(name_.data(), name_.size(), &pos, &positive_start_))
-                {
-                    size_t index = positive_start_ ? pos : val.size() - pos;
-                    if (index < val.size())
-                    {
-                        nodes.emplace_back(PathCons()(path,index),std::addressof(val[index]));
-                    }
-                }
-                else if (name_ == length_literal() && val.size() > 0)
-                {
-                    auto temp = std::make_shared<Json>(val.size());
-                    temp_json_values.push_back(temp);
-                    nodes.emplace_back(PathCons()(path,name_),temp.get());
-                }
-            }
-            else if (val.is_string())
-            {
-                size_t pos = 0;
-                string_view_type sv = val.as_string_view();
-                if (try_string_to_index(name_.data(), name_.size(), &pos, &positive_start_))
-                {
-                    size_t index = positive_start_ ? pos : sv.size() - pos;
-                    auto sequence = unicons::sequence_at(sv.data(), sv.data() + sv.size(), index);
-                    if (sequence.length() > 0)
-                    {
-                        auto temp = std::make_shared<Json>(sequence.begin(),sequence.length());
-                        temp_json_values.push_back(temp);
-                        nodes.emplace_back(PathCons()(path,index),temp.get());
-                    }
-                }
-                else if (name_ == length_literal() && sv.size() > 0)
-                {
-                    size_t count = unicons::u32_length(sv.begin(),sv.end());
-                    auto temp = std::make_shared<Json>(count);
-                    temp_json_values.push_back(temp);
-                    nodes.emplace_back(PathCons()(path,name_),temp.get());
-                }
-            }
-        }
-    };
+    bool all;
+    bool recursive;
+    string_type name;
+    std::vector<path_selector<Json>> selectors;
 
-    class array_slice_selector : public selector
+    path_step()
+        : all(false), recursive(false)
     {
-    private:
-        size_t start_;
-        bool positive_start_;
-        size_t end_;
-        bool positive_end_;
-        bool undefined_end_;
-        size_t step_;
-        bool positive_step_;
-    public:
-        array_slice_selector(size_t start, bool positive_start, 
-                             size_t end, bool positive_end,
-                             size_t step, bool positive_step,
-                             bool undefined_end)
-            : start_(start), positive_start_(positive_start),
-              end_(end), positive_end_(positive_end),undefined_end_(undefined_end),
-              step_(step), positive_step_(positive_step) 
-        {
-        }
-
-        void select(const string_type& path, 
-                    json_reference val,
-                    node_set& nodes,
-                    std::vector<std::shared_ptr<Json>>&) override
-        {
-            if (positive_step_)
-            {
-                end_array_slice1(path, val, nodes);
-            }
-            else
-            {
-                end_array_slice2(path, val, nodes);
-            }
-        }
-
-        void end_array_slice1(const string_type& path, json_reference val, node_set& nodes)
-        {
-            if (val.is_array())
-            {
-                size_t start = positive_start_ ? start_ : val.size() - start_;
-                size_t end;
-                if (!undefined_end_)
-                {
-                    end = positive_end_ ? end_ : val.size() - end_;
-                }
-                else
-                {
-                    end = val.size();
-                }
-                for (size_t j = start; j < end; j += step_)
-                {
-                    if (j < val.size())
-                    {
-                        nodes.emplace_back(PathCons()(path,j),std::addressof(val[j]));
-                    }
-                }
-            }
-        }
-
-        void end_array_slice2(const string_type& path, json_reference val, node_set& nodes)
-        {
-            if (val.is_array())
-            {
-                size_t start = positive_start_ ? start_ : val.size() - start_;
-                size_t end;
-                if (!undefined_end_)
-                {
-                    end = positive_end_ ? end_ : val.size() - end_;
-                }
-                else
-                {
-                    end = val.size();
-                }
+    }
+};
 
-                size_t j = end + step_ - 1;
-                while (j > (start+step_-1))
-                {
-                    j -= step_;
-                    if (j < val.size())
-                    {
-                        nodes.emplace_back(PathCons()(path,j),std::addressof(val[j]));
-                    }
-                }
-            }
-        }
-    };
+// Parses a JSONPath expression into steps, which don't depend on the 
+// JSON value they are applied to
+template<class Json>
+class jsonpath_compiler : private parsing_context
+{
+private:
+    typedef typename Json::char_type char_type;
+    typedef typename Json::char_traits_type char_traits_type;
+    typedef std::basic_string<char_type,char_traits_type> string_type;
+    typedef typename Json::string_view_type string_view_type;
 
     default_parse_error_handler default_err_handler_;
     parse_error_handler *err_handler_;
@@ -383,96 +236,44 @@ private:
     size_t step_;
     bool positive_step_;
     bool recursive_descent_;
-    node_set nodes_;
-    std::vector<node_set> stack_;
-    std::vector<std::shared_ptr<Json>> temp_json_values_;
+    bool has_root_;
+    path_step<Json> current_step_;
+    std::vector<path_step<Json>> steps_;
     size_t line_;
     size_t column_;
     const char_type* begin_input_;
     const char_type* end_input_;
     const char_type* p_;
-    std::vector<std::shared_ptr<selector>> selectors_;
 
 public:
-    jsonpath_evaluator()
+    jsonpath_compiler()
         : err_handler_(&default_err_handler_),
           state_(path_state::start),
           start_(0), positive_start_(true), 
           end_(0), positive_end_(true), undefined_end_(false),
           step_(0), positive_step_(true),
           recursive_descent_(false),
+          has_root_(false),
           line_(0), column_(0),
           begin_input_(nullptr), end_input_(nullptr),
           p_(nullptr)
     {
     }
 
-    Json get_values() const
-    {
-        Json result = typename Json::array();
-
-        if (stack_.size() > 0)
-        {
-            result.reserve(stack_.back().size());
-            for (const auto& p : stack_.back())
-            {
-                result.push_back(*(p.second));
-            }
-        }
-        return result;
-    }
-
-    Json get_normalized_paths() const
-    {
-        Json result = typename Json::array();
-        if (stack_.size() > 0)
-        {
-            result.reserve(stack_.back().size());
-            for (const auto& p : stack_.back())
-            {
-                result.push_back(p.first);
-            }
-        }
-        return result;
-    }
-
-    template <class T>
-    void replace(T&& new_value)
-    {
-        if (stack_.size() > 0)
-        {
-            for (size_t i = 0; i < stack_.back().size(); ++i)
-            {
-                *(stack_.back()[i].second) = new_value;
-            }
-        }
-    }
-
-    void evaluate(json_reference root, string_view_type path)
-    {
-        evaluate(root,path.data(),path.length());
-    }
-    void evaluate(json_reference root, const char_type* path)
-    {
-        evaluate(root,path,char_traits_type::length(path));
-    }
-
-    void evaluate(json_reference root, 
-                  const char_type* path, 
-                  size_t length)
+    std::vector<path_step<Json>> compile(const char_type* path, size_t length)
     {
         std::error_code ec;
-        evaluate(root, path, length, ec);
+        auto steps = compile(path, length, ec);
         if (ec)
         {
             throw parse_error(ec,line_,column_);
         }
+        return steps;
     }
 
-    void evaluate(json_reference root, 
-                  const char_type* path, 
-                  size_t length,
-                  std::error_code& ec)
+    std::vector<path_step<Json>> compile(const char_type* path, 
+                                         size_t length,
+                                         std::error_code& ec)
     {
         path_state pre_line_break_state = path_state::start;
 
@@ -485,6 +286,9 @@ public:
         state_ = path_state::start;
 
         recursive_descent_ = false;
+        has_root_ = false;
+        current_step_ = path_step<Json>();
+        steps_.clear();
 
         clear_index();
 
@@ -519,20 +323,13 @@ public:
                     break;
                 case '$':
                 case '@':
-                    {
-                        string_type s;
-                        s.push_back('$');
-                        node_set v;
-                        v.emplace_back(std::move(s),std::addressof(root));
-                        stack_.push_back(v);
-
-                        state_ = path_state::expect_dot_or_left_bracket;
-                    }
+                    has_root_ = true;
+                    state_ = path_state::expect_dot_or_left_bracket;
                     break;
                 default:
                     err_handler_->fatal_error(jsonpath_parser_errc::expected_root, *this);
                     ec = jsonpath_parser_errc::expected_root;
-                    return;
+                    return std::vector<path_step<Json>>();
                 };
                 ++p_;
                 ++column_;
@@ -557,10 +354,10 @@ public:
                 case '.':
                     err_handler_->fatal_error(jsonpath_parser_errc::expected_name, *this);
                     ec = jsonpath_parser_errc::expected_name;
-                    return;
+                    return std::vector<path_step<Json>>();
                 case '*':
-                    end_all();
-                    transfer_nodes();
+                    current_step_.all = true;
+                    end_step();
                     state_ = path_state::expect_dot_or_left_bracket;
                     ++p_;
                     ++column_;
@@ -590,7 +387,7 @@ public:
                 default:
                     err_handler_->fatal_error(jsonpath_parser_errc::expected_separator, *this);
                     ec = jsonpath_parser_errc::expected_separator;
-                    return;
+                    return std::vector<path_step<Json>>();
                 };
                 ++p_;
                 ++column_;
@@ -602,8 +399,7 @@ public:
                     state_ = path_state::left_bracket;
                     break;
                 case ']':
-                    apply_selectors();
-                    transfer_nodes();
+                    end_step();
                     state_ = path_state::expect_dot_or_left_bracket;
                     break;
                 case ' ':case '\t':
@@ -611,7 +407,7 @@ public:
                 default:
                     err_handler_->fatal_error(jsonpath_parser_errc::expected_right_bracket, *this);
                     ec = jsonpath_parser_errc::expected_right_bracket;
-                    return;
+                    return std::vector<path_step<Json>>();
                 }
                 ++p_;
                 ++column_;
@@ -624,24 +420,18 @@ public:
                     ++column_;
                     break;
                 case '(':
+                    if (!add_filter_selector(selector_kind::expr, ec))
                     {
-                        jsonpath_filter_parser<Json> parser(line_,column_);
-                        auto result = parser.parse(root, p_,end_input_,&p_);
-                        line_ = parser.line();
-                        column_ = parser.column();
-                        selectors_.push_back(std::make_shared<expr_selector>(result));
-                        state_ = path_state::expect_comma_or_right_bracket;
+                        return std::vector<path_step<Json>>();
                     }
+                    state_ = path_state::expect_comma_or_right_bracket;
                     break;
                 case '?':
+                    if (!add_filter_selector(selector_kind::filter, ec))
                     {
-                        jsonpath_filter_parser<Json> parser(line_,column_);
-                        auto result = parser.parse(root,p_,end_input_,&p_);
-                        line_ = parser.line();
-                        column_ = parser.column();
-                        selectors_.push_back(std::make_shared<filter_selector>(result));
-                        state_ = path_state::expect_comma_or_right_bracket;
+                        return std::vector<path_step<Json>>();
                     }
+                    state_ = path_state::expect_comma_or_right_bracket;
                     break;                   
                 case ':':
                     clear_index();
@@ -650,7 +440,7 @@ public:
                     ++column_;
                     break;
                 case '*':
-                    end_all();
+                    current_step_.all = true;
                     state_ = path_state::expect_comma_or_right_bracket;
                     ++p_;
                     ++column_;
@@ -682,20 +472,17 @@ public:
                     {
                         err_handler_->fatal_error(jsonpath_parser_errc::expected_index, *this);
                         ec = jsonpath_parser_errc::expected_index;
-                        return;
+                        return std::vector<path_step<Json>>();
                     }
                     state_ = path_state::left_bracket_end;
                     break;
                 case ',':
-                    selectors_.push_back(std::make_shared<name_selector>(buffer_,positive_start_));
-                    buffer_.clear();
+                    add_name_selector();
                     state_ = path_state::left_bracket;
                     break;
                 case ']':
-                    selectors_.push_back(std::make_shared<name_selector>(buffer_,positive_start_));
-                    buffer_.clear();
-                    apply_selectors();
-                    transfer_nodes();
+                    add_name_selector();
+                    end_step();
                     state_ = path_state::expect_dot_or_left_bracket;
                     break;
                 default:
@@ -722,13 +509,12 @@ public:
                     state_ = path_state::left_bracket_end2;
                     break;
                 case ',':
-                    selectors_.push_back(std::make_shared<array_slice_selector>(start_,positive_start_,end_,positive_end_,step_,positive_step_,undefined_end_));
+                    add_slice_selector();
                     state_ = path_state::left_bracket;
                     break;
                 case ']':
-                    selectors_.push_back(std::make_shared<array_slice_selector>(start_,positive_start_,end_,positive_end_,step_,positive_step_,undefined_end_));
-                    apply_selectors();
-                    transfer_nodes();
+                    add_slice_selector();
+                    end_step();
                     state_ = path_state::expect_dot_or_left_bracket;
                     break;
                 }
@@ -747,13 +533,12 @@ public:
                     end_ = end_*10 + static_cast<size_t>(*p_-'0');
                     break;
                 case ',':
-                    selectors_.push_back(std::make_shared<array_slice_selector>(start_,positive_start_,end_,positive_end_,step_,positive_step_,undefined_end_));
+                    add_slice_selector();
                     state_ = path_state::left_bracket;
                     break;
                 case ']':
-                    selectors_.push_back(std::make_shared<array_slice_selector>(start_,positive_start_,end_,positive_end_,step_,positive_step_,undefined_end_));
-                    apply_selectors();
-                    transfer_nodes();
+                    add_slice_selector();
+                    end_step();
                     state_ = path_state::expect_dot_or_left_bracket;
                     break;
                 }
@@ -772,13 +557,12 @@ public:
                     state_ = path_state::left_bracket_step2;
                     break;
                 case ',':
-                    selectors_.push_back(std::make_shared<array_slice_selector>(start_,positive_start_,end_,positive_end_,step_,positive_step_,undefined_end_));
+                    add_slice_selector();
                     state_ = path_state::left_bracket;
                     break;
                 case ']':
-                    selectors_.push_back(std::make_shared<array_slice_selector>(start_,positive_start_,end_,positive_end_,step_,positive_step_,undefined_end_));
-                    apply_selectors();
-                    transfer_nodes();
+                    add_slice_selector();
+                    end_step();
                     state_ = path_state::expect_dot_or_left_bracket;
                     break;
                 }
@@ -792,13 +576,12 @@ public:
                     step_ = step_*10 + static_cast<size_t>(*p_-'0');
                     break;
                 case ',':
-                    selectors_.push_back(std::make_shared<array_slice_selector>(start_,positive_start_,end_,positive_end_,step_,positive_step_,undefined_end_));
+                    add_slice_selector();
                     state_ = path_state::left_bracket;
                     break;
                 case ']':
-                    selectors_.push_back(std::make_shared<array_slice_selector>(start_,positive_start_,end_,positive_end_,step_,positive_step_,undefined_end_));
-                    apply_selectors();
-                    transfer_nodes();
+                    add_slice_selector();
+                    end_step();
                     state_ = path_state::expect_dot_or_left_bracket;
                     break;
                 }
@@ -809,30 +592,25 @@ public:
                 switch (*p_)
                 {
                 case '[':
-                    apply_unquoted_string(buffer_);
-                    transfer_nodes();
+                    end_name_step();
                     start_ = 0;
                     state_ = path_state::left_bracket;
                     break;
                 case '.':
-                    apply_unquoted_string(buffer_);
-                    transfer_nodes();
+                    end_name_step();
                     state_ = path_state::dot;
                     break;
                 case ' ':case '\t':
-                    apply_unquoted_string(buffer_);
-                    transfer_nodes();
+                    end_name_step();
                     state_ = path_state::expect_dot_or_left_bracket;
                     break;
                 case '\r':
-                    apply_unquoted_string(buffer_);
-                    transfer_nodes();
+                    end_name_step();
                     pre_line_break_state = path_state::expect_dot_or_left_bracket;
                     state_= path_state::cr;
                     break;
                 case '\n':
-                    apply_unquoted_string(buffer_);
-                    transfer_nodes();
+                    end_name_step();
                     pre_line_break_state = path_state::expect_dot_or_left_bracket;
                     state_= path_state::lf;
                     break;
@@ -847,8 +625,7 @@ public:
                 switch (*p_)
                 {
                 case '\'':
-                    selectors_.push_back(std::make_shared<name_selector>(buffer_,positive_start_));
-                    buffer_.clear();
+                    add_name_selector();
                     state_ = path_state::expect_comma_or_right_bracket;
                     break;
                 case '\\':
@@ -871,8 +648,7 @@ public:
                 switch (*p_)
                 {
                 case '\"':
-                    selectors_.push_back(std::make_shared<name_selector>(buffer_,positive_start_));
-                    buffer_.clear();
+                    add_name_selector();
                     state_ = path_state::expect_comma_or_right_bracket;
                     break;
                 case '\\':
@@ -900,16 +676,22 @@ public:
         switch (state_)
         {
         case path_state::unquoted_name: 
-            {
-                apply_unquoted_string(buffer_);
-                transfer_nodes();
-            }
+            end_name_step();
             break;
         default:
             break;
         }
+        if (!has_root_)
+        {
+            // An empty path selects nothing, as does a step without a name
+            // or selectors
+            steps_.clear();
+            steps_.emplace_back();
+        }
+        return std::move(steps_);
     }
 
+private:
     void clear_index()
     {
         buffer_.clear();
@@ -922,134 +704,586 @@ public:
         positive_step_ = true;
     }
 
-    void end_all()
+    void add_name_selector()
     {
-        for (size_t i = 0; i < stack_.back().size(); ++i)
-        {
-            const auto& path = stack_.back()[i].first;
-            json_pointer p = stack_.back()[i].second;
-
-            if (p->is_array())
-            {
-                for (auto it = p->array_range().begin(); it != p->array_range().end(); ++it)
-                {
-                    nodes_.emplace_back(PathCons()(path,it - p->array_range().begin()),std::addressof(*it));
-                }
-            }
-            else if (p->is_object())
-            {
-                for (auto it = p->object_range().begin(); it != p->object_range().end(); ++it)
-                {
-                    nodes_.emplace_back(PathCons()(path,it->key()),std::addressof(it->value()));
-                }
-            }
-
-        }
-        start_ = 0;
+        path_selector<Json> selector(selector_kind::name);
+        selector.name = buffer_;
+        selector.positive_start = positive_start_;
+        current_step_.selectors.push_back(std::move(selector));
+        buffer_.clear();
     }
 
-    void apply_unquoted_string(string_view_type name)
+    void add_slice_selector()
     {
-        if (name.length() > 0)
-        {
-            for (size_t i = 0; i < stack_.back().size(); ++i)
-            {
-                apply_unquoted_string(stack_.back()[i].first, *(stack_.back()[i].second), name);
-            }
-        }
-        buffer_.clear();
+        path_selector<Json> selector(selector_kind::slice);
+        selector.start = start_;
+        selector.positive_start = positive_start_;
+        selector.end = end_;
+        selector.positive_end = positive_end_;
+        selector.undefined_end = undefined_end_;
+        selector.step = step_;
+        selector.positive_step = positive_step_;
+        current_step_.selectors.push_back(std::move(selector));
     }
 
-    void apply_unquoted_string(const string_type& path, json_reference val, string_view_type name)
+    bool add_filter_selector(selector_kind kind, std::error_code& ec)
     {
-        if (val.is_object())
+        jsonpath_filter_parser<Json> parser(line_,column_);
+        path_selector<Json> selector(kind);
+        try
         {
-            if (val.count(name) > 0)
-            {
-                nodes_.emplace_back(PathCons()(path,name),std::addressof(val.at(name)));
-            }
-            if (recursive_descent_)
-            {
-                for (auto it = val.object_range().begin(); it != val.object_range().end(); ++it)
-                {
-                    if (it->value().is_object() || it->value().is_array())
-                    {
-                        apply_unquoted_string(path, it->value(), name);
-                    }
-                }
-            }
+            selector.expr = std::make_shared<const jsonpath_filter_expr<Json>>(parser.parse(p_,end_input_,&p_));
         }
-        else if (val.is_array())
+        catch (const parse_error& e)
         {
-            size_t pos = 0;
-            if (try_string_to_index(name.data(),name.size(),&pos, &positive_start_))
-            {
-                size_t index = positive_start_ ? pos : val.size() - pos;
-                if (index < val.size())
-                {
-                    nodes_.emplace_back(PathCons()(path,index),std::addressof(val[index]));
-                }
-            }
-            else if (name == length_literal() && val.size() > 0)
-            {
-                auto temp = std::make_shared<Json>(val.size());
-                temp_json_values_.push_back(temp);
-                nodes_.emplace_back(PathCons()(path,name),temp.get());
-            }
-            if (recursive_descent_)
-            {
-                for (auto it = val.array_range().begin(); it != val.array_range().end(); ++it)
-                {
-                    if (it->is_object() || it->is_array())
-                    {
-                        apply_unquoted_string(path, *it, name);
-                    }
-                }
-            }
+            ec = e.code();
+            line_ = e.line_number();
+            column_ = e.column_number();
+            return false;
         }
-        else if (val.is_string())
-        {
-            string_view_type sv = val.as_string_view();
-            size_t pos = 0;
-            if (try_string_to_index(name.data(),name.size(),&pos, &positive_start_))
+        line_ = parser.line();
+        column_ = parser.column();
+        current_step_.selectors.push_back(std::move(selector));
+        return true;
+    }
+
+    void end_name_step()
+    {
+        current_step_.name = buffer_;
+        buffer_.clear();
+        end_step();
+    }
+
+    void end_step()
+    {
+        current_step_.recursive = recursive_descent_;
+        steps_.push_back(std::move(current_step_));
+        current_step_ = path_step<Json>();
+        recursive_descent_ = false;
+    }
+
+    size_t do_line_number() const override
+    {
+        return line_;
+    }
+
+    size_t do_column_number() const override
+    {
+        return column_;
+    }
+};
+
+// Applies compiled steps to a JSON value
+template<class Json,
+         class JsonReference=const Json&,
+         class JsonPointer=const Json*,
+         class PathCons=PathConstructor<Json>>
+class jsonpath_evaluator
+{
+private:
+    typedef typename Json::char_type char_type;
+    typedef typename Json::char_traits_type char_traits_type;
+    typedef std::basic_string<char_type,char_traits_type> string_type;
+    typedef typename Json::string_view_type string_view_type;
+    typedef JsonReference json_reference;
+    typedef JsonPointer json_pointer;
+    typedef typename PathCons::path_type path_type;
+    typedef std::pair<path_type,json_pointer> node_type;
+    typedef std::vector<node_type> node_set;
+    typedef std::map<const jsonpath_filter_expr<Json>*,jsonpath_filter_expr<Json>> filter_map;
+
+    static string_view_type length_literal() 
+    {
+        static const char_type data[] = {'l','e','n','g','t','h'};
+        return string_view_type{data,sizeof(data)/sizeof(char_type)};
+    }
+
+    json_pointer root_;
+    node_set nodes_;
+    node_set current_;
+    std::deque<Json> temp_values_;
+    std::vector<std::deque<Json>> part_temp_values_;
+    std::shared_ptr<const filter_map> bound_filters_;
+    size_t thread_count_;
+    size_t parallel_threshold_;
+
+public:
+    jsonpath_evaluator()
+        : root_(nullptr), thread_count_(1), parallel_threshold_(evaluation_options::default_parallel_threshold)
+    {
+    }
+
+    explicit jsonpath_evaluator(const evaluation_options& options)
+        : root_(nullptr), thread_count_(options.thread_count()), parallel_threshold_(options.parallel_threshold())
+    {
+        if (thread_count_ == 0)
+        {
+            thread_count_ = std::thread::hardware_concurrency();
+        }
+    }
+
+    Json get_values() const
+    {
+        Json result = typename Json::array();
+
+        result.reserve(current_.size());
+        for (const auto& p : current_)
+        {
+            result.push_back(*(p.second));
+        }
+        return result;
+    }
+
+    Json get_normalized_paths() const
+    {
+        Json result = typename Json::array();
+        result.reserve(current_.size());
+        for (const auto& p : current_)
+        {
+            result.push_back(p.first);
+        }
+        return result;
+    }
+
+    template <class T>
+    void replace(T&& new_value)
+    {
+        for (const auto& p : current_)
+        {
+            *(p.second) = new_value;
+        }
+    }
+
+    // Calls f with each selected value, without copying it
+    template <class F>
+    void for_each_value(F f) const
+    {
+        for (const auto& p : current_)
+        {
+            f(*(p.second));
+        }
+    }
+
+    void evaluate(json_reference root, string_view_type path)
+    {
+        evaluate(root,path.data(),path.length());
+    }
+    void evaluate(json_reference root, const char_type* path)
+    {
+        evaluate(root,path,char_traits_type::length(path));
+    }
+
+    void evaluate(json_reference root, 
+                  const char_type* path, 
+                  size_t length)
+    {
+        jsonpath_compiler<Json> compiler;
+        evaluate(root, compiler.compile(path, length));
+    }
+
+    void evaluate(json_reference root, 
+                  const char_type* path, 
+                  size_t length,
+                  std::error_code& ec)
+    {
+        jsonpath_compiler<Json> compiler;
+        auto steps = compiler.compile(path, length, ec);
+        if (!ec)
+        {
+            evaluate(root, steps);
+        }
+    }
+
+    void evaluate(json_reference root, const std::vector<path_step<Json>>& steps)
+    {
+        root_ = std::addressof(root);
+        nodes_.clear();
+        current_.clear();
+        temp_values_.clear();
+        part_temp_values_.clear();
+        bind_filters(steps);
+
+        current_.emplace_back(PathCons().root(),std::addressof(root));
+
+        for (size_t i = 0; i < steps.size(); ++i)
+        {
+            if (thread_count_ > 1 && evaluate_parallel(steps, i))
             {
-                auto sequence = unicons::sequence_at(sv.data(), sv.data() + sv.size(), pos);
-                if (sequence.length() > 0)
+                break;
+            }
+            apply_step(steps[i]);
+        }
+    }
+
+private:
+    void apply_steps(const std::vector<path_step<Json>>& steps, size_t first)
+    {
+        for (size_t i = first; i < steps.size(); ++i)
+        {
+            apply_step(steps[i]);
+        }
+    }
+
+    static bool is_simple(const path_step<Json>& step)
+    {
+        return (step.all ? 1 : 0) + (step.name.length() > 0 ? 1 : 0) + (step.selectors.size() > 0 ? 1 : 0) <= 1;
+    }
+
+    // Whether a step's nodes for an array are the concatenation of nodes
+    // found from each element in turn
+    static bool is_elementwise(const path_step<Json>& step)
+    {
+        if (step.all)
+        {
+            return true;
+        }
+        if (step.recursive)
+        {
+            return true;
+        }
+        return step.selectors.size() == 1 && step.selectors[0].kind == selector_kind::filter;
+    }
+
+    // Steps from first on that apply to each node on its own can be applied 
+    // to parts of the nodes selected so far, or of a large array, on 
+    // different threads. The parts' nodes are joined in order, so that the 
+    // result is the same as with serial evaluation.
+    bool evaluate_parallel(const std::vector<path_step<Json>>& steps, size_t first)
+    {
+        for (size_t i = first; i < steps.size(); ++i)
+        {
+            if (!is_simple(steps[i]))
+            {
+                return false;
+            }
+        }
+
+        const node_set& current = current_;
+        if (current.size() >= parallel_threshold_)
+        {
+            size_t count = partition_count(current.size());
+            std::vector<jsonpath_evaluator> parts(count);
+            run_parallel(parts, [&](size_t p, jsonpath_evaluator& part)
+            {
+                size_t begin = current.size()*p/count;
+                size_t end = current.size()*(p+1)/count;
+                part.root_ = root_;
+                part.bound_filters_ = bound_filters_;
+                part.current_.assign(current.begin()+begin, current.begin()+end);
+                part.apply_steps(steps, first);
+            });
+            join(parts);
+            return true;
+        }
+
+        const path_step<Json>& step = steps[first];
+        if (!is_elementwise(step))
+        {
+            return false;
+        }
+        bool has_large_array = false;
+        for (const auto& node : current)
+        {
+            if (node.second->is_array() && node.second->size() >= parallel_threshold_)
+            {
+                has_large_array = true;
+                break;
+            }
+        }
+        if (!has_large_array)
+        {
+            return false;
+        }
+
+        std::vector<jsonpath_evaluator> parts;
+        for (const auto& node : current)
+        {
+            if (node.second->is_array() && node.second->size() >= parallel_threshold_)
+            {
+                size_t size = node.second->size();
+                size_t count = partition_count(size);
+                size_t offset = parts.size();
+                parts.resize(offset + count);
+                run_parallel(parts, offset, [&](size_t p, jsonpath_evaluator& part)
                 {
-                    auto temp = std::make_shared<Json>(sequence.begin(),sequence.length());
-                    temp_json_values_.push_back(temp);
-                    nodes_.emplace_back(PathCons()(path,pos),temp.get());
+                    size_t begin = size*p/count;
+                    size_t end = size*(p+1)/count;
+                    part.root_ = root_;
+                    part.bound_filters_ = bound_filters_;
+                    if (p == 0)
+                    {
+                        part.select_self(step, node.first, *(node.second));
+                    }
+                    for (size_t j = begin; j < end; ++j)
+                    {
+                        part.select_element(step, node.first, (*(node.second))[j], j);
+                    }
+                    part.transfer_nodes();
+                    part.apply_steps(steps, first+1);
+                });
+            }
+            else
+            {
+                parts.emplace_back();
+                jsonpath_evaluator& part = parts.back();
+                part.root_ = root_;
+                part.bound_filters_ = bound_filters_;
+                part.current_.push_back(node);
+                part.apply_steps(steps, first);
+            }
+        }
+        join(parts);
+        return true;
+    }
+
+    size_t partition_count(size_t size) const
+    {
+        size_t count = thread_count_;
+        size_t min_size = parallel_threshold_/thread_count_ > 0 ? parallel_threshold_/thread_count_ : 1;
+        if (size/min_size < count)
+        {
+            count = size/min_size > 0 ? size/min_size : 1;
+        }
+        return count;
+    }
+
+    template <class F>
+    void run_parallel(std::vector<jsonpath_evaluator>& parts, F f)
+    {
+        run_parallel(parts, 0, f);
+    }
+
+    // Runs f for parts from offset on, the first on the calling thread
+    template <class F>
+    void run_parallel(std::vector<jsonpath_evaluator>& parts, size_t offset, F f)
+    {
+        size_t count = parts.size() - offset;
+        std::vector<std::exception_ptr> errors(count);
+        std::vector<std::thread> threads;
+        threads.reserve(count);
+        for (size_t p = 1; p < count; ++p)
+        {
+            threads.emplace_back([&,p]()
+            {
+                try
+                {
+                    f(p, parts[offset+p]);
+                }
+                catch (...)
+                {
+                    errors[p] = std::current_exception();
                 }
+            });
+        }
+        try
+        {
+            f(0, parts[offset]);
+        }
+        catch (...)
+        {
+            errors[0] = std::current_exception();
+        }
+        for (auto& t : threads)
+        {
+            t.join();
+        }
+        for (const auto& e : errors)
+        {
+            if (e)
+            {
+                std::rethrow_exception(e);
             }
-            else if (name == length_literal() && sv.size() > 0)
+        }
+    }
+
+    void join(std::vector<jsonpath_evaluator>& parts)
+    {
+        node_set result;
+        size_t size = 0;
+        for (const auto& part : parts)
+        {
+            size += part.current_.size();
+        }
+        result.reserve(size);
+        for (auto& part : parts)
+        {
+            for (auto& node : part.current_)
             {
-                size_t count = unicons::u32_length(sv.begin(),sv.end());
-                auto temp = std::make_shared<Json>(count);
-                temp_json_values_.push_back(temp);
-                nodes_.emplace_back(PathCons()(path,name),temp.get());
+                result.push_back(std::move(node));
+            }
+            // Moving a deque keeps its elements where they are
+            part_temp_values_.push_back(std::move(part.temp_values_));
+        }
+        current_.swap(result);
+    }
+
+    // The nodes that an elementwise step selects from an array itself,
+    // before any found from its elements
+    void select_self(const path_step<Json>& step, const path_type& path, json_reference val)
+    {
+        if (step.all)
+        {
+            return;
+        }
+        if (step.recursive)
+        {
+            if (step.name.length() > 0)
+            {
+                apply_unquoted_string(path, val, step.name, false);
+            }
+            for (const auto& selector : step.selectors)
+            {
+                select(selector, path, val);
+            }
+        }
+    }
+
+    // The nodes that an elementwise step selects from element j of an array
+    void select_element(const path_step<Json>& step, const path_type& path, json_reference val, size_t j)
+    {
+        if (step.all)
+        {
+            nodes_.emplace_back(PathCons()(path,j),std::addressof(val));
+        }
+        else if (step.recursive)
+        {
+            if (val.is_object() || val.is_array())
+            {
+                if (step.name.length() > 0)
+                {
+                    apply_unquoted_string(path, val, step.name, true);
+                }
+                else
+                {
+                    apply_selectors(path, val, step);
+                }
+            }
+        }
+        else if (filter(step.selectors[0]).exists(val, *root_))
+        {
+            nodes_.emplace_back(PathCons()(path,j),std::addressof(val));
+        }
+    }
+
+    void apply_step(const path_step<Json>& step)
+    {
+        const node_set& current = current_;
+        if (step.all)
+        {
+            for (const auto& node : current)
+            {
+                select_all(node.first, *(node.second));
             }
         }
+        if (step.name.length() > 0)
+        {
+            for (const auto& node : current)
+            {
+                apply_unquoted_string(node.first, *(node.second), step.name, step.recursive);
+            }
+        }
+        if (step.selectors.size() > 0)
+        {
+            for (const auto& node : current)
+            {
+                apply_selectors(node.first, *(node.second), step);
+            }
+        }
+        transfer_nodes();
     }
 
-    void apply_selectors()
+    void select_all(const path_type& path, json_reference val)
     {
-        if (selectors_.size() > 0)
+        if (val.is_array())
         {
-            for (size_t i = 0; i < stack_.back().size(); ++i)
+            for (auto it = val.array_range().begin(); it != val.array_range().end(); ++it)
             {
-                apply_selectors(stack_.back()[i].first, *(stack_.back()[i].second));
+                nodes_.emplace_back(PathCons()(path,it - val.array_range().begin()),std::addressof(*it));
+            }
+        }
+        else if (val.is_object())
+        {
+            for (auto it = val.object_range().begin(); it != val.object_range().end(); ++it)
+            {
+                nodes_.emplace_back(PathCons()(path,it->key()),std::addressof(it->value()));
             }
-            selectors_.clear();
         }
     }
 
-    void apply_selectors(const string_type& path, json_reference val)
+    void apply_unquoted_string(const path_type& path, json_reference val, string_view_type name, bool recursive)
     {
-        for (const auto& selector : selectors_)
+        if (val.is_object())
+        {
+            if (val.count(name) > 0)
+            {
+                nodes_.emplace_back(PathCons()(path,name),std::addressof(val.at(name)));
+            }
+            if (recursive)
+            {
+                for (auto it = val.object_range().begin(); it != val.object_range().end(); ++it)
+                {
+                    if (it->value().is_object() || it->value().is_array())
+                    {
+                        apply_unquoted_string(path, it->value(), name, recursive);
+                    }
+                }
+            }
+        }
+        else if (val.is_array())
         {
-            selector->select(path, val, nodes_, temp_json_values_);
+            size_t pos = 0;
+            bool positive = true;
+            if (try_string_to_index(name.data(),name.size(),&pos, &positive))
+            {
+                size_t index = positive ? pos : val.size() - pos;
+                if (index < val.size())
+                {
+                    nodes_.emplace_back(PathCons()(path,index),std::addressof(val[index]));
+                }
+            }
+            else if (name == length_literal() && val.size() > 0)
+            {
+                nodes_.emplace_back(PathCons()(path,name),make_temp(val.size()));
+            }
+            if (recursive)
+            {
+                for (auto it = val.array_range().begin(); it != val.array_range().end(); ++it)
+                {
+                    if (it->is_object() || it->is_array())
+                    {
+                        apply_unquoted_string(path, *it, name, recursive);
+                    }
+                }
+            }
         }
-        if (recursive_descent_)
+        else if (val.is_string())
+        {
+            string_view_type sv = val.as_string_view();
+            size_t pos = 0;
+            bool positive = true;
+            if (try_string_to_index(name.data(),name.size(),&pos, &positive))
+            {
+                auto sequence = unicons::sequence_at(sv.data(), sv.data() + sv.size(), pos);
+                if (sequence.length() > 0)
+                {
+                    nodes_.emplace_back(PathCons()(path,pos),make_temp(sequence.begin(),sequence.length()));
+                }
+            }
+            else if (name == length_literal() && sv.size() > 0)
+            {
+                size_t count = unicons::u32_length(sv.begin(),sv.end());
+                nodes_.emplace_back(PathCons()(path,name),make_temp(count));
+            }
+        }
+    }
+
+    void apply_selectors(const path_type& path, json_reference val, const path_step<Json>& step)
+    {
+        for (const auto& selector : step.selectors)
+        {
+            select(selector, path, val);
+        }
+        if (step.recursive)
         {
             if (val.is_object())
             {
@@ -1057,7 +1291,7 @@ public:
                 {
                     if (it->value().is_object() || it->value().is_array())
                     {
-                        apply_selectors(path,it->value());
+                        apply_selectors(path,it->value(),step);
                     }
                 }
             }
@@ -1067,32 +1301,328 @@ public:
                 {
                     if (it->is_object() || it->is_array())
                     {
-                        apply_selectors(path, *it);
+                        apply_selectors(path, *it, step);
+                    }
+                }
+            }
+        }
+    }
+
+    // Filters with aggregate arguments like max($[*].v) are bound to the 
+    // root once, rather than evaluating the arguments for every node
+    void bind_filters(const std::vector<path_step<Json>>& steps)
+    {
+        bound_filters_.reset();
+        std::shared_ptr<filter_map> filters;
+        for (const auto& step : steps)
+        {
+            for (const auto& selector : step.selectors)
+            {
+                if (selector.expr && selector.expr->depends_on_root())
+                {
+                    if (!filters)
+                    {
+                        filters = std::make_shared<filter_map>();
                     }
+                    filters->emplace(selector.expr.get(), selector.expr->bind_root(*root_));
+                }
+            }
+        }
+        bound_filters_ = filters;
+    }
+
+    const jsonpath_filter_expr<Json>& filter(const path_selector<Json>& selector) const
+    {
+        if (bound_filters_)
+        {
+            auto it = bound_filters_->find(selector.expr.get());
+            if (it != bound_filters_->end())
+            {
+                return it->second;
+            }
+        }
+        return *selector.expr;
+    }
+
+    void select(const path_selector<Json>& selector, const path_type& path, json_reference val)
+    {
+        switch (selector.kind)
+        {
+        case selector_kind::name:
+            select_name(path, val, selector.name, selector.positive_start);
+            break;
+        case selector_kind::slice:
+            if (selector.positive_step)
+            {
+                end_array_slice1(selector, path, val);
+            }
+            else
+            {
+                end_array_slice2(selector, path, val);
+            }
+            break;
+        case selector_kind::expr:
+            {
+                auto index = filter(selector).eval(val, *root_);
+                if (index.template is<size_t>())
+                {
+                    size_t start = index. template as<size_t>();
+                    if (val.is_array() && start < val.size())
+                    {
+                        nodes_.emplace_back(PathCons()(path,start),std::addressof(val[start]));
+                    }
+                }
+                else if (index.is_string())
+                {
+                    select_name(path, val, index.as_string_view(), true);
+                }
+            }
+            break;
+        case selector_kind::filter:
+            if (val.is_array())
+            {
+                for (size_t i = 0; i < val.size(); ++i)
+                {
+                    if (filter(selector).exists(val[i], *root_))
+                    {
+                        nodes_.emplace_back(PathCons()(path,i),std::addressof(val[i]));
+                    }
+                }
+            }
+            else if (val.is_object())
+            {
+                if (filter(selector).exists(val, *root_))
+                {
+                    nodes_.emplace_back(path, std::addressof(val));
+                }
+            }
+            break;
+        }
+    }
+
+    void select_name(const path_type& path, json_reference val, string_view_type name, bool positive_start)
+    {
+        if (val.is_object() && val.count(name) > 0)
+        {
+            nodes_.emplace_back(PathCons()(path,name),std::addressof(val.at(name)));
+        }
+        else if (val.is_array())
+        {
+            size_t pos = 0;
+            if (try_string_to_index(name.data(), name.size(), &pos, &positive_start))
+            {
+                size_t index = positive_start ? pos : val.size() - pos;
+                if (index < val.size())
+                {
+                    nodes_.emplace_back(PathCons()(path,index),std::addressof(val[index]));
+                }
+            }
+            else if (name == length_literal() && val.size() > 0)
+            {
+                nodes_.emplace_back(PathCons()(path,name),make_temp(val.size()));
+            }
+        }
+        else if (val.is_string())
+        {
+            size_t pos = 0;
+            string_view_type sv = val.as_string_view();
+            if (try_string_to_index(name.data(), name.size(), &pos, &positive_start))
+            {
+                size_t index = positive_start ? pos : sv.size() - pos;
+                auto sequence = unicons::sequence_at(sv.data(), sv.data() + sv.size(), index);
+                if (sequence.length() > 0)
+                {
+                    nodes_.emplace_back(PathCons()(path,index),make_temp(sequence.begin(),sequence.length()));
+                }
+            }
+            else if (name == length_literal() && sv.size() > 0)
+            {
+                size_t count = unicons::u32_length(sv.begin(),sv.end());
+                nodes_.emplace_back(PathCons()(path,name),make_temp(count));
+            }
+        }
+    }
+
+    void end_array_slice1(const path_selector<Json>& selector, const path_type& path, json_reference val)
+    {
+        if (val.is_array())
+        {
+            size_t start = selector.positive_start ? selector.start : val.size() - selector.start;
+            size_t end;
+            if (!selector.undefined_end)
+            {
+                end = selector.positive_end ? selector.end : val.size() - selector.end;
+            }
+            else
+            {
+                end = val.size();
+            }
+            for (size_t j = start; j < end; j += selector.step)
+            {
+                if (j < val.size())
+                {
+                    nodes_.emplace_back(PathCons()(path,j),std::addressof(val[j]));
                 }
             }
         }
     }
 
+    void end_array_slice2(const path_selector<Json>& selector, const path_type& path, json_reference val)
+    {
+        if (val.is_array())
+        {
+            size_t start = selector.positive_start ? selector.start : val.size() - selector.start;
+            size_t end;
+            if (!selector.undefined_end)
+            {
+                end = selector.positive_end ? selector.end : val.size() - selector.end;
+            }
+            else
+            {
+                end = val.size();
+            }
+
+            size_t j = end + selector.step - 1;
+            while (j > (start+selector.step-1))
+            {
+                j -= selector.step;
+                if (j < val.size())
+                {
+                    nodes_.emplace_back(PathCons()(path,j),std::addressof(val[j]));
+                }
+            }
+        }
+    }
+
+    // Computed values such as length are kept until the next evaluation
+    template <class... Args>
+    json_pointer make_temp(Args&&... args)
+    {
+        temp_values_.emplace_back(std::forward<Args>(args)...);
+        return std::addressof(temp_values_.back());
+    }
+
     void transfer_nodes()
     {
-        stack_.push_back(nodes_);
+        current_.swap(nodes_);
         nodes_.clear();
-        recursive_descent_ = false;
     }
+};
 
-    size_t do_line_number() const override
+}
+
+// A compiled JSONPath expression. It is immutable and can be evaluated
+// against any number of JSON values, by any number of threads at once.
+// Copies share the compiled steps.
+template <class Json>
+class basic_json_query_handler;
+
+template <class Json>
+class jsonpath_query_set;
+
+template <class Json>
+class jsonpath_expression
+{
+    friend class basic_json_query_handler<Json>;
+    friend class jsonpath_query_set<Json>;
+
+    std::shared_ptr<const std::vector<detail::path_step<Json>>> steps_;
+public:
+    explicit jsonpath_expression(std::vector<detail::path_step<Json>>&& steps)
+        : steps_(std::make_shared<const std::vector<detail::path_step<Json>>>(std::move(steps)))
     {
-        return line_;
     }
 
-    size_t do_column_number() const override
+    Json evaluate(const Json& root, result_type result_t = result_type::value) const
     {
-        return column_;
+        return evaluate(root, result_t, evaluation_options());
     }
 
+    Json evaluate(const Json& root, result_type result_t, const evaluation_options& options) const
+    {
+        if (result_t == result_type::value)
+        {
+            detail::jsonpath_evaluator<Json,const Json&,const Json*,detail::VoidPathConstructor<Json>> evaluator(options);
+            evaluator.evaluate(root,*steps_);
+            return evaluator.get_values();
+        }
+        else
+        {
+            detail::jsonpath_evaluator<Json,const Json&,const Json*,detail::PathConstructor<Json>> evaluator(options);
+            evaluator.evaluate(root,*steps_);
+            return evaluator.get_normalized_paths();
+        }
+    }
+
+    // Calls f with a const reference to each selected value, in the same
+    // order as evaluate, without copying the values into an array
+    template <class F>
+    void evaluate(const Json& root, F f) const
+    {
+        detail::jsonpath_evaluator<Json,const Json&,const Json*,detail::VoidPathConstructor<Json>> evaluator;
+        evaluator.evaluate(root,*steps_);
+        evaluator.for_each_value(f);
+    }
+
+    template <class T>
+    void replace(Json& root, T&& new_value) const
+    {
+        detail::jsonpath_evaluator<Json,Json&,Json*,detail::VoidPathConstructor<Json>> evaluator;
+        evaluator.evaluate(root,*steps_);
+        evaluator.replace(std::forward<T>(new_value));
+    }
 };
 
+template <class Json>
+jsonpath_expression<Json> compile(typename Json::string_view_type path)
+{
+    detail::jsonpath_compiler<Json> compiler;
+    return jsonpath_expression<Json>(compiler.compile(path.data(),path.length()));
+}
+
+template <class Json>
+jsonpath_expression<Json> compile(typename Json::string_view_type path, std::error_code& ec)
+{
+    detail::jsonpath_compiler<Json> compiler;
+    return jsonpath_expression<Json>(compiler.compile(path.data(),path.length(),ec));
+}
+
+template<class Json>
+Json json_query(const Json& root, const jsonpath_expression<Json>& expr, result_type result_t = result_type::value)
+{
+    return expr.evaluate(root, result_t);
+}
+
+template<class Json>
+Json json_query(const Json& root, const jsonpath_expression<Json>& expr, result_type result_t, const evaluation_options& options)
+{
+    return expr.evaluate(root, result_t, options);
+}
+
+template<class Json, class F>
+void json_query(const Json& root, typename Json::string_view_type path, F callback)
+{
+    detail::jsonpath_evaluator<Json,const Json&,const Json*,detail::VoidPathConstructor<Json>> evaluator;
+    evaluator.evaluate(root,path.data(),path.length());
+    evaluator.for_each_value(callback);
+}
+
+template<class Json, class F>
+void json_query(const Json& root, const jsonpath_expression<Json>& expr, F callback)
+{
+    expr.evaluate(root, callback);
+}
+
+template<class Json>
+Json json_query(const Json& root, typename Json::string_view_type path, result_type result_t, const evaluation_options& options)
+{
+    return compile<Json>(path).evaluate(root, result_t, options);
+}
+
+template<class Json, class T>
+void json_replace(Json& root, const jsonpath_expression<Json>& expr, T&& new_value)
+{
+    expr.replace(root, std::forward<T>(new_value));
 }
 
 }}
@@ -0,0 +1,383 @@
+// Copyright 2017 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_JSONPATH_JSONQUERYHANDLER_HPP
+#define JSONCONS_JSONPATH_JSONQUERYHANDLER_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <functional>
+#include <stdexcept>
+#include <limits>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_input_handler.hpp>
+#include <jsoncons/json_decoder.hpp>
+#include "json_query.hpp"
+#include "jsonpath_query_set.hpp"
+
+namespace jsoncons { namespace jsonpath {
+
+// Evaluates JSONPath expressions against the events of a parser, without
+// building the whole document. Only the selected values are built, each is
+// passed to the callback when its last event has been seen.
+//
+// Supports names, non-negative indexes, slices with non-negative bounds and
+// step, the wildcard and recursive descent. Filters, script expressions and
+// anything that depends on the length of an array are rejected.
+
+template <class Json>
+class basic_json_query_handler : public basic_json_input_handler<typename Json::char_type>
+{
+public:
+    typedef typename Json::char_type char_type;
+    typedef typename Json::string_type string_type;
+    typedef typename Json::string_view_type string_view_type;
+    typedef std::function<void(const string_type& path, Json&& value)> callback_type;
+    typedef std::function<void(size_t index, const string_type& path, Json&& value)> query_set_callback_type;
+
+private:
+    // states are the trie nodes whose children apply to the members or 
+    // elements of a container, carried the recursive nodes that apply to 
+    // the members or elements of a descendant of their parent node.
+    struct frame
+    {
+        bool is_object;
+        size_t count;
+        string_type name;
+        std::vector<size_t> states;
+        std::vector<size_t> carried;
+
+        frame()
+            : is_object(false), count(0)
+        {
+        }
+
+        bool is_live() const
+        {
+            return !states.empty() || !carried.empty();
+        }
+    };
+
+    struct capture
+    {
+        size_t depth;
+        string_type path;
+        std::vector<size_t> queries;
+    };
+
+    detail::selector_trie<Json> trie_;
+    query_set_callback_type callback_;
+    std::vector<frame> frames_;
+    size_t top_;
+    std::vector<capture> captures_;
+    std::vector<std::unique_ptr<json_decoder<Json>>> decoders_;
+    std::vector<size_t> selected_;
+
+public:
+    basic_json_query_handler(const jsonpath_expression<Json>& expr, callback_type callback)
+        : top_(0)
+    {
+        init(*(expr.steps_));
+        callback_ = [callback](size_t, const string_type& path, Json&& value){callback(path, std::move(value));};
+    }
+
+    basic_json_query_handler(string_view_type path, callback_type callback)
+        : top_(0)
+    {
+        detail::jsonpath_compiler<Json> compiler;
+        init(compiler.compile(path.data(),path.length()));
+        callback_ = [callback](size_t, const string_type& path, Json&& value){callback(path, std::move(value));};
+    }
+
+    // The callback receives the index of each expression in the set that 
+    // selects a value
+    basic_json_query_handler(const jsonpath_query_set<Json>& queries, query_set_callback_type callback)
+        : trie_(queries.trie_), callback_(callback), top_(0)
+    {
+        if (!queries.fallback_.empty())
+        {
+            JSONCONS_THROW_EXCEPTION(std::invalid_argument,"Filters, expressions and length are not supported when streaming");
+        }
+        check_streamable();
+    }
+
+private:
+    void init(const std::vector<detail::path_step<Json>>& steps)
+    {
+        std::vector<detail::step_selector<Json>> selectors;
+        if (!detail::make_step_selectors(steps, selectors))
+        {
+            JSONCONS_THROW_EXCEPTION(std::invalid_argument,"Filters, expressions and length are not supported when streaming");
+        }
+        trie_.add(selectors, 0);
+        check_streamable();
+    }
+
+    void check_streamable() const
+    {
+        if (trie_.needs_size())
+        {
+            JSONCONS_THROW_EXCEPTION(std::invalid_argument,"Negative indexes and slices are not supported when streaming");
+        }
+    }
+
+    // The size of an array isn't known until it ends, slices without an end
+    // run to the largest index
+    bool selects(const detail::step_selector<Json>& step, const frame& parent, size_t index, bool direct) const
+    {
+        return parent.is_object ? step.selects_member(string_view_type(parent.name), direct)
+                                : step.selects_element(index, (std::numeric_limits<size_t>::max)(), direct);
+    }
+
+    // Works out the states of a value that is about to start and begins a
+    // capture if the value is selected
+    void begin_value(bool is_container, bool is_object)
+    {
+        if (frames_.size() <= top_)
+        {
+            frames_.emplace_back();
+        }
+        frame& child = frames_[top_];
+        child.is_object = is_object;
+        child.count = 0;
+        child.states.clear();
+        child.carried.clear();
+        selected_.clear();
+
+        if (top_ == 0)
+        {
+            reach(child, 0, is_container);
+        }
+        else
+        {
+            frame& parent = frames_[top_-1];
+            size_t index = parent.count++;
+            if (!parent.is_live())
+            {
+                return;
+            }
+            for (size_t s : parent.states)
+            {
+                for (size_t n : trie_[s].children)
+                {
+                    if (selects(trie_[n].step, parent, index, true))
+                    {
+                        reach(child, n, is_container);
+                    }
+                    if (trie_[n].step.recursive && is_container)
+                    {
+                        detail::add_unique(child.carried, n);
+                    }
+                }
+            }
+            for (size_t n : parent.carried)
+            {
+                if (selects(trie_[n].step, parent, index, false))
+                {
+                    reach(child, n, is_container);
+                }
+                if (is_container)
+                {
+                    detail::add_unique(child.carried, n);
+                }
+            }
+        }
+        if (!selected_.empty())
+        {
+            begin_capture();
+        }
+    }
+
+    void reach(frame& child, size_t n, bool is_container)
+    {
+        const auto& node = trie_[n];
+        for (size_t q : node.queries)
+        {
+            detail::add_unique(selected_, q);
+        }
+        if (!node.children.empty() && is_container)
+        {
+            detail::add_unique(child.states, n);
+        }
+    }
+
+    void begin_capture()
+    {
+        detail::PathConstructor<Json> path_cons;
+        string_type path;
+        path.push_back('$');
+        for (size_t i = 0; i < top_; ++i)
+        {
+            if (frames_[i].is_object)
+            {
+                path = path_cons(path, string_view_type(frames_[i].name));
+            }
+            else
+            {
+                path = path_cons(path, frames_[i].count-1);
+            }
+        }
+
+        if (decoders_.size() <= captures_.size())
+        {
+            decoders_.emplace_back(new json_decoder<Json>());
+        }
+        capture c;
+        c.depth = top_;
+        c.path = std::move(path);
+        c.queries = selected_;
+        captures_.push_back(std::move(c));
+        decoders_[captures_.size()-1]->begin_json();
+    }
+
+    void end_value()
+    {
+        while (!captures_.empty() && captures_.back().depth == top_)
+        {
+            json_decoder<Json>& decoder = *decoders_[captures_.size()-1];
+            decoder.end_json();
+            capture c = std::move(captures_.back());
+            captures_.pop_back();
+            Json value = decoder.get_result();
+            for (size_t i = 0; i+1 < c.queries.size(); ++i)
+            {
+                callback_(c.queries[i], c.path, Json(value));
+            }
+            callback_(c.queries.back(), c.path, std::move(value));
+        }
+    }
+
+    void do_begin_json() override
+    {
+        top_ = 0;
+        captures_.clear();
+    }
+
+    void do_end_json() override
+    {
+    }
+
+    void do_begin_object(const parsing_context& context) override
+    {
+        begin_value(true, true);
+        for (size_t i = 0; i < captures_.size(); ++i)
+        {
+            decoders_[i]->begin_object(context);
+        }
+        ++top_;
+    }
+
+    void do_end_object(const parsing_context& context) override
+    {
+        for (size_t i = 0; i < captures_.size(); ++i)
+        {
+            decoders_[i]->end_object(context);
+        }
+        --top_;
+        end_value();
+    }
+
+    void do_begin_array(const parsing_context& context) override
+    {
+        begin_value(true, false);
+        for (size_t i = 0; i < captures_.size(); ++i)
+        {
+            decoders_[i]->begin_array(context);
+        }
+        ++top_;
+    }
+
+    void do_end_array(const parsing_context& context) override
+    {
+        for (size_t i = 0; i < captures_.size(); ++i)
+        {
+            decoders_[i]->end_array(context);
+        }
+        --top_;
+        end_value();
+    }
+
+    void do_name(string_view_type name, const parsing_context& context) override
+    {
+        frame& parent = frames_[top_-1];
+        if (parent.is_live())
+        {
+            parent.name.assign(name.data(), name.length());
+        }
+        for (size_t i = 0; i < captures_.size(); ++i)
+        {
+            decoders_[i]->name(name, context);
+        }
+    }
+
+    void do_string_value(string_view_type value, const parsing_context& context) override
+    {
+        begin_value(false, false);
+        for (size_t i = 0; i < captures_.size(); ++i)
+        {
+            decoders_[i]->string_value(value, context);
+        }
+        end_value();
+    }
+
+    void do_integer_value(int64_t value, const parsing_context& context) override
+    {
+        begin_value(false, false);
+        for (size_t i = 0; i < captures_.size(); ++i)
+        {
+            decoders_[i]->integer_value(value, context);
+        }
+        end_value();
+    }
+
+    void do_uinteger_value(uint64_t value, const parsing_context& context) override
+    {
+        begin_value(false, false);
+        for (size_t i = 0; i < captures_.size(); ++i)
+        {
+            decoders_[i]->uinteger_value(value, context);
+        }
+        end_value();
+    }
+
+    void do_double_value(double value, uint8_t precision, const parsing_context& context) override
+    {
+        begin_value(false, false);
+        for (size_t i = 0; i < captures_.size(); ++i)
+        {
+            decoders_[i]->double_value(value, precision, context);
+        }
+        end_value();
+    }
+
+    void do_bool_value(bool value, const parsing_context& context) override
+    {
+        begin_value(false, false);
+        for (size_t i = 0; i < captures_.size(); ++i)
+        {
+            decoders_[i]->bool_value(value, context);
+        }
+        end_value();
+    }
+
+    void do_null_value(const parsing_context& context) override
+    {
+        begin_value(false, false);
+        for (size_t i = 0; i < captures_.size(); ++i)
+        {
+            decoders_[i]->null_value(context);
+        }
+        end_value();
+    }
+};
+
+typedef basic_json_query_handler<json> json_query_handler;
+typedef basic_json_query_handler<wjson> wjson_query_handler;
+
+}}
+
+#endif
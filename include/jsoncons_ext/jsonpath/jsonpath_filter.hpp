@@ -19,6 +19,7 @@
 #include <cmath> 
 #include <jsoncons/json.hpp>
 #include "jsonpath_error_category.hpp"
+#include "jsonpath_regex.hpp"
 
 namespace jsoncons { namespace jsonpath { namespace detail {
 
@@ -44,6 +45,14 @@ struct PathConstructor
     typedef typename Json::char_type char_type;
     typedef typename Json::string_view_type string_view_type;
     typedef typename Json::string_type string_type;
+    typedef string_type path_type;
+
+    path_type root() const
+    {
+        path_type s;
+        s.push_back('$');
+        return s;
+    }
 
     string_type operator()(const string_type& path, size_t index) const
     {
@@ -85,14 +94,24 @@ struct VoidPathConstructor
     typedef typename Json::string_view_type string_view_type;
     typedef typename Json::string_type string_type;
 
-    string_type operator()(const string_type&, size_t) const
+    // Value queries carry no path
+    struct path_type
+    {
+    };
+
+    path_type root() const
     {
-        return string_type{};
+        return path_type();
     }
 
-    string_type operator()(const string_type&, string_view_type) const
+    path_type operator()(const path_type&, size_t) const
     {
-        return string_type{};
+        return path_type();
+    }
+
+    path_type operator()(const path_type&, string_view_type) const
+    {
+        return path_type();
     }
 };
 
@@ -102,6 +121,12 @@ template <class Json,
           class PathCons>
 class jsonpath_evaluator;
 
+template <class Json>
+struct path_step;
+
+template <class Json>
+class jsonpath_compiler;
+
 enum class filter_state
 {
     start,
@@ -140,8 +165,22 @@ public:
 
     virtual ~term() {}
 
-    virtual void initialize(const Json&)
+    // Terms that depend on the node being filtered return a term for that
+    // node, others return null and are used as they are. Terms are not
+    // modified after parsing, so a filter can be evaluated by many threads.
+    virtual std::shared_ptr<term<Json>> bind(const Json&, const Json&) const
     {
+        return nullptr;
+    }
+    // Terms that depend only on the root return a term for that root, so 
+    // that they are evaluated once rather than for each node filtered
+    virtual bool depends_on_root() const
+    {
+        return false;
+    }
+    virtual std::shared_ptr<term<Json>> bind_root(const Json&) const
+    {
+        return nullptr;
     }
     virtual bool accept_single_node() const
     {
@@ -307,6 +346,16 @@ public:
         return operator_(a,b);
     }
 
+    Json apply(const term<Json>& a) const
+    {
+        return unary_operator_(a);
+    }
+
+    Json apply(const term<Json>& a, const term<Json>& b) const
+    {
+        return operator_(a,b);
+    }
+
     token(token_type type)
         : type_(type),precedence_level_(0),is_right_associative_(false),is_aggregate_(false)
     {
@@ -392,18 +441,36 @@ public:
         return is_aggregate_;
     }
 
-    const term<Json>& operand()
+    const term<Json>& operand() const
     {
         JSONCONS_ASSERT(type_ == token_type::operand && operand_ptr_ != nullptr);
         return *operand_ptr_;
     }
 
-    void initialize(const Json& context_node)
+    token<Json> bind_root(const Json& root) const
+    {
+        if (operand_ptr_.get() != nullptr)
+        {
+            auto bound = operand_ptr_->bind_root(root);
+            if (bound)
+            {
+                return token<Json>(token_type::operand, bound);
+            }
+        }
+        return *this;
+    }
+
+    token<Json> bind(const Json& context_node, const Json& root) const
     {
         if (operand_ptr_.get() != nullptr)
         {
-            operand_ptr_->initialize(context_node);
+            auto bound = operand_ptr_->bind(context_node, root);
+            if (bound)
+            {
+                return token<Json>(token_type::operand, bound);
+            }
         }
+        return *this;
     }
 };
 
@@ -680,39 +747,32 @@ class regex_term : public term<Json>
 {
     typedef typename Json::char_type char_type;
     typedef typename Json::string_type string_type;
-    const std::basic_regex<char_type> pattern_;
+    std::shared_ptr<const basic_regex_matcher<char_type>> matcher_;
 public:
     regex_term(const string_type& pattern, std::regex::flag_type flags)
-        : pattern_(pattern,flags)
+        : matcher_(basic_regex_cache<char_type>::instance().get(pattern,flags))
     {
     }
 
     bool regex2(const string_type& subject) const override
     {
-        return std::regex_match(subject, pattern_);
+        return matcher_->matches(subject.data(), subject.length());
     }
 };
 
+// The values selected by a path from the node being filtered
 template <class Json>
-class path_term : public term<Json>
+class node_set_term : public term<Json>
 {
     typedef typename Json::string_type string_type;
 
-    string_type path_;
     Json nodes_;
 public:
-    path_term(const string_type& path)
-        : path_(path)
+    node_set_term(Json&& nodes)
+        : nodes_(std::move(nodes))
     {
     }
 
-    void initialize(const Json& context_node) override
-    {
-        jsonpath_evaluator<Json,const Json&,const Json*,VoidPathConstructor<Json>> evaluator;
-        evaluator.evaluate(context_node,path_);
-        nodes_ = evaluator.get_values();
-    }
-
     bool accept_single_node() const override
     {
         return nodes_.size() != 0;
@@ -966,25 +1026,71 @@ public:
     }
 };
 
+// A path in a filter, compiled when the filter is parsed. It is evaluated
+// against the node being filtered, or for the argument of an aggregate 
+// function like max, against the root.
 template <class Json>
-token<Json> evaluate(const Json& context, std::vector<token<Json>>& tokens)
+class path_term : public term<Json>
 {
-    for (auto it= tokens.begin(); it != tokens.end(); ++it)
+    typedef typename Json::string_type string_type;
+
+    std::shared_ptr<const std::vector<path_step<Json>>> steps_;
+    bool aggregate_;
+public:
+    path_term(const string_type& path, bool aggregate = false)
+        : aggregate_(aggregate)
+    {
+        jsonpath_compiler<Json> compiler;
+        steps_ = std::make_shared<const std::vector<path_step<Json>>>(compiler.compile(path.data(),path.length()));
+    }
+
+    bool depends_on_root() const override
+    {
+        return aggregate_;
+    }
+
+    std::shared_ptr<term<Json>> bind_root(const Json& root) const override
     {
-        it->initialize(context);
+        if (!aggregate_)
+        {
+            return nullptr;
+        }
+        jsonpath_evaluator<Json,const Json&,const Json*,VoidPathConstructor<Json>> evaluator;
+        evaluator.evaluate(root,*steps_);
+        return std::make_shared<value_term<Json>>(evaluator.get_values());
     }
+
+    std::shared_ptr<term<Json>> bind(const Json& context_node, const Json& root) const override
+    {
+        jsonpath_evaluator<Json,const Json&,const Json*,VoidPathConstructor<Json>> evaluator;
+        if (aggregate_)
+        {
+            evaluator.evaluate(root,*steps_);
+            return std::make_shared<value_term<Json>>(evaluator.get_values());
+        }
+        else
+        {
+            evaluator.evaluate(context_node,*steps_);
+            return std::make_shared<node_set_term<Json>>(evaluator.get_values());
+        }
+    }
+};
+
+template <class Json>
+token<Json> evaluate(const Json& context, const Json& root, const std::vector<token<Json>>& tokens)
+{
     std::vector<token<Json>> stack;
-    for (auto t : tokens)
+    for (const auto& t : tokens)
     {
         if (t.is_operand())
         {
-            stack.push_back(t);
+            stack.push_back(t.bind(context, root));
         }
         else if (t.is_unary_operator())
         {
             auto rhs = stack.back();
             stack.pop_back();
-            Json val = t(rhs.operand());
+            Json val = t.apply(rhs.operand());
             stack.push_back(token<Json>(token_type::operand,std::make_shared<value_term<Json>>(val)));
         }
         else if (t.is_binary_operator())
@@ -993,7 +1099,7 @@ token<Json> evaluate(const Json& context, std::vector<token<Json>>& tokens)
             stack.pop_back();
             auto lhs = stack.back();
             stack.pop_back();
-            Json val = t(lhs.operand(), rhs.operand());
+            Json val = t.apply(lhs.operand(), rhs.operand());
             stack.push_back(token<Json>(token_type::operand,std::make_shared<value_term<Json>>(val)));
         }
     }
@@ -1019,11 +1125,42 @@ public:
     {
     }
 
-    Json eval(const Json& context_node)
+    // Whether the filter has terms that depend only on the root, the 
+    // arguments of aggregate functions
+    bool depends_on_root() const
+    {
+        for (const auto& t : tokens_)
+        {
+            if (t.is_operand() && t.operand().depends_on_root())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    // A copy with the terms that depend only on root evaluated
+    jsonpath_filter_expr bind_root(const Json& root) const
+    {
+        std::vector<token<Json>> tokens;
+        tokens.reserve(tokens_.size());
+        for (const auto& t : tokens_)
+        {
+            tokens.push_back(t.bind_root(root));
+        }
+        return jsonpath_filter_expr(tokens, line_, column_);
+    }
+
+    Json eval(const Json& context_node) const
+    {
+        return eval(context_node, context_node);
+    }
+
+    Json eval(const Json& context_node, const Json& root) const
     {
         try
         {
-            auto t = evaluate(context_node,tokens_);
+            auto t = evaluate(context_node,root,tokens_);
 
             return t.operand().evaluate_single_node();
 
@@ -1034,11 +1171,16 @@ public:
         }
     }
 
-    bool exists(const Json& context_node)
+    bool exists(const Json& context_node) const
+    {
+        return exists(context_node, context_node);
+    }
+
+    bool exists(const Json& context_node, const Json& root) const
     {
         try
         {
-            auto t = evaluate(context_node,tokens_);
+            auto t = evaluate(context_node,root,tokens_);
             return t.operand().accept_single_node();
         }
         catch (const parse_error& e)
@@ -1175,9 +1317,21 @@ public:
         return column_;
     }
 
-    jsonpath_filter_expr<Json> parse(const Json& root, const char_type* p, size_t length, const char_type** end_ptr)
+    jsonpath_filter_expr<Json> parse(const char_type* p, size_t length, const char_type** end_ptr)
     {
-        return parse(root, p,p+length, end_ptr);
+        return parse(p,p+length, end_ptr);
+    }
+
+    // The root is no longer needed to parse a filter, paths are evaluated
+    // when the filter is
+    jsonpath_filter_expr<Json> parse(const Json&, const char_type* p, size_t length, const char_type** end_ptr)
+    {
+        return parse(p,p+length, end_ptr);
+    }
+
+    jsonpath_filter_expr<Json> parse(const Json&, const char_type* p, const char_type* end_expr, const char_type** end_ptr)
+    {
+        return parse(p,end_expr,end_ptr);
     }
 
     void push_state(filter_state state)
@@ -1185,6 +1339,18 @@ public:
         state_stack_.push_back(state);
     }
 
+    void add_path_term(const string_type& path, bool aggregate)
+    {
+        try
+        {
+            add_token(token<Json>(token_type::operand,std::make_shared<path_term<Json>>(path,aggregate)));
+        }
+        catch (const parse_error& e)
+        {
+            throw parse_error(e.code(),line_,column_);
+        }
+    }
+
     filter_state pop_state()
     {
         if (state_stack_.empty())
@@ -1249,7 +1415,7 @@ public:
         }
     }
 
-    jsonpath_filter_expr<Json> parse(const Json& root, const char_type* p, const char_type* end_expr, const char_type** end_ptr)
+    jsonpath_filter_expr<Json> parse(const char_type* p, const char_type* end_expr, const char_type** end_ptr)
     {
         output_stack_.clear();
         operator_stack_.clear();
@@ -1328,25 +1494,7 @@ public:
                     case ')':
                         if (buffer.length() > 0)
                         {
-                            if (operator_stack_.back().is_aggregate())
-                            {
-                                try
-                                {
-                                    // path, parse against root, get value
-                                    jsonpath_evaluator<Json,const Json&,const Json*,detail::VoidPathConstructor<Json>> evaluator;
-                                    evaluator.evaluate(root,buffer.data(),buffer.length());
-                                    auto result = evaluator.get_values();
-                                    add_token(token<Json>(token_type::operand,std::make_shared<value_term<Json>>(result)));
-                                }
-                                catch (const parse_error& e)
-                                {
-                                    throw parse_error(e.code(),line_,column_);
-                                }
-                            }
-                            else
-                            {
-                                add_token(token<Json>(token_type::operand,std::make_shared<path_term<Json>>(buffer)));
-                            }
+                            add_path_term(buffer, operator_stack_.back().is_aggregate());
                             buffer.clear();
                             state = filter_state::expect_oper_or_right_round_bracket;
                         }
@@ -1751,7 +1899,7 @@ public:
                     {
                         if (buffer.length() > 0)
                         {
-                            add_token(token<Json>(token_type::operand,std::make_shared<path_term<Json>>(buffer)));
+                            add_path_term(buffer, false);
                             buffer.clear();
                         }
                         buffer.push_back(*p);
@@ -1763,7 +1911,7 @@ public:
                 case ')':
                     if (buffer.length() > 0)
                     {
-                        add_token(token<Json>(token_type::operand,std::make_shared<path_term<Json>>(buffer)));
+                        add_path_term(buffer, false);
                         add_token(token<Json>(token_type::rparen));
                         buffer.clear();
                     }
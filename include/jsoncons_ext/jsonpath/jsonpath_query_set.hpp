@@ -0,0 +1,550 @@
+// Copyright 2017 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_JSONPATH_JSONPATHQUERYSET_HPP
+#define JSONCONS_JSONPATH_JSONPATHQUERYSET_HPP
+
+#include <string>
+#include <vector>
+#include <memory>
+#include <utility>
+#include <jsoncons/json.hpp>
+#include "json_query.hpp"
+
+namespace jsoncons { namespace jsonpath {
+
+template <class Json>
+class basic_json_query_handler;
+
+namespace detail {
+
+template <class Json>
+struct key_selector
+{
+    typedef typename Json::string_type string_type;
+
+    string_type name;
+    bool is_index;
+    bool positive;
+    size_t index;
+
+    key_selector(const string_type& name, bool positive_start)
+        : name(name), is_index(false), positive(true), index(0)
+    {
+        positive = positive_start;
+        is_index = try_string_to_index(name.data(), name.size(), &index, &positive);
+        if (!is_index)
+        {
+            positive = true;
+        }
+    }
+
+    friend bool operator==(const key_selector& lhs, const key_selector& rhs)
+    {
+        return lhs.name == rhs.name && lhs.positive == rhs.positive;
+    }
+};
+
+struct slice_selector
+{
+    size_t start;
+    bool positive_start;
+    size_t end;
+    bool positive_end;
+    bool undefined_end;
+    size_t step;
+    bool positive_step;
+
+    friend bool operator==(const slice_selector& lhs, const slice_selector& rhs)
+    {
+        return lhs.start == rhs.start && lhs.positive_start == rhs.positive_start &&
+               lhs.end == rhs.end && lhs.positive_end == rhs.positive_end &&
+               lhs.undefined_end == rhs.undefined_end &&
+               lhs.step == rhs.step && lhs.positive_step == rhs.positive_step;
+    }
+
+    // Whether element index of an array of the given size is selected,
+    // with the same bounds as jsonpath_evaluator
+    bool selects(size_t index, size_t size) const
+    {
+        size_t first = positive_start ? start : size - start;
+        size_t last = undefined_end ? size : (positive_end ? end : size - end);
+        if (index < first || index >= last || step == 0)
+        {
+            return false;
+        }
+        return positive_step ? (index - first) % step == 0 : (last - 1 - index) % step == 0;
+    }
+};
+
+// A step of a path that selects members or elements of a container by
+// looking at their names or indexes only
+template <class Json>
+struct step_selector
+{
+    bool all;
+    bool recursive;
+    std::vector<key_selector<Json>> keys;
+    std::vector<slice_selector> slices;
+
+    step_selector()
+        : all(false), recursive(false)
+    {
+    }
+
+    friend bool operator==(const step_selector& lhs, const step_selector& rhs)
+    {
+        return lhs.all == rhs.all && lhs.recursive == rhs.recursive &&
+               lhs.keys == rhs.keys && lhs.slices == rhs.slices;
+    }
+
+    // Whether the step depends on the size of an array
+    bool needs_size() const
+    {
+        for (const auto& key : keys)
+        {
+            if (!key.positive)
+            {
+                return true;
+            }
+        }
+        for (const auto& slice : slices)
+        {
+            if (!slice.positive_start || (!slice.undefined_end && !slice.positive_end) ||
+                !slice.positive_step)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool selects_member(typename Json::string_view_type name, bool direct) const
+    {
+        if (direct && all)
+        {
+            return true;
+        }
+        for (const auto& key : keys)
+        {
+            if (typename Json::string_view_type(key.name) == name)
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    bool selects_element(size_t index, size_t size, bool direct) const
+    {
+        if (direct && all)
+        {
+            return true;
+        }
+        for (const auto& key : keys)
+        {
+            if (key.is_index && (key.positive ? key.index : size - key.index) == index)
+            {
+                return true;
+            }
+        }
+        for (const auto& slice : slices)
+        {
+            if (slice.selects(index, size))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+// Converts compiled steps to step selectors. Returns false if a step has a
+// filter or script expression, or a name that is evaluated specially
+// (length), which need the value and not only its position.
+template <class Json>
+bool make_step_selectors(const std::vector<path_step<Json>>& steps, std::vector<step_selector<Json>>& result)
+{
+    static const typename Json::char_type length_data[] = {'l','e','n','g','t','h'};
+    typename Json::string_view_type length_literal(length_data, sizeof(length_data)/sizeof(length_data[0]));
+
+    result.clear();
+    result.reserve(steps.size());
+    for (const auto& step : steps)
+    {
+        step_selector<Json> s;
+        s.all = step.all;
+        s.recursive = step.recursive;
+        if (step.name.length() > 0)
+        {
+            s.keys.emplace_back(step.name, true);
+        }
+        for (const auto& selector : step.selectors)
+        {
+            switch (selector.kind)
+            {
+            case selector_kind::name:
+                s.keys.emplace_back(selector.name, selector.positive_start);
+                break;
+            case selector_kind::slice:
+                {
+                    slice_selector slice;
+                    slice.start = selector.start;
+                    slice.positive_start = selector.positive_start;
+                    slice.end = selector.end;
+                    slice.positive_end = selector.positive_end;
+                    slice.undefined_end = selector.undefined_end;
+                    slice.step = selector.step;
+                    slice.positive_step = selector.positive_step;
+                    s.slices.push_back(slice);
+                }
+                break;
+            default:
+                return false;
+            }
+        }
+        for (const auto& key : s.keys)
+        {
+            if (typename Json::string_view_type(key.name) == length_literal)
+            {
+                return false;
+            }
+        }
+        result.push_back(std::move(s));
+    }
+    return true;
+}
+
+// The paths of a set of queries, with common prefixes merged. Node 0 is the
+// root ($), the step of a node selects it from the node's parent, and the
+// queries of a node are those that end there.
+template <class Json>
+class selector_trie
+{
+public:
+    struct node
+    {
+        step_selector<Json> step;
+        std::vector<size_t> children;
+        std::vector<size_t> queries;
+    };
+private:
+    std::vector<node> nodes_;
+public:
+    selector_trie()
+        : nodes_(1)
+    {
+    }
+
+    void add(const std::vector<step_selector<Json>>& steps, size_t query)
+    {
+        size_t current = 0;
+        for (const auto& step : steps)
+        {
+            size_t next = 0;
+            for (size_t child : nodes_[current].children)
+            {
+                if (nodes_[child].step == step)
+                {
+                    next = child;
+                    break;
+                }
+            }
+            if (next == 0)
+            {
+                next = nodes_.size();
+                nodes_.emplace_back();
+                nodes_.back().step = step;
+                nodes_[current].children.push_back(next);
+            }
+            current = next;
+        }
+        nodes_[current].queries.push_back(query);
+    }
+
+    const node& operator[](size_t i) const
+    {
+        return nodes_[i];
+    }
+
+    size_t size() const
+    {
+        return nodes_.size();
+    }
+
+    bool needs_size() const
+    {
+        for (const auto& n : nodes_)
+        {
+            if (n.step.needs_size())
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+};
+
+inline
+void add_unique(std::vector<size_t>& v, size_t k)
+{
+    for (size_t x : v)
+    {
+        if (x == k)
+        {
+            return;
+        }
+    }
+    v.push_back(k);
+}
+
+// Walks a value once, following all the paths of a selector_trie at the same
+// time. states are the trie nodes whose children are applied to the members
+// or elements of a container, carried the recursive nodes that are applied
+// to the members or elements of a descendant of their parent node.
+template <class Json, class PathCons>
+class trie_walker
+{
+    typedef typename Json::string_view_type string_view_type;
+    typedef typename PathCons::path_type path_type;
+    typedef std::pair<path_type,const Json*> node_type;
+
+    struct frame
+    {
+        std::vector<size_t> states;
+        std::vector<size_t> carried;
+    };
+
+    const selector_trie<Json>& trie_;
+    std::vector<std::vector<node_type>>& results_;
+    std::vector<frame> frames_;
+public:
+    trie_walker(const selector_trie<Json>& trie, std::vector<std::vector<node_type>>& results)
+        : trie_(trie), results_(results)
+    {
+    }
+
+    void walk(const Json& root)
+    {
+        path_type path = PathCons().root();
+        for (size_t q : trie_[0].queries)
+        {
+            results_[q].emplace_back(path, std::addressof(root));
+        }
+        if (trie_[0].children.empty() || !(root.is_object() || root.is_array()))
+        {
+            return;
+        }
+        frames_.resize(1);
+        frames_[0].states.assign(1, 0);
+        frames_[0].carried.clear();
+        walk(root, 0, path);
+    }
+
+private:
+    void walk(const Json& val, size_t depth, const path_type& path)
+    {
+        if (frames_.size() <= depth + 1)
+        {
+            frames_.resize(depth + 2);
+        }
+        if (val.is_object())
+        {
+            for (const auto& member : val.object_range())
+            {
+                visit(member.value(), depth, [&](const step_selector<Json>& step, bool direct)
+                {
+                    return step.selects_member(member.key(), direct);
+                }, [&]()
+                {
+                    return PathCons()(path, member.key());
+                });
+            }
+        }
+        else
+        {
+            size_t size = val.size();
+            for (size_t i = 0; i < size; ++i)
+            {
+                visit(val[i], depth, [&](const step_selector<Json>& step, bool direct)
+                {
+                    return step.selects_element(i, size, direct);
+                }, [&]()
+                {
+                    return PathCons()(path, i);
+                });
+            }
+        }
+    }
+
+    template <class Selects, class ChildPath>
+    void visit(const Json& child, size_t depth, Selects selects, ChildPath child_path)
+    {
+        const frame& parent = frames_[depth];
+        frame& next = frames_[depth+1];
+        next.states.clear();
+        next.carried.clear();
+        bool is_container = child.is_object() || child.is_array();
+        path_type cpath;
+        bool has_path = false;
+
+        auto reach = [&](size_t n)
+        {
+            const auto& node = trie_[n];
+            if (!node.queries.empty())
+            {
+                if (!has_path)
+                {
+                    cpath = child_path();
+                    has_path = true;
+                }
+                for (size_t q : node.queries)
+                {
+                    results_[q].emplace_back(cpath, std::addressof(child));
+                }
+            }
+            if (!node.children.empty() && is_container)
+            {
+                add_unique(next.states, n);
+            }
+        };
+
+        for (size_t s : parent.states)
+        {
+            for (size_t n : trie_[s].children)
+            {
+                if (selects(trie_[n].step, true))
+                {
+                    reach(n);
+                }
+                if (trie_[n].step.recursive && is_container)
+                {
+                    add_unique(next.carried, n);
+                }
+            }
+        }
+        for (size_t n : parent.carried)
+        {
+            if (selects(trie_[n].step, false))
+            {
+                reach(n);
+            }
+            if (is_container)
+            {
+                add_unique(next.carried, n);
+            }
+        }
+        if (is_container && (!next.states.empty() || !next.carried.empty()))
+        {
+            if (!has_path)
+            {
+                cpath = child_path();
+            }
+            walk(child, depth+1, cpath);
+        }
+    }
+};
+
+}
+
+// A set of JSONPath expressions that are evaluated together, in one
+// traversal of a value. Common prefixes of the paths are merged, so that
+// each node is visited once rather than once per expression.
+template <class Json>
+class jsonpath_query_set
+{
+    friend class basic_json_query_handler<Json>;
+
+    typedef typename Json::string_view_type string_view_type;
+
+    std::vector<jsonpath_expression<Json>> expressions_;
+    detail::selector_trie<Json> trie_;
+    std::vector<size_t> fallback_;
+public:
+    // Returns the index of the expression in the set
+    size_t add(const jsonpath_expression<Json>& expr)
+    {
+        size_t query = expressions_.size();
+        expressions_.push_back(expr);
+
+        std::vector<detail::step_selector<Json>> steps;
+        if (detail::make_step_selectors(*(expr.steps_), steps))
+        {
+            trie_.add(steps, query);
+        }
+        else
+        {
+            fallback_.push_back(query);
+        }
+        return query;
+    }
+
+    size_t add(string_view_type path)
+    {
+        return add(compile<Json>(path));
+    }
+
+    size_t size() const
+    {
+        return expressions_.size();
+    }
+
+    // Returns an array with one element for each expression, in the order
+    // they were added, holding the values or normalized paths selected by
+    // that expression in document order
+    Json evaluate(const Json& root, result_type result_t = result_type::value) const
+    {
+        Json result = typename Json::array();
+        result.reserve(expressions_.size());
+        if (result_t == result_type::value)
+        {
+            auto nodes = select<detail::VoidPathConstructor<Json>>(root);
+            for (size_t q = 0; q < nodes.size(); ++q)
+            {
+                Json values = typename Json::array();
+                values.reserve(nodes[q].size());
+                for (const auto& node : nodes[q])
+                {
+                    values.push_back(*(node.second));
+                }
+                result.push_back(std::move(values));
+            }
+        }
+        else
+        {
+            auto nodes = select<detail::PathConstructor<Json>>(root);
+            for (size_t q = 0; q < nodes.size(); ++q)
+            {
+                Json paths = typename Json::array();
+                paths.reserve(nodes[q].size());
+                for (auto& node : nodes[q])
+                {
+                    paths.push_back(std::move(node.first));
+                }
+                result.push_back(std::move(paths));
+            }
+        }
+        for (size_t q : fallback_)
+        {
+            result[q] = expressions_[q].evaluate(root, result_t);
+        }
+        return result;
+    }
+
+private:
+    template <class PathCons>
+    std::vector<std::vector<std::pair<typename PathCons::path_type,const Json*>>> select(const Json& root) const
+    {
+        std::vector<std::vector<std::pair<typename PathCons::path_type,const Json*>>> nodes(expressions_.size());
+        detail::trie_walker<Json,PathCons> walker(trie_, nodes);
+        walker.walk(root);
+        return nodes;
+    }
+};
+
+}}
+
+#endif
@@ -0,0 +1,792 @@
+// Copyright 2017 Daniel Parker
+// Distributed under the Boost license, Version 1.0.
+// (See accompanying file LICENSE_1_0.txt or copy at http://www.boost.org/LICENSE_1_0.txt)
+
+// See https://github.com/danielaparker/jsoncons for latest version
+
+#ifndef JSONCONS_JSONPATH_JSONPATHREGEX_HPP
+#define JSONCONS_JSONPATH_JSONPATHREGEX_HPP
+
+#include <string>
+#include <vector>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <regex>
+#include <limits>
+#include <utility>
+#include <algorithm>
+#include <functional>
+#include <type_traits>
+#include <cstdint>
+
+namespace jsoncons { namespace jsonpath {
+
+// Matches a whole string against a regular expression, as std::regex_match
+// does. Implementations must be safe to call from many threads at once.
+template <class CharT>
+class basic_regex_matcher
+{
+public:
+    virtual ~basic_regex_matcher() {}
+
+    virtual bool matches(const CharT* s, size_t length) const = 0;
+};
+
+template <class CharT>
+class std_regex_matcher : public basic_regex_matcher<CharT>
+{
+    std::basic_regex<CharT> pattern_;
+public:
+    std_regex_matcher(const std::basic_string<CharT>& pattern, std::regex_constants::syntax_option_type flags)
+        : pattern_(pattern, flags)
+    {
+    }
+
+    bool matches(const CharT* s, size_t length) const override
+    {
+        return std::regex_match(s, s + length, pattern_);
+    }
+};
+
+namespace detail {
+
+// A deterministic automaton for the subset of ECMAScript regular expressions
+// made of literals, escapes, character classes, ., alternation, groups and
+// the *, + and ? quantifiers, with ^ and $ at the ends of the pattern.
+// Code units are matched one at a time, as by std::regex.
+template <class CharT>
+class dfa_regex_matcher : public basic_regex_matcher<CharT>
+{
+    typedef typename std::make_unsigned<CharT>::type uchar_type;
+    typedef uint32_t code_unit;
+    typedef std::vector<std::pair<code_unit,code_unit>> range_set;
+
+    static const size_t max_states = 2000;
+
+    enum class node_kind {ranges, concat, alt, star, plus, opt};
+
+    struct node
+    {
+        node_kind kind;
+        range_set ranges;
+        std::vector<size_t> children;
+    };
+
+    struct nfa_state
+    {
+        std::vector<bool> classes;
+        int next;
+        std::vector<int> eps;
+
+        nfa_state()
+            : next(-1)
+        {
+        }
+    };
+
+    class unsupported {};
+
+    // Parser state
+    const CharT* p_;
+    const CharT* end_;
+    const CharT* begin_;
+    bool icase_;
+    std::vector<node> nodes_;
+
+    // Automaton
+    std::vector<code_unit> boundaries_;
+    std::vector<int> byte_classes_;
+    size_t class_count_;
+    std::vector<int> transitions_;
+    std::vector<bool> accepting_;
+public:
+    // Returns nullptr if the pattern is outside the supported subset or
+    // the automaton would be too large
+    static std::shared_ptr<const basic_regex_matcher<CharT>> create(const std::basic_string<CharT>& pattern, bool icase)
+    {
+        std::shared_ptr<dfa_regex_matcher> matcher(new dfa_regex_matcher());
+        try
+        {
+            if (!matcher->build(pattern, icase))
+            {
+                return nullptr;
+            }
+        }
+        catch (const unsupported&)
+        {
+            return nullptr;
+        }
+        return matcher;
+    }
+
+    bool matches(const CharT* s, size_t length) const override
+    {
+        int state = 0;
+        for (size_t i = 0; i < length; ++i)
+        {
+            state = transitions_[state*class_count_ + class_of(static_cast<uchar_type>(s[i]))];
+            if (state < 0)
+            {
+                return false;
+            }
+        }
+        return accepting_[state];
+    }
+
+private:
+    dfa_regex_matcher()
+        : p_(nullptr), end_(nullptr), begin_(nullptr), icase_(false), class_count_(0)
+    {
+    }
+
+    static code_unit max_unit()
+    {
+        return static_cast<code_unit>((std::numeric_limits<uchar_type>::max)()) < (std::numeric_limits<code_unit>::max)()
+            ? static_cast<code_unit>((std::numeric_limits<uchar_type>::max)())
+            : (std::numeric_limits<code_unit>::max)();
+    }
+
+    size_t class_of(code_unit c) const
+    {
+        if (c < byte_classes_.size())
+        {
+            return byte_classes_[c];
+        }
+        return (std::upper_bound(boundaries_.begin(), boundaries_.end(), c) - boundaries_.begin()) - 1;
+    }
+
+    bool build(const std::basic_string<CharT>& pattern, bool icase)
+    {
+        begin_ = pattern.data();
+        p_ = begin_;
+        end_ = begin_ + pattern.size();
+        icase_ = icase;
+
+        if (p_ < end_ && *p_ == '^')
+        {
+            ++p_;
+        }
+        if (end_ > p_ && *(end_-1) == '$' && !escaped(end_-1))
+        {
+            --end_;
+        }
+        size_t root = parse_alt();
+        if (p_ != end_)
+        {
+            throw unsupported();
+        }
+        compute_classes();
+
+        std::vector<nfa_state> nfa;
+        std::pair<int,int> fragment = build_nfa(root, nfa);
+        return build_dfa(nfa, fragment.first, fragment.second);
+    }
+
+    bool escaped(const CharT* q) const
+    {
+        size_t count = 0;
+        while (q > begin_ && *(q-1) == '\\')
+        {
+            ++count;
+            --q;
+        }
+        return count % 2 == 1;
+    }
+
+    size_t add_node(node_kind kind)
+    {
+        nodes_.emplace_back();
+        nodes_.back().kind = kind;
+        return nodes_.size() - 1;
+    }
+
+    size_t add_ranges(range_set&& ranges)
+    {
+        size_t n = add_node(node_kind::ranges);
+        nodes_[n].ranges = std::move(ranges);
+        return n;
+    }
+
+    size_t parse_alt()
+    {
+        size_t first = parse_concat();
+        if (p_ == end_ || *p_ != '|')
+        {
+            return first;
+        }
+        size_t n = add_node(node_kind::alt);
+        nodes_[n].children.push_back(first);
+        while (p_ != end_ && *p_ == '|')
+        {
+            ++p_;
+            size_t next = parse_concat();
+            nodes_[n].children.push_back(next);
+        }
+        return n;
+    }
+
+    size_t parse_concat()
+    {
+        size_t n = add_node(node_kind::concat);
+        while (p_ != end_ && *p_ != '|' && *p_ != ')')
+        {
+            size_t child = parse_repeat();
+            nodes_[n].children.push_back(child);
+        }
+        return n;
+    }
+
+    size_t parse_repeat()
+    {
+        size_t n = parse_atom();
+        if (p_ != end_ && (*p_ == '*' || *p_ == '+' || *p_ == '?'))
+        {
+            node_kind kind = *p_ == '*' ? node_kind::star : (*p_ == '+' ? node_kind::plus : node_kind::opt);
+            ++p_;
+            // A lazy quantifier matches the same whole strings
+            if (p_ != end_ && *p_ == '?')
+            {
+                ++p_;
+            }
+            size_t r = add_node(kind);
+            nodes_[r].children.push_back(n);
+            n = r;
+        }
+        return n;
+    }
+
+    size_t parse_atom()
+    {
+        CharT c = *p_++;
+        switch (c)
+        {
+        case '(':
+            {
+                if (p_ != end_ && *p_ == '?')
+                {
+                    if (p_+1 != end_ && *(p_+1) == ':')
+                    {
+                        p_ += 2;
+                    }
+                    else
+                    {
+                        throw unsupported();
+                    }
+                }
+                size_t n = parse_alt();
+                if (p_ == end_ || *p_ != ')')
+                {
+                    throw unsupported();
+                }
+                ++p_;
+                return n;
+            }
+        case '.':
+            {
+                range_set ranges;
+                add_range(ranges, 0, '\n'-1);
+                add_range(ranges, '\n'+1, '\r'-1);
+                if (max_unit() > 0x2029)
+                {
+                    add_range(ranges, '\r'+1, 0x2027);
+                    add_range(ranges, 0x202A, max_unit());
+                }
+                else
+                {
+                    add_range(ranges, '\r'+1, max_unit());
+                }
+                return add_ranges(std::move(ranges));
+            }
+        case '[':
+            return parse_class();
+        case '\\':
+            {
+                range_set ranges;
+                bool negated = false;
+                parse_escape(ranges, negated);
+                if (negated)
+                {
+                    ranges = complement(ranges);
+                }
+                return add_ranges(std::move(ranges));
+            }
+        case '*': case '+': case '?': case '{': case '}': case ']': case '^': case '$': case ')': case '|':
+            throw unsupported();
+        default:
+            {
+                range_set ranges;
+                add_literal(ranges, static_cast<uchar_type>(c));
+                return add_ranges(std::move(ranges));
+            }
+        }
+    }
+
+    size_t parse_class()
+    {
+        range_set ranges;
+        bool negated = false;
+        if (p_ != end_ && *p_ == '^')
+        {
+            negated = true;
+            ++p_;
+        }
+        if (p_ != end_ && *p_ == ']')
+        {
+            throw unsupported();
+        }
+        while (p_ != end_ && *p_ != ']')
+        {
+            code_unit lo;
+            if (*p_ == '\\')
+            {
+                ++p_;
+                range_set escape;
+                bool escape_negated = false;
+                if (parse_escape(escape, escape_negated))
+                {
+                    if (escape_negated)
+                    {
+                        throw unsupported();
+                    }
+                    ranges.insert(ranges.end(), escape.begin(), escape.end());
+                    continue;
+                }
+                lo = escape[0].first;
+            }
+            else if (*p_ == '[')
+            {
+                throw unsupported();
+            }
+            else
+            {
+                lo = static_cast<uchar_type>(*p_++);
+            }
+            code_unit hi = lo;
+            if (p_+1 < end_ && *p_ == '-' && *(p_+1) != ']')
+            {
+                ++p_;
+                if (*p_ == '\\' || *p_ == '[')
+                {
+                    throw unsupported();
+                }
+                hi = static_cast<uchar_type>(*p_++);
+                if (hi < lo)
+                {
+                    throw unsupported();
+                }
+            }
+            add_range(ranges, lo, hi);
+            if (icase_)
+            {
+                add_other_case(ranges, lo, hi);
+            }
+        }
+        if (p_ == end_)
+        {
+            throw unsupported();
+        }
+        ++p_;
+        if (negated)
+        {
+            ranges = complement(ranges);
+        }
+        return add_ranges(std::move(ranges));
+    }
+
+    // Returns true for a class escape (\d, \w, \s and their negations),
+    // false for an escaped character
+    bool parse_escape(range_set& ranges, bool& negated)
+    {
+        if (p_ == end_)
+        {
+            throw unsupported();
+        }
+        CharT c = *p_++;
+        switch (c)
+        {
+        case 'D': negated = true; // fall through
+        case 'd':
+            add_range(ranges, '0', '9');
+            return true;
+        case 'W': negated = true; // fall through
+        case 'w':
+            add_range(ranges, '0', '9');
+            add_range(ranges, 'A', 'Z');
+            add_range(ranges, '_', '_');
+            add_range(ranges, 'a', 'z');
+            return true;
+        case 'S': negated = true; // fall through
+        case 's':
+            add_range(ranges, '\t', '\r');
+            add_range(ranges, ' ', ' ');
+            return true;
+        case 't': add_range(ranges, '\t', '\t'); return false;
+        case 'n': add_range(ranges, '\n', '\n'); return false;
+        case 'r': add_range(ranges, '\r', '\r'); return false;
+        case 'f': add_range(ranges, '\f', '\f'); return false;
+        case 'v': add_range(ranges, '\v', '\v'); return false;
+        default:
+            if ((c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') ||
+                static_cast<uchar_type>(c) > 127)
+            {
+                throw unsupported();
+            }
+            add_literal(ranges, static_cast<uchar_type>(c));
+            return false;
+        }
+    }
+
+    void add_literal(range_set& ranges, code_unit c)
+    {
+        add_range(ranges, c, c);
+        if (icase_)
+        {
+            add_other_case(ranges, c, c);
+        }
+    }
+
+    static void add_range(range_set& ranges, code_unit lo, code_unit hi)
+    {
+        ranges.emplace_back(lo, hi);
+    }
+
+    // ASCII case folding, as std::regex does with the classic locale
+    static void add_other_case(range_set& ranges, code_unit lo, code_unit hi)
+    {
+        code_unit a = (std::max)(lo, code_unit('a'));
+        code_unit b = (std::min)(hi, code_unit('z'));
+        if (a <= b)
+        {
+            ranges.emplace_back(a - 'a' + 'A', b - 'a' + 'A');
+        }
+        a = (std::max)(lo, code_unit('A'));
+        b = (std::min)(hi, code_unit('Z'));
+        if (a <= b)
+        {
+            ranges.emplace_back(a - 'A' + 'a', b - 'A' + 'a');
+        }
+    }
+
+    static range_set normalize(range_set ranges)
+    {
+        std::sort(ranges.begin(), ranges.end());
+        range_set result;
+        for (const auto& r : ranges)
+        {
+            if (!result.empty() && (result.back().second == (std::numeric_limits<code_unit>::max)() || r.first <= result.back().second + 1))
+            {
+                result.back().second = (std::max)(result.back().second, r.second);
+            }
+            else
+            {
+                result.push_back(r);
+            }
+        }
+        return result;
+    }
+
+    static range_set complement(const range_set& ranges)
+    {
+        range_set sorted = normalize(ranges);
+        range_set result;
+        code_unit next = 0;
+        bool done = false;
+        for (const auto& r : sorted)
+        {
+            if (r.first > next)
+            {
+                result.emplace_back(next, r.first - 1);
+            }
+            if (r.second >= max_unit())
+            {
+                done = true;
+                break;
+            }
+            next = r.second + 1;
+        }
+        if (!done)
+        {
+            result.emplace_back(next, max_unit());
+        }
+        return result;
+    }
+
+    // Splits the code units into classes that no range of the pattern
+    // distinguishes between
+    void compute_classes()
+    {
+        boundaries_.push_back(0);
+        for (auto& n : nodes_)
+        {
+            if (n.kind == node_kind::ranges)
+            {
+                n.ranges = normalize(n.ranges);
+                for (const auto& r : n.ranges)
+                {
+                    boundaries_.push_back(r.first);
+                    if (r.second < max_unit())
+                    {
+                        boundaries_.push_back(r.second + 1);
+                    }
+                }
+            }
+        }
+        std::sort(boundaries_.begin(), boundaries_.end());
+        boundaries_.erase(std::unique(boundaries_.begin(), boundaries_.end()), boundaries_.end());
+        class_count_ = boundaries_.size();
+
+        byte_classes_.resize(max_unit() >= 255 ? 256 : max_unit() + 1);
+        size_t k = 0;
+        for (size_t c = 0; c < byte_classes_.size(); ++c)
+        {
+            while (k+1 < boundaries_.size() && boundaries_[k+1] <= c)
+            {
+                ++k;
+            }
+            byte_classes_[c] = static_cast<int>(k);
+        }
+    }
+
+    // Thompson construction, returns the start and end states
+    std::pair<int,int> build_nfa(size_t index, std::vector<nfa_state>& nfa)
+    {
+        const node& n = nodes_[index];
+        int start = static_cast<int>(nfa.size());
+        nfa.emplace_back();
+        switch (n.kind)
+        {
+        case node_kind::ranges:
+            {
+                int end = static_cast<int>(nfa.size());
+                nfa.emplace_back();
+                nfa[start].classes.resize(class_count_, false);
+                for (const auto& r : n.ranges)
+                {
+                    size_t first = class_of(r.first);
+                    size_t last = class_of(r.second);
+                    for (size_t c = first; c <= last; ++c)
+                    {
+                        nfa[start].classes[c] = true;
+                    }
+                }
+                nfa[start].next = end;
+                return std::make_pair(start, end);
+            }
+        case node_kind::concat:
+            {
+                int current = start;
+                for (size_t child : n.children)
+                {
+                    std::pair<int,int> f = build_nfa(child, nfa);
+                    nfa[current].eps.push_back(f.first);
+                    current = f.second;
+                }
+                return std::make_pair(start, current);
+            }
+        case node_kind::alt:
+            {
+                std::vector<int> ends;
+                for (size_t child : n.children)
+                {
+                    std::pair<int,int> f = build_nfa(child, nfa);
+                    nfa[start].eps.push_back(f.first);
+                    ends.push_back(f.second);
+                }
+                int end = static_cast<int>(nfa.size());
+                nfa.emplace_back();
+                for (int e : ends)
+                {
+                    nfa[e].eps.push_back(end);
+                }
+                return std::make_pair(start, end);
+            }
+        case node_kind::star:
+        case node_kind::plus:
+        case node_kind::opt:
+            {
+                std::pair<int,int> f = build_nfa(n.children[0], nfa);
+                int end = static_cast<int>(nfa.size());
+                nfa.emplace_back();
+                nfa[start].eps.push_back(f.first);
+                if (n.kind != node_kind::plus)
+                {
+                    nfa[start].eps.push_back(end);
+                }
+                if (n.kind != node_kind::opt)
+                {
+                    nfa[f.second].eps.push_back(f.first);
+                }
+                nfa[f.second].eps.push_back(end);
+                return std::make_pair(start, end);
+            }
+        }
+        return std::make_pair(start, start);
+    }
+
+    static void closure(const std::vector<nfa_state>& nfa, std::vector<int>& set)
+    {
+        std::vector<int> stack(set);
+        std::vector<bool> seen(nfa.size(), false);
+        for (int s : set)
+        {
+            seen[s] = true;
+        }
+        while (!stack.empty())
+        {
+            int s = stack.back();
+            stack.pop_back();
+            for (int t : nfa[s].eps)
+            {
+                if (!seen[t])
+                {
+                    seen[t] = true;
+                    set.push_back(t);
+                    stack.push_back(t);
+                }
+            }
+        }
+        std::sort(set.begin(), set.end());
+    }
+
+    // Subset construction
+    bool build_dfa(const std::vector<nfa_state>& nfa, int start, int end)
+    {
+        std::map<std::vector<int>,int> ids;
+        std::vector<std::vector<int>> sets;
+
+        std::vector<int> initial(1, start);
+        closure(nfa, initial);
+        ids[initial] = 0;
+        sets.push_back(initial);
+
+        for (size_t i = 0; i < sets.size(); ++i)
+        {
+            if (sets.size() > max_states)
+            {
+                return false;
+            }
+            accepting_.push_back(std::binary_search(sets[i].begin(), sets[i].end(), end));
+            for (size_t c = 0; c < class_count_; ++c)
+            {
+                std::vector<int> next;
+                for (int s : sets[i])
+                {
+                    if (nfa[s].next >= 0 && nfa[s].classes[c])
+                    {
+                        next.push_back(nfa[s].next);
+                    }
+                }
+                int id = -1;
+                if (!next.empty())
+                {
+                    std::sort(next.begin(), next.end());
+                    next.erase(std::unique(next.begin(), next.end()), next.end());
+                    closure(nfa, next);
+                    auto it = ids.find(next);
+                    if (it == ids.end())
+                    {
+                        id = static_cast<int>(sets.size());
+                        ids[next] = id;
+                        sets.push_back(std::move(next));
+                    }
+                    else
+                    {
+                        id = it->second;
+                    }
+                }
+                transitions_.push_back(id);
+            }
+        }
+        return true;
+    }
+};
+
+}
+
+// A process wide cache of compiled regular expressions, keyed by pattern and
+// flags. Patterns are compiled by the factory, which by default uses the
+// built-in automaton when the pattern is in its subset, and std::regex
+// otherwise.
+template <class CharT>
+class basic_regex_cache
+{
+public:
+    typedef std::basic_string<CharT> string_type;
+    typedef std::shared_ptr<const basic_regex_matcher<CharT>> matcher_ptr;
+    typedef std::function<matcher_ptr(const string_type& pattern, std::regex_constants::syntax_option_type flags)> factory_type;
+
+    static const size_t max_entries = 1024;
+
+private:
+    typedef std::pair<string_type,std::regex_constants::syntax_option_type> key_type;
+
+    std::mutex mutex_;
+    factory_type factory_;
+    std::map<key_type,matcher_ptr> cache_;
+
+    basic_regex_cache()
+        : factory_(default_factory)
+    {
+    }
+public:
+    static basic_regex_cache& instance()
+    {
+        static basic_regex_cache cache;
+        return cache;
+    }
+
+    static matcher_ptr default_factory(const string_type& pattern, std::regex_constants::syntax_option_type flags)
+    {
+        bool icase = (flags & std::regex_constants::icase) == std::regex_constants::icase;
+        if ((flags & ~std::regex_constants::icase) == std::regex_constants::ECMAScript)
+        {
+            matcher_ptr matcher = detail::dfa_regex_matcher<CharT>::create(pattern, icase);
+            if (matcher)
+            {
+                return matcher;
+            }
+        }
+        return std::make_shared<std_regex_matcher<CharT>>(pattern, flags);
+    }
+
+    // Replaces the factory and empties the cache. Expressions compiled
+    // earlier keep the matchers they have.
+    void set_factory(factory_type factory)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        factory_ = factory;
+        cache_.clear();
+    }
+
+    matcher_ptr get(const string_type& pattern, std::regex_constants::syntax_option_type flags)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        key_type key(pattern, flags);
+        auto it = cache_.find(key);
+        if (it != cache_.end())
+        {
+            return it->second;
+        }
+        matcher_ptr matcher = factory_(pattern, flags);
+        if (cache_.size() >= max_entries)
+        {
+            cache_.clear();
+        }
+        cache_.emplace(std::move(key), matcher);
+        return matcher;
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        cache_.clear();
+    }
+};
+
+typedef basic_regex_cache<char> regex_cache;
+typedef basic_regex_cache<wchar_t> wregex_cache;
+
+}}
+
+#endif
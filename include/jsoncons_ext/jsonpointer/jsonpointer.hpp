@@ -13,6 +13,8 @@
 #include <istream>
 #include <cstdlib>
 #include <memory>
+#include <limits>
+#include <algorithm>
 #include <jsoncons/json.hpp>
 #include <jsoncons_ext/jsonpointer/jsonpointer_error_category.hpp>
 
@@ -31,6 +33,48 @@ enum class pointer_state
     escaped
 };
 
+template <class CharT>
+struct reference_token
+{
+    std::basic_string<CharT> name;
+    size_t index;
+    jsonpointer_errc name_ec;
+    jsonpointer_errc index_ec;
+    bool last_element;
+
+    reference_token()
+        : index(0), name_ec(), index_ec(), last_element(false)
+    {
+    }
+
+    friend bool operator==(const reference_token& a, const reference_token& b)
+    {
+        return a.name == b.name && a.name_ec == b.name_ec && a.index_ec == b.index_ec && a.last_element == b.last_element;
+    }
+
+    friend bool operator!=(const reference_token& a, const reference_token& b)
+    {
+        return !(a == b);
+    }
+
+    friend bool operator<(const reference_token& a, const reference_token& b)
+    {
+        if (a.name != b.name)
+        {
+            return a.name < b.name;
+        }
+        if (a.name_ec != b.name_ec)
+        {
+            return a.name_ec < b.name_ec;
+        }
+        if (a.index_ec != b.index_ec)
+        {
+            return a.index_ec < b.index_ec;
+        }
+        return a.last_element < b.last_element;
+    }
+};
+
 template<class Json,class JsonReference,class JsonPointer>
 struct PathResolver
 {
@@ -590,6 +634,296 @@ private:
 
 }
 
+// basic_pointer
+
+template <class CharT>
+class basic_pointer
+{
+public:
+    typedef CharT char_type;
+    typedef std::char_traits<char_type> char_traits_type;
+    typedef std::basic_string<char_type,char_traits_type> string_type;
+#if !defined(JSONCONS_HAS_STRING_VIEW)
+    typedef Basic_string_view_<char_type,char_traits_type> string_view_type;
+#else
+    typedef std::basic_string_view<char_type,char_traits_type> string_view_type;
+#endif
+    typedef detail::reference_token<char_type> token_type;
+private:
+    string_type path_;
+    jsonpointer_errc ec_;
+    std::vector<token_type> tokens_;
+public:
+    basic_pointer()
+        : ec_()
+    {
+    }
+
+    explicit basic_pointer(string_view_type path)
+        : path_(path.data(), path.length()), ec_()
+    {
+        const char_type* p = path_.data();
+        const char_type* end = path_.data() + path_.length();
+        if (p == end)
+        {
+            return;
+        }
+        if (*p != '/')
+        {
+            ec_ = jsonpointer_errc::expected_slash;
+            return;
+        }
+        while (p < end)
+        {
+            const char_type* first = ++p;
+            while (p < end && *p != '/')
+            {
+                ++p;
+            }
+            tokens_.push_back(make_token(first, p, p == end));
+        }
+    }
+
+    // Returns the pointer as it was given
+    const string_type& string() const
+    {
+        return path_;
+    }
+
+    // Returns the number of reference tokens
+    size_t size() const
+    {
+        return tokens_.size();
+    }
+
+    bool empty() const
+    {
+        return tokens_.empty();
+    }
+
+    jsonpointer_errc error() const
+    {
+        return ec_;
+    }
+
+    const std::vector<token_type>& tokens() const
+    {
+        return tokens_;
+    }
+
+    friend bool operator==(const basic_pointer& a, const basic_pointer& b)
+    {
+        return a.path_ == b.path_;
+    }
+
+    friend bool operator!=(const basic_pointer& a, const basic_pointer& b)
+    {
+        return !(a == b);
+    }
+private:
+    // A token is unescaped and, if it is an array index, converted once, 
+    // keeping the error the string would give for each kind of container
+    static token_type make_token(const char_type* first, const char_type* last, bool is_last)
+    {
+        token_type token;
+
+        for (const char_type* p = first; p < last && token.name_ec == jsonpointer_errc(); ++p)
+        {
+            if (*p != '~')
+            {
+                token.name.push_back(*p);
+            }
+            else if (p + 1 == last)
+            {
+                token.name_ec = is_last ? jsonpointer_errc::end_of_input : jsonpointer_errc::expected_0_or_1;
+            }
+            else if (*(p+1) == '0')
+            {
+                token.name.push_back('~');
+                ++p;
+            }
+            else if (*(p+1) == '1')
+            {
+                token.name.push_back('/');
+                ++p;
+            }
+            else
+            {
+                token.name_ec = jsonpointer_errc::expected_0_or_1;
+            }
+        }
+
+        if (first == last)
+        {
+            token.index_ec = is_last ? jsonpointer_errc::end_of_input : jsonpointer_errc::expected_digit_or_dash;
+        }
+        else if (*first == '-')
+        {
+            if (first + 1 != last)
+            {
+                token.index_ec = jsonpointer_errc::expected_slash;
+            }
+            else if (!is_last)
+            {
+                token.index_ec = jsonpointer_errc::index_exceeds_array_size;
+            }
+            else
+            {
+                token.last_element = true;
+            }
+        }
+        else if (*first == '0')
+        {
+            if (first + 1 != last)
+            {
+                char_type c = *(first+1);
+                if (c >= '0' && c <= '9')
+                {
+                    token.index_ec = jsonpointer_errc::unexpected_leading_zero;
+                }
+                else if (c == '-')
+                {
+                    token.index_ec = jsonpointer_errc::index_exceeds_array_size;
+                }
+                else
+                {
+                    token.index_ec = jsonpointer_errc::expected_digit_or_dash;
+                }
+            }
+        }
+        else if (*first >= '1' && *first <= '9')
+        {
+            for (const char_type* p = first; p < last && token.index_ec == jsonpointer_errc(); ++p)
+            {
+                if (*p >= '0' && *p <= '9')
+                {
+                    size_t digit = static_cast<size_t>(*p - '0');
+                    if (token.index > ((std::numeric_limits<size_t>::max)() - digit) / 10)
+                    {
+                        token.index_ec = jsonpointer_errc::index_exceeds_array_size;
+                    }
+                    else
+                    {
+                        token.index = token.index * 10 + digit;
+                    }
+                }
+                else if (*p == '-')
+                {
+                    token.index_ec = jsonpointer_errc::index_exceeds_array_size;
+                }
+                else
+                {
+                    token.index_ec = jsonpointer_errc::expected_digit_or_dash;
+                }
+            }
+        }
+        else
+        {
+            token.index_ec = jsonpointer_errc::expected_digit_or_dash;
+        }
+        return token;
+    }
+};
+
+typedef basic_pointer<char> pointer;
+typedef basic_pointer<wchar_t> wpointer;
+
+namespace detail {
+
+template<class Json,class JsonPointer>
+jsonpointer_errc select_child(JsonPointer& current, 
+                              const reference_token<typename Json::char_type>& token)
+{
+    if (current->is_array())
+    {
+        if (token.index_ec != jsonpointer_errc())
+        {
+            return token.index_ec;
+        }
+        if (token.last_element)
+        {
+            return jsonpointer_errc::end_of_input;
+        }
+        if (token.index >= current->size())
+        {
+            return jsonpointer_errc::index_exceeds_array_size;
+        }
+        current = std::addressof(current->at(token.index));
+    }
+    else if (current->is_object())
+    {
+        if (token.name_ec != jsonpointer_errc())
+        {
+            return token.name_ec;
+        }
+        auto it = current->find(typename Json::string_view_type(token.name.data(),token.name.length()));
+        if (it == current->object_range().end())
+        {
+            return jsonpointer_errc::name_not_found;
+        }
+        current = std::addressof(it->value());
+    }
+    else
+    {
+        return jsonpointer_errc::expected_object_or_array;
+    }
+    return jsonpointer_errc();
+}
+
+template<class Json,class JsonPointer>
+jsonpointer_errc select_parent(JsonPointer& current, 
+                               const basic_pointer<typename Json::char_type>& location)
+{
+    if (location.error() != jsonpointer_errc())
+    {
+        return location.error();
+    }
+    const auto& tokens = location.tokens();
+    for (size_t i = 0; i + 1 < tokens.size(); ++i)
+    {
+        jsonpointer_errc ec = select_child<Json>(current, tokens[i]);
+        if (ec != jsonpointer_errc())
+        {
+            return ec;
+        }
+    }
+    if (!current->is_array() && !current->is_object())
+    {
+        return jsonpointer_errc::expected_object_or_array;
+    }
+    const auto& token = tokens.back();
+    if (current->is_array() && token.index_ec != jsonpointer_errc())
+    {
+        return token.index_ec;
+    }
+    if (current->is_object() && token.name_ec != jsonpointer_errc())
+    {
+        return token.name_ec;
+    }
+    return jsonpointer_errc();
+}
+
+template<class Json,class JsonPointer>
+jsonpointer_errc select(JsonPointer& current, 
+                        const basic_pointer<typename Json::char_type>& location)
+{
+    if (location.error() != jsonpointer_errc())
+    {
+        return location.error();
+    }
+    for (const auto& token : location.tokens())
+    {
+        jsonpointer_errc ec = select_child<Json>(current, token);
+        if (ec != jsonpointer_errc())
+        {
+            return ec;
+        }
+    }
+    return jsonpointer_errc();
+}
+
+}
+
 template<class Json>
 typename Json::string_type normalized_path(const Json& root, typename Json::string_view_type path)
 {
@@ -645,6 +979,246 @@ jsonpointer_errc replace(Json& root, typename Json::string_view_type path, const
     return evaluator.replace(root,path,value);
 }
 
+// Overloads that take a basic_pointer, parsed once
+
+template<class Json>
+basic_pointer<typename Json::char_type> normalized_path(const Json& root, const basic_pointer<typename Json::char_type>& location)
+{
+    const Json* current = std::addressof(root);
+    if (location.empty() || !location.tokens().back().last_element ||
+        detail::select_parent<Json>(current, location) != jsonpointer_errc() || !current->is_array())
+    {
+        return location;
+    }
+    typename Json::string_type path = location.string();
+    path.pop_back();
+    std::string s = std::to_string(current->size());
+    for (auto c : s)
+    {
+        path.push_back(c);
+    }
+    return basic_pointer<typename Json::char_type>(path);
+}
+
+template<class Json>
+std::tuple<Json,jsonpointer_errc> get(const Json& root, const basic_pointer<typename Json::char_type>& location)
+{
+    const Json* current = std::addressof(root);
+    jsonpointer_errc ec = detail::select<Json>(current, location);
+    return ec == jsonpointer_errc() ? std::make_tuple(*current,ec) : std::make_tuple(Json(),ec);
+}
+
+// Resolves many pointers against one document, in the order given, 
+// walking each common prefix of the sorted pointers once
+template<class Json>
+std::vector<std::tuple<Json,jsonpointer_errc>> get(const Json& root, const std::vector<basic_pointer<typename Json::char_type>>& locations)
+{
+    typedef basic_pointer<typename Json::char_type> pointer_type;
+
+    std::vector<size_t> order(locations.size());
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        order[i] = i;
+    }
+    std::sort(order.begin(), order.end(), 
+              [&](size_t a, size_t b){return locations[a].tokens() < locations[b].tokens();});
+
+    std::vector<std::tuple<Json,jsonpointer_errc>> result(locations.size());
+    std::vector<const Json*> stack;
+    stack.push_back(std::addressof(root));
+    const pointer_type* prev = nullptr;
+    for (size_t i : order)
+    {
+        const pointer_type& location = locations[i];
+        if (location.error() != jsonpointer_errc())
+        {
+            std::get<1>(result[i]) = location.error();
+            continue;
+        }
+        const auto& tokens = location.tokens();
+        size_t common = 0;
+        if (prev != nullptr)
+        {
+            const auto& prev_tokens = prev->tokens();
+            while (common < tokens.size() && common < prev_tokens.size() && 
+                   tokens[common] == prev_tokens[common])
+            {
+                ++common;
+            }
+        }
+        stack.resize((std::min)(common, stack.size() - 1) + 1);
+
+        jsonpointer_errc ec = jsonpointer_errc();
+        for (size_t j = stack.size() - 1; j < tokens.size() && ec == jsonpointer_errc(); ++j)
+        {
+            const Json* current = stack.back();
+            ec = detail::select_child<Json>(current, tokens[j]);
+            if (ec == jsonpointer_errc())
+            {
+                stack.push_back(current);
+            }
+        }
+        if (ec == jsonpointer_errc())
+        {
+            std::get<0>(result[i]) = *stack.back();
+        }
+        std::get<1>(result[i]) = ec;
+        prev = &location;
+    }
+    return result;
+}
+
+template<class Json>
+bool contains(const Json& root, const basic_pointer<typename Json::char_type>& location)
+{
+    const Json* current = std::addressof(root);
+    return detail::select<Json>(current, location) == jsonpointer_errc();
+}
+
+template<class Json>
+jsonpointer_errc insert_or_assign(Json& root, const basic_pointer<typename Json::char_type>& location, const Json& value)
+{
+    if (location.empty())
+    {
+        return location.error();
+    }
+    Json* current = std::addressof(root);
+    jsonpointer_errc ec = detail::select_parent<Json>(current, location);
+    if (ec != jsonpointer_errc())
+    {
+        return ec;
+    }
+    const auto& token = location.tokens().back();
+    if (current->is_array())
+    {
+        if (token.last_element || token.index == current->size())
+        {
+            current->push_back(value);
+        }
+        else if (token.index > current->size())
+        {
+            return jsonpointer_errc::index_exceeds_array_size;
+        }
+        else
+        {
+            current->insert(current->array_range().begin()+token.index,value);
+        }
+    }
+    else
+    {
+        current->set(token.name,value);
+    }
+    return jsonpointer_errc();
+}
+
+template<class Json>
+jsonpointer_errc insert(Json& root, const basic_pointer<typename Json::char_type>& location, const Json& value)
+{
+    if (location.empty())
+    {
+        return location.error();
+    }
+    Json* current = std::addressof(root);
+    jsonpointer_errc ec = detail::select_parent<Json>(current, location);
+    if (ec != jsonpointer_errc())
+    {
+        return ec;
+    }
+    const auto& token = location.tokens().back();
+    if (current->is_array())
+    {
+        if (token.last_element || token.index == current->size())
+        {
+            current->push_back(value);
+        }
+        else if (token.index > current->size())
+        {
+            return jsonpointer_errc::index_exceeds_array_size;
+        }
+        else
+        {
+            current->insert(current->array_range().begin()+token.index,value);
+        }
+    }
+    else if (current->has_key(token.name))
+    {
+        return jsonpointer_errc::key_already_exists;
+    }
+    else
+    {
+        current->set(token.name,value);
+    }
+    return jsonpointer_errc();
+}
+
+template<class Json>
+jsonpointer_errc erase(Json& root, const basic_pointer<typename Json::char_type>& location)
+{
+    if (location.empty())
+    {
+        return location.error();
+    }
+    Json* current = std::addressof(root);
+    jsonpointer_errc ec = detail::select_parent<Json>(current, location);
+    if (ec != jsonpointer_errc())
+    {
+        return ec;
+    }
+    const auto& token = location.tokens().back();
+    if (current->is_array())
+    {
+        if (token.last_element || token.index >= current->size())
+        {
+            return jsonpointer_errc::index_exceeds_array_size;
+        }
+        current->erase(current->array_range().begin()+token.index);
+    }
+    else
+    {
+        auto it = current->find(typename Json::string_view_type(token.name.data(),token.name.length()));
+        if (it == current->object_range().end())
+        {
+            return jsonpointer_errc::name_not_found;
+        }
+        current->erase(it);
+    }
+    return jsonpointer_errc();
+}
+
+template<class Json>
+jsonpointer_errc replace(Json& root, const basic_pointer<typename Json::char_type>& location, const Json& value)
+{
+    if (location.empty())
+    {
+        return location.error();
+    }
+    Json* current = std::addressof(root);
+    jsonpointer_errc ec = detail::select_parent<Json>(current, location);
+    if (ec != jsonpointer_errc())
+    {
+        return ec;
+    }
+    const auto& token = location.tokens().back();
+    if (current->is_array())
+    {
+        if (token.last_element || token.index >= current->size())
+        {
+            return jsonpointer_errc::index_exceeds_array_size;
+        }
+        (*current)[token.index] = value;
+    }
+    else
+    {
+        auto it = current->find(typename Json::string_view_type(token.name.data(),token.name.length()));
+        if (it == current->object_range().end())
+        {
+            return jsonpointer_errc::name_not_found;
+        }
+        it->value(value);
+    }
+    return jsonpointer_errc();
+}
+
 #if !defined(JSONCONS_NO_DEPRECATED)
 
 template<class Json>
@@ -0,0 +1,156 @@
+// Copyright 2017 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/monotonic_arena.hpp>
+#include <sstream>
+#include <vector>
+#include <utility>
+#include <algorithm>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(arena_json_tests)
+
+BOOST_AUTO_TEST_CASE(test_monotonic_arena)
+{
+    monotonic_arena arena(64);
+    void* p1 = arena.allocate(10, 1);
+    void* p2 = arena.allocate(8, 8);
+    BOOST_CHECK(p1 != p2);
+    BOOST_CHECK_EQUAL(0, reinterpret_cast<uintptr_t>(p2) % 8);
+    void* p3 = arena.allocate(1000, 16); // larger than a block
+    BOOST_CHECK_EQUAL(0, reinterpret_cast<uintptr_t>(p3) % 16);
+    BOOST_CHECK_EQUAL(1018, arena.bytes_allocated());
+    arena.release();
+    BOOST_CHECK_EQUAL(0, arena.bytes_allocated());
+
+    // Allocations come from the caller's buffer first
+    char buffer[256];
+    monotonic_arena arena2(buffer, sizeof(buffer));
+    char* q = static_cast<char*>(arena2.allocate(32, 1));
+    BOOST_CHECK(q >= buffer && q < buffer + sizeof(buffer));
+    char* r = static_cast<char*>(arena2.allocate(512, 1));
+    BOOST_CHECK(!(r >= buffer && r < buffer + sizeof(buffer)));
+    arena2.release();
+    q = static_cast<char*>(arena2.allocate(32, 1));
+    BOOST_CHECK(q >= buffer && q < buffer + sizeof(buffer));
+}
+
+BOOST_AUTO_TEST_CASE(test_monotonic_arena_exact_fit_block)
+{
+    // The block added for the first allocation is all but used up, so
+    // aligning the next one would go past the end of the block
+    monotonic_arena arena(16);
+    char* p1 = static_cast<char*>(arena.allocate(5001, 1));
+    char* p2 = static_cast<char*>(arena.allocate(8, 8));
+    BOOST_CHECK_EQUAL(0, reinterpret_cast<uintptr_t>(p2) % 8);
+    BOOST_CHECK(p2 + 8 <= p1 || p2 >= p1 + 5001);
+    std::fill(p1, p1 + 5001, 'a');
+    std::fill(p2, p2 + 8, 'b');
+    BOOST_CHECK_EQUAL(5009, arena.bytes_allocated());
+
+    std::string s = "[\"" + std::string(40000, 'a') + "\", {\"k\":[1,2,3]}, \"" + std::string(5000, 'b') + "\"]";
+    monotonic_arena arena2(16);
+    arena_json j = arena_json::parse(s, arena2);
+    BOOST_CHECK_EQUAL(3, j.size());
+    BOOST_CHECK_EQUAL(3, j[1]["k"].size());
+    BOOST_CHECK_EQUAL(40000, j[0].as<std::string>().size());
+}
+
+BOOST_AUTO_TEST_CASE(test_arena_json_parse)
+{
+    std::string s = R"(
+{
+    "a member name that is long" : "a string value that is too long to be small",
+    "books" : [
+        {"title" : "Sword of Honour", "author" : "Evelyn Waugh", "price" : 12.99},
+        {"title" : "Moby Dick", "author" : "Herman Melville", "isbn" : "0-553-21311-3"}
+    ],
+    "count" : 2
+}
+    )";
+    monotonic_arena arena;
+    {
+        arena_json j = arena_json::parse(s, arena);
+        BOOST_CHECK(arena.bytes_allocated() > 0);
+        BOOST_CHECK(j.object_value().get_allocator().arena() == &arena);
+        BOOST_CHECK(j.at("books").array_value().get_allocator().arena() == &arena);
+
+        BOOST_CHECK(j["a member name that is long"].as<std::string>() == "a string value that is too long to be small");
+        BOOST_CHECK(j["books"][1]["isbn"].as<std::string>() == "0-553-21311-3");
+        BOOST_CHECK_EQUAL(12.99, j["books"][0]["price"].as<double>());
+        BOOST_CHECK_EQUAL(2, j["count"].as<int>());
+
+        std::ostringstream os;
+        os << j;
+        BOOST_CHECK(json::parse(os.str()) == json::parse(s));
+
+        // Values added later use the allocator of the container they go into
+        j["books"].add(arena_json::parse(R"({"title":"A title that is long enough"})", arena));
+        BOOST_CHECK_EQUAL(3, j["books"].size());
+    }
+    arena.release();
+    BOOST_CHECK_EQUAL(0, arena.bytes_allocated());
+
+    std::istringstream is(s);
+    arena_json j2 = arena_json::parse(is, arena);
+    BOOST_CHECK_EQUAL(2, j2["books"].size());
+}
+
+BOOST_AUTO_TEST_CASE(test_arena_json_decoder)
+{
+    monotonic_arena arena;
+    arena_allocator<char> allocator(arena);
+    json_decoder<arena_json> decoder(allocator, allocator);
+
+    std::string s = R"([{"name":"a name that is too long to be small"},["x","y"]])";
+    std::istringstream is(s);
+    json_reader reader(is, decoder);
+    reader.read();
+    arena_json j = decoder.get_result();
+
+    BOOST_CHECK(j.array_value().get_allocator().arena() == &arena);
+    BOOST_CHECK(j[0]["name"].as<std::string>() == "a name that is too long to be small");
+    BOOST_CHECK_EQUAL(2, j[1].size());
+}
+
+BOOST_AUTO_TEST_CASE(test_arena_json_default_allocator)
+{
+    // Without an arena, arena_json allocates with new and delete
+    arena_json j = arena_json::object(arena_allocator<char>());
+    j["first"] = "a string value that is too long to be small";
+    j["second"] = arena_json::array();
+    j["second"].add(1);
+    arena_json copy = j;
+    BOOST_CHECK(copy == j);
+    BOOST_CHECK(j.object_value().get_allocator().arena() == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_unsorted_members)
+{
+    // Objects with more and fewer members than the insertion sort threshold
+    for (size_t n : {1, 2, 5, 31, 32, 33, 100})
+    {
+        std::string s = "{";
+        for (size_t i = 0; i < n; ++i)
+        {
+            if (i > 0) s.push_back(',');
+            s += "\"k" + std::to_string((i * 37) % n) + "\":" + std::to_string(i);
+        }
+        s += ",\"k0\":\"last\"}";
+        json j = json::parse(s);
+        BOOST_CHECK_EQUAL(n, j.size());
+        BOOST_CHECK(j["k0"].as<std::string>() == "last");
+        std::string prev;
+        for (const auto& member : j.object_range())
+        {
+            std::string key = member.key();
+            BOOST_CHECK(prev < key);
+            prev = key;
+        }
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
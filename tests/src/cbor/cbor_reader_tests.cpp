@@ -0,0 +1,183 @@
+// Copyright 2017 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_filter.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <sstream>
+#include <vector>
+#include <utility>
+#include <limits>
+
+using namespace jsoncons;
+using namespace jsoncons::cbor;
+
+BOOST_AUTO_TEST_SUITE(cbor_reader_tests)
+
+namespace {
+
+const json doc = json::parse(R"(
+{
+    "store": {
+        "book": [
+            {"author": "Nigel Rees", "price": 8.95, "isbn": null, "available": true},
+            {"author": "Evelyn Waugh", "price": 12.99, "copies": 18446744073709551615, "delta": -300},
+            {"author": "Herman Melville", "title": "Moby Dick é中", "ratings": [], "notes": {}}
+        ],
+        "bicycle": {"color": "red", "price": 19.95, "sizes": [-1, 24, 256, 65536, 4294967296, -4294967297]}
+    }
+}
+)");
+
+std::vector<uint8_t> indefinite_encoding(const json& val)
+{
+    std::vector<uint8_t> v;
+    cbor_serializer serializer(v);
+    val.dump(serializer);
+    return v;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(test_decode_from_stream)
+{
+    std::vector<std::vector<uint8_t>> encodings = {encode_cbor(doc), indefinite_encoding(doc)};
+    for (const auto& v : encodings)
+    {
+        std::string s(v.begin(), v.end());
+        std::istringstream is(s);
+        BOOST_CHECK(decode_cbor<json>(is) == doc);
+        BOOST_CHECK(decode_cbor<json>(v) == doc);
+    }
+
+    std::vector<uint8_t> v = {0xbf,0x61,'a',0x7f,0x61,'H',0x62,'e','l',0xff,0x61,'b',0x9f,0xf9,0x3c,0x00,0xfa,0x3f,0xc0,0,0,0xff,0xff};
+    std::string s(v.begin(), v.end());
+    std::istringstream is(s);
+    BOOST_CHECK(decode_cbor<json>(is) == json::parse(R"({"a":"Hel","b":[1.0,1.5]})"));
+}
+
+BOOST_AUTO_TEST_CASE(test_split_anywhere)
+{
+    std::vector<std::vector<uint8_t>> encodings = {encode_cbor(doc), indefinite_encoding(doc)};
+    for (const auto& v : encodings)
+    {
+        // Two pieces, split at every byte
+        for (size_t i = 0; i <= v.size(); ++i)
+        {
+            json_decoder<json> decoder;
+            cbor_parser parser(decoder);
+            std::vector<uint8_t> first(v.begin(), v.begin() + i);
+            std::vector<uint8_t> second(v.begin() + i, v.end());
+            parser.set_source(first.data(), first.size());
+            parser.parse();
+            BOOST_CHECK(parser.source_exhausted());
+            first.assign(first.size(), 0);
+            parser.set_source(second.data(), second.size());
+            parser.parse();
+            BOOST_REQUIRE(parser.done());
+            BOOST_CHECK(decoder.get_result() == doc);
+        }
+
+        // One byte at a time
+        json_decoder<json> decoder;
+        cbor_parser parser(decoder);
+        for (size_t i = 0; i < v.size(); ++i)
+        {
+            BOOST_CHECK(!parser.done());
+            uint8_t b = v[i];
+            parser.set_source(&b, 1);
+            parser.parse();
+        }
+        parser.end_parse();
+        BOOST_CHECK(decoder.get_result() == doc);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_cbor_to_json_text)
+{
+    std::vector<uint8_t> v = encode_cbor(doc);
+    std::string s(v.begin(), v.end());
+    std::istringstream is(s);
+
+    std::ostringstream os;
+    json_serializer serializer(os);
+    json_filter filter(serializer);
+    cbor_reader reader(is, filter);
+    reader.buffer_length(7);
+    reader.read();
+
+    BOOST_CHECK(json::parse(os.str()) == doc);
+}
+
+BOOST_AUTO_TEST_CASE(test_read_sequence)
+{
+    std::vector<uint8_t> v;
+    for (int i = 0; i < 3; ++i)
+    {
+        std::vector<uint8_t> item = encode_cbor(json(json::array({i, "x"})));
+        v.insert(v.end(), item.begin(), item.end());
+    }
+    std::string s(v.begin(), v.end());
+    std::istringstream is(s);
+
+    json_decoder<json> decoder;
+    cbor_reader reader(is, decoder);
+    for (int i = 0; i < 3; ++i)
+    {
+        reader.read_next();
+        BOOST_CHECK(decoder.get_result() == json::array({i, "x"}));
+    }
+    reader.check_done();
+}
+
+BOOST_AUTO_TEST_CASE(test_wjson)
+{
+    std::vector<uint8_t> v = encode_cbor(doc);
+    std::string s(v.begin(), v.end());
+    std::istringstream is(s);
+    wjson result = decode_cbor<wjson>(is);
+    BOOST_CHECK(result[L"store"][L"book"][2][L"title"].as<std::wstring>() == L"Moby Dick é中");
+    BOOST_CHECK(result[L"store"][L"bicycle"][L"sizes"].size() == 6);
+}
+
+BOOST_AUTO_TEST_CASE(test_read_errors)
+{
+    std::vector<std::pair<std::vector<uint8_t>,cbor_parser_errc>> cases = {
+        {{}, cbor_parser_errc::unexpected_eof},
+        {{0x82,0x01}, cbor_parser_errc::unexpected_eof},
+        {{0x19,0x01}, cbor_parser_errc::unexpected_eof},
+        {{0x63,'a','b'}, cbor_parser_errc::unexpected_eof},
+        {{0x01,0x02}, cbor_parser_errc::extra_byte},
+        {{0xa1,0x01,0x02}, cbor_parser_errc::expected_text_key},
+        {{0x81,0xff}, cbor_parser_errc::unexpected_break},
+        {{0xbf,0x61,'a',0xff}, cbor_parser_errc::unexpected_break},
+        {{0x7f,0x01,0xff}, cbor_parser_errc::illegal_chunked_string},
+        {{0x62,0xc3,0x28}, cbor_parser_errc::invalid_utf8_text_string},
+        {{0x41,'a'}, cbor_parser_errc::unsupported_item},
+        {{0x1c}, cbor_parser_errc::unsupported_item},
+        {{0xf7}, cbor_parser_errc::unsupported_item}
+    };
+    for (const auto& c : cases)
+    {
+        std::string s(c.first.begin(), c.first.end());
+        std::istringstream is(s);
+        json_decoder<json> decoder;
+        cbor_reader reader(is, decoder);
+        std::error_code ec;
+        reader.read(ec);
+        BOOST_CHECK_MESSAGE(ec == c.second, ec.message());
+    }
+
+    std::istringstream is(std::string({'\x81','\x81','\x81','\x01'}));
+    json_decoder<json> decoder;
+    cbor_reader reader(is, decoder);
+    reader.max_nesting_depth(2);
+    BOOST_CHECK_THROW(reader.read(), parse_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,102 @@
+// Copyright 2017 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_filter.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <sstream>
+#include <vector>
+#include <utility>
+#include <limits>
+
+using namespace jsoncons;
+using namespace jsoncons::cbor;
+
+BOOST_AUTO_TEST_SUITE(cbor_serializer_tests)
+
+BOOST_AUTO_TEST_CASE(test_serialize_values)
+{
+    std::vector<uint8_t> v;
+    cbor_serializer serializer(v);
+    serializer.begin_json();
+    serializer.begin_array();
+    serializer.uinteger_value(24);
+    serializer.integer_value(-25);
+    serializer.integer_value((std::numeric_limits<int64_t>::min)());
+    serializer.string_value("a");
+    serializer.begin_object();
+    serializer.name("b");
+    serializer.bool_value(true);
+    serializer.end_object();
+    serializer.null_value();
+    serializer.double_value(1.5);
+    serializer.end_array();
+    serializer.end_json();
+
+    std::vector<uint8_t> expected = {0x9f, 
+                                     0x18,0x18, 
+                                     0x38,0x18, 
+                                     0x3b,0x7f,0xff,0xff,0xff,0xff,0xff,0xff,0xff,
+                                     0x61,'a', 
+                                     0xbf,0x61,'b',0xf5,0xff, 
+                                     0xf6, 
+                                     0xfb,0x3f,0xf8,0,0,0,0,0,0,
+                                     0xff};
+    BOOST_CHECK(v == expected);
+}
+
+BOOST_AUTO_TEST_CASE(test_transcode_json_to_cbor)
+{
+    std::string s = R"(
+    {
+        "store": {
+            "book": [
+                {"author": "Nigel Rees", "price": 8.95, "isbn": null, "available": true},
+                {"author": "Evelyn Waugh", "price": 12.99, "copies": 18446744073709551615, "delta": -300}
+            ]
+        },
+        "empty": [[], {}],
+        "text": "été"
+    }
+    )";
+
+    std::ostringstream os;
+    cbor_serializer serializer(os);
+    json_filter filter(serializer);
+    std::istringstream is(s);
+    json_reader reader(is, filter);
+    reader.read();
+
+    std::string bytes = os.str();
+    std::vector<uint8_t> v(bytes.begin(), bytes.end());
+    BOOST_CHECK(decode_cbor<json>(v) == json::parse(s));
+
+    std::vector<uint8_t> v2;
+    cbor_serializer serializer2(v2);
+    ojson::parse(s).dump(serializer2);
+    BOOST_CHECK(v2 == v);
+}
+
+BOOST_AUTO_TEST_CASE(test_large_output)
+{
+    json j = json::array();
+    for (size_t i = 0; i < 10000; ++i)
+    {
+        j.push_back("item " + std::to_string(i));
+    }
+    std::ostringstream os;
+    {
+        cbor_serializer serializer(os);
+        j.dump(serializer);
+    }
+    std::string bytes = os.str();
+    std::vector<uint8_t> v(bytes.begin(), bytes.end());
+    BOOST_CHECK(decode_cbor<json>(v) == j);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
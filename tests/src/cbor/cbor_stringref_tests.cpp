@@ -0,0 +1,194 @@
+// Copyright 2017 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <string>
+#include <vector>
+
+using namespace jsoncons;
+using namespace jsoncons::cbor;
+
+BOOST_AUTO_TEST_SUITE(cbor_stringref_tests)
+
+namespace {
+
+template <class Json>
+std::vector<uint8_t> encode_packed(const Json& j)
+{
+    return encode_cbor(j, cbor_options().pack_strings(true));
+}
+
+ojson record_batch(size_t count)
+{
+    ojson batch = ojson::array();
+    for (size_t i = 0; i < count; ++i)
+    {
+        ojson record;
+        for (size_t k = 0; k < 20; ++k)
+        {
+            record["field_name_" + std::to_string(k)] = i * 20 + k;
+        }
+        batch.push_back(std::move(record));
+    }
+    return batch;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(strings_not_packed_by_default)
+{
+    ojson j = ojson::parse(R"([{"name":"a"},{"name":"b"}])");
+    std::vector<uint8_t> v = encode_cbor(j);
+    BOOST_CHECK_EQUAL(0x82, v[0]);
+    BOOST_CHECK(!cbor_options().pack_strings());
+}
+
+BOOST_AUTO_TEST_CASE(repeated_key_is_a_reference)
+{
+    ojson j = ojson::parse(R"([{"name":"a"},{"name":"b"}])");
+    std::vector<uint8_t> expected = {0xd9,0x01,0x00, // tag 256
+                                     0x82,
+                                     0xa1,0x64,'n','a','m','e',0x61,'a',
+                                     0xa1,0xd8,0x19,0x00,0x61,'b'}; // tag 25, index 0
+    std::vector<uint8_t> v = encode_packed(j);
+    BOOST_CHECK(v == expected);
+    BOOST_CHECK_EQUAL(cbor_Encoder_<ojson>::calculate_size(j, cbor_options().pack_strings(true)), v.size());
+    BOOST_CHECK_EQUAL(j, decode_cbor<ojson>(v));
+}
+
+BOOST_AUTO_TEST_CASE(string_values_are_shared)
+{
+    json j = json::parse(R"(["red", "green", "red", "ok", "ok", "green"])");
+    std::vector<uint8_t> v = encode_packed(j);
+    std::vector<uint8_t> expected = {0xd9,0x01,0x00,
+                                     0x86,
+                                     0x63,'r','e','d',
+                                     0x65,'g','r','e','e','n',
+                                     0xd8,0x19,0x00,
+                                     0x62,'o','k', // too short to share
+                                     0x62,'o','k',
+                                     0xd8,0x19,0x01};
+    BOOST_CHECK(v == expected);
+    BOOST_CHECK_EQUAL(j, decode_cbor<json>(v));
+}
+
+BOOST_AUTO_TEST_CASE(minimum_length_grows_with_the_table)
+{
+    // The first 24 strings of three bytes are added to the table, after
+    // that a string must have four bytes
+    json j = json::array();
+    for (char c = 'a'; c < 'a' + 25; ++c)
+    {
+        j.push_back(std::string(3, c));
+    }
+    j.push_back("aaa");
+    j.push_back("yyy");
+    std::vector<uint8_t> v = encode_packed(j);
+
+    std::vector<uint8_t> tail(v.end() - 7, v.end());
+    std::vector<uint8_t> expected_tail = {0xd8,0x19,0x00, // "aaa" is shared
+                                          0x63,'y','y','y'}; // "yyy" isn't
+    BOOST_CHECK(tail == expected_tail);
+    BOOST_CHECK_EQUAL(j, decode_cbor<json>(v));
+    BOOST_CHECK_EQUAL(3, stringref_min_length(23));
+    BOOST_CHECK_EQUAL(4, stringref_min_length(24));
+    BOOST_CHECK_EQUAL(5, stringref_min_length(256));
+    BOOST_CHECK_EQUAL(7, stringref_min_length(65536));
+}
+
+BOOST_AUTO_TEST_CASE(record_batch_round_trip)
+{
+    ojson batch = record_batch(1000);
+    std::vector<uint8_t> plain = encode_cbor(batch);
+    std::vector<uint8_t> packed = encode_packed(batch);
+    BOOST_CHECK(packed.size() * 2 < plain.size());
+    BOOST_CHECK_EQUAL(batch, decode_cbor<ojson>(packed));
+
+    json unordered = decode_cbor<json>(packed);
+    BOOST_CHECK_EQUAL(unordered, decode_cbor<json>(plain));
+}
+
+BOOST_AUTO_TEST_CASE(wide_strings_round_trip)
+{
+    wjson j = wjson::parse(LR"([{"köln":"straße"},{"köln":"straße"}])");
+    std::vector<uint8_t> v = encode_packed(j);
+    BOOST_CHECK(v.size() < encode_cbor(j).size());
+    BOOST_CHECK(j == decode_cbor<wjson>(v));
+}
+
+BOOST_AUTO_TEST_CASE(packed_strings_with_typed_arrays)
+{
+    ojson j = ojson::parse(R"(
+    [
+        {"samples": [1, 2, 3, 4], "units": "mV"},
+        {"samples": [1, 2, 3, 4], "units": "mV"},
+        {"samples": [5, 6], "label": "unit"}
+    ]
+    )");
+    std::vector<uint8_t> v = encode_cbor(j, cbor_options().pack_strings(true).enable_typed_arrays(true));
+    BOOST_CHECK(v.size() < encode_cbor(j, cbor_options().enable_typed_arrays(true)).size());
+    BOOST_CHECK_EQUAL(j, decode_cbor<ojson>(v));
+}
+
+BOOST_AUTO_TEST_CASE(byte_string_references)
+{
+    // A typed array whose bytes are given by a reference to an earlier one
+    std::vector<uint8_t> v = {0xd9,0x01,0x00,
+                              0x82,
+                              0xd8,0x40,0x43,0x01,0x02,0x03,
+                              0xd8,0x40,0xd8,0x19,0x00};
+    json j = decode_cbor<json>(v);
+    BOOST_CHECK_EQUAL(json::parse("[[1,2,3],[1,2,3]]"), j);
+
+    // A byte string can't stand in for text
+    std::vector<uint8_t> as_text = {0xd9,0x01,0x00,
+                                    0x82,
+                                    0xd8,0x40,0x43,0x01,0x02,0x03,
+                                    0xd8,0x19,0x00};
+    BOOST_CHECK_THROW(decode_cbor<json>(as_text), std::exception);
+}
+
+BOOST_AUTO_TEST_CASE(nested_namespaces)
+{
+    // The inner namespace starts with an empty table, and the outer table
+    // is back in use after it
+    std::vector<uint8_t> v = {0xd9,0x01,0x00,
+                              0x83,
+                              0x63,'a','b','c',
+                              0xd9,0x01,0x00,
+                              0x82,0x63,'x','y','z',0xd8,0x19,0x00,
+                              0xd8,0x19,0x00};
+    json j = decode_cbor<json>(v);
+    BOOST_CHECK_EQUAL(json::parse(R"(["abc",["xyz","xyz"],"abc"])"), j);
+}
+
+BOOST_AUTO_TEST_CASE(invalid_references)
+{
+    // Outside of a namespace
+    std::vector<uint8_t> outside = {0xd8,0x19,0x00};
+    BOOST_CHECK_THROW(decode_cbor<json>(outside), std::exception);
+
+    // Past the end of the table
+    std::vector<uint8_t> past_end = {0xd9,0x01,0x00,0x82,0x63,'a','b','c',0xd8,0x19,0x01};
+    BOOST_CHECK_THROW(decode_cbor<json>(past_end), std::exception);
+
+    // A short string isn't in the table
+    std::vector<uint8_t> short_string = {0xd9,0x01,0x00,0x82,0x62,'a','b',0xd8,0x19,0x00};
+    BOOST_CHECK_THROW(decode_cbor<json>(short_string), std::exception);
+
+    // Not followed by an unsigned integer
+    std::vector<uint8_t> not_index = {0xd9,0x01,0x00,0x82,0x63,'a','b','c',0xd8,0x19,0x20};
+    BOOST_CHECK_THROW(decode_cbor<json>(not_index), std::exception);
+
+    // Other two byte tags
+    std::vector<uint8_t> other_tag = {0xd9,0x01,0x01,0x80};
+    BOOST_CHECK_THROW(decode_cbor<json>(other_tag), std::exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,292 @@
+// Copyright 2017 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <sstream>
+#include <vector>
+#include <limits>
+
+using namespace jsoncons;
+using namespace jsoncons::cbor;
+
+BOOST_AUTO_TEST_SUITE(cbor_typed_array_tests)
+
+namespace {
+
+std::vector<uint8_t> encode_typed(const json& j)
+{
+    return encode_cbor(j, cbor_options().enable_typed_arrays(true));
+}
+
+json parse_in_pieces(const std::vector<uint8_t>& v, size_t piece_length)
+{
+    json_decoder<json> decoder;
+    cbor_parser parser(decoder);
+    for (size_t i = 0; i < v.size(); i += piece_length)
+    {
+        parser.set_source(v.data() + i, (std::min)(piece_length, v.size() - i));
+        parser.parse();
+    }
+    parser.end_parse();
+    return decoder.get_result();
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(typed_arrays_disabled_by_default)
+{
+    json j = json::array{1,2,3};
+    BOOST_CHECK(encode_cbor(j) == std::vector<uint8_t>({0x83,0x01,0x02,0x03}));
+    BOOST_CHECK(!cbor_options().enable_typed_arrays());
+}
+
+BOOST_AUTO_TEST_CASE(encode_smallest_element_type)
+{
+    // uint8
+    BOOST_CHECK(encode_typed(json::array{1,2,255}) == std::vector<uint8_t>({0xd8,0x40,0x43,0x01,0x02,0xff}));
+    // uint16 little endian
+    BOOST_CHECK(encode_typed(json::array{1,256}) == std::vector<uint8_t>({0xd8,0x45,0x44,0x01,0x00,0x00,0x01}));
+    // sint8
+    BOOST_CHECK(encode_typed(json::array{-1,127}) == std::vector<uint8_t>({0xd8,0x48,0x42,0xff,0x7f}));
+    // sint16 little endian
+    BOOST_CHECK(encode_typed(json::array{-129,1}) == std::vector<uint8_t>({0xd8,0x4d,0x44,0x7f,0xff,0x01,0x00}));
+    // float32 little endian
+    BOOST_CHECK(encode_typed(json::array{1.5,-2.0}) == std::vector<uint8_t>({0xd8,0x55,0x48,0x00,0x00,0xc0,0x3f,0x00,0x00,0x00,0xc0}));
+    // float64 little endian, 0.1 isn't exact as a float
+    BOOST_CHECK(encode_typed(json::array{0.1}) == std::vector<uint8_t>({0xd8,0x56,0x48,0x9a,0x99,0x99,0x99,0x99,0x99,0xb9,0x3f}));
+}
+
+BOOST_AUTO_TEST_CASE(encode_falls_back_to_regular_arrays)
+{
+    json mixed = json::array{1, 2.5};
+    BOOST_CHECK(encode_typed(mixed) == encode_cbor(mixed));
+
+    json strings = json::array{"a", "b"};
+    BOOST_CHECK(encode_typed(strings) == encode_cbor(strings));
+
+    json empty = json::array();
+    BOOST_CHECK(encode_typed(empty) == std::vector<uint8_t>({0x80}));
+
+    json out_of_range = json::array{-1, (std::numeric_limits<uint64_t>::max)()};
+    BOOST_CHECK(encode_typed(out_of_range) == encode_cbor(out_of_range));
+}
+
+BOOST_AUTO_TEST_CASE(round_trip_each_element_type)
+{
+    std::vector<json> arrays = {
+        json::array{0, 200},
+        json::array{0, 60000},
+        json::array{0, 4000000000},
+        json::array{0, (std::numeric_limits<uint64_t>::max)()},
+        json::array{-100, 100},
+        json::array{-30000, 30000},
+        json::array{-2000000000, 2000000000},
+        json::array{(std::numeric_limits<int64_t>::min)(), (std::numeric_limits<int64_t>::max)()},
+        json::array{0.5, -1024.25},
+        json::array{0.1, 1e300}
+    };
+    for (const auto& a : arrays)
+    {
+        std::vector<uint8_t> v = encode_typed(a);
+        BOOST_CHECK_EQUAL(0xd8, v[0]);
+        BOOST_CHECK_EQUAL(a, decode_cbor<json>(v));
+        BOOST_CHECK_EQUAL(a, parse_in_pieces(v, 1));
+        BOOST_CHECK_EQUAL(a, cbor_view(v).as_json<json>());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(typed_arrays_in_documents)
+{
+    json doc = json::parse(R"(
+    {
+        "readings": [1.5, 2.25, -3.0],
+        "ids": [7, 4096, 65535],
+        "names": ["a", "b"],
+        "nested": [[1, 2], [3, -4]]
+    }
+    )");
+    std::vector<uint8_t> v = encode_typed(doc);
+    BOOST_CHECK(v.size() < encode_cbor(doc).size());
+    BOOST_CHECK_EQUAL(cbor_Encoder_<json>::calculate_size(doc, cbor_options().enable_typed_arrays(true)), v.size());
+    BOOST_CHECK_EQUAL(doc, decode_cbor<json>(v));
+    BOOST_CHECK_EQUAL(doc, parse_in_pieces(v, 3));
+
+    std::string s(v.begin(), v.end());
+    std::istringstream is(s);
+    BOOST_CHECK_EQUAL(doc, decode_cbor<json>(is));
+
+    cbor_view view(v);
+    BOOST_CHECK(view["ids"].is_typed_array());
+    BOOST_CHECK(!view["names"].is_typed_array());
+    BOOST_CHECK_EQUAL(3, view["ids"].size());
+    BOOST_CHECK_EQUAL(doc["nested"], view["nested"].as_json<json>());
+}
+
+BOOST_AUTO_TEST_CASE(large_typed_array)
+{
+    json a = json::array();
+    for (int i = 0; i < 1000; ++i)
+    {
+        a.push_back(i * 1000);
+    }
+    std::vector<uint8_t> v = encode_typed(a);
+    // tag, 0x59 and a two byte length, then 1000 uint32 elements
+    BOOST_CHECK_EQUAL(4 + 4000 + 1, v.size());
+    BOOST_CHECK_EQUAL(0x59, v[2]);
+    BOOST_CHECK_EQUAL(a, decode_cbor<json>(v));
+    BOOST_CHECK_EQUAL(a, parse_in_pieces(v, 7));
+
+    std::vector<uint32_t> elements = cbor_view(v).as<std::vector<uint32_t>>();
+    BOOST_REQUIRE_EQUAL(1000, elements.size());
+    BOOST_CHECK_EQUAL(999000, elements[999]);
+}
+
+BOOST_AUTO_TEST_CASE(decode_big_endian_tags)
+{
+    // uint16 big endian
+    std::vector<uint8_t> u16 = {0xd8,0x41,0x44,0x01,0x00,0x00,0x02};
+    BOOST_CHECK_EQUAL(json(json::array{256, 2}), decode_cbor<json>(u16));
+    BOOST_CHECK_EQUAL(json(json::array{256, 2}), parse_in_pieces(u16, 2));
+
+    // sint32 big endian
+    std::vector<uint8_t> s32 = {0xd8,0x4a,0x44,0xff,0xff,0xff,0xfe};
+    BOOST_CHECK_EQUAL(json(json::array{-2}), decode_cbor<json>(s32));
+
+    // float64 big endian
+    std::vector<uint8_t> f64 = {0xd8,0x52,0x48,0x3f,0xf8,0x00,0x00,0x00,0x00,0x00,0x00};
+    BOOST_CHECK_EQUAL(json(json::array{1.5}), decode_cbor<json>(f64));
+
+    // float16 little endian
+    std::vector<uint8_t> f16 = {0xd8,0x54,0x42,0x00,0x3c};
+    BOOST_CHECK_EQUAL(json(json::array{1.0}), decode_cbor<json>(f16));
+    BOOST_CHECK_EQUAL(json(json::array{1.0}), cbor_view(f16).as_json<json>());
+
+    std::vector<int32_t> elements = cbor_view(s32).as<std::vector<int32_t>>();
+    BOOST_REQUIRE_EQUAL(1, elements.size());
+    BOOST_CHECK_EQUAL(-2, elements[0]);
+
+    std::vector<double> converted = cbor_view(u16).as<std::vector<double>>();
+    BOOST_REQUIRE_EQUAL(2, converted.size());
+    BOOST_CHECK_EQUAL(256.0, converted[0]);
+}
+
+BOOST_AUTO_TEST_CASE(view_fills_vectors)
+{
+    json a = json::array{1.5, -2.0, 4.0};
+    std::vector<uint8_t> typed = encode_typed(a);
+    std::vector<uint8_t> regular = encode_cbor(a);
+
+    std::vector<float> f = cbor_view(typed).as<std::vector<float>>();
+    BOOST_CHECK(f == std::vector<float>({1.5f, -2.0f, 4.0f}));
+
+    std::vector<double> d = cbor_view(regular).as<std::vector<double>>();
+    BOOST_CHECK(d == std::vector<double>({1.5, -2.0, 4.0}));
+
+    std::vector<uint8_t> not_array = encode_cbor(json("x"));
+    BOOST_CHECK_THROW(cbor_view(not_array).as<std::vector<int>>(), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(view_navigates_typed_arrays)
+{
+    // uint16 big endian, sint8, float32 little endian, and sint64 little endian
+    std::vector<uint8_t> u16 = {0xd8,0x41,0x44,0x01,0x00,0x00,0x02};
+    std::vector<uint8_t> s8 = {0xd8,0x48,0x43,0xff,0x00,0x80};
+    std::vector<uint8_t> f32 = encode_typed(json::array{1.5,-2.0});
+    std::vector<uint8_t> s64 = encode_typed(json::array{(std::numeric_limits<int64_t>::min)(), 1});
+
+    cbor_view view(u16);
+    BOOST_CHECK(view.is_array());
+    BOOST_CHECK(view.is_typed_array());
+    BOOST_CHECK_EQUAL(2, view.size());
+    BOOST_CHECK(view[0].is_uinteger());
+    BOOST_CHECK_EQUAL(256, view[0].as<int>());
+    BOOST_CHECK_EQUAL(2, view.at(1).as_uinteger());
+    BOOST_CHECK_THROW(view.at(2), std::out_of_range);
+
+    cbor_view signed_view(s8);
+    BOOST_CHECK_EQUAL(-1, signed_view[0].as_integer());
+    BOOST_CHECK_EQUAL(0, signed_view[1].as_integer());
+    BOOST_CHECK_EQUAL(-128, signed_view[2].as_integer());
+    BOOST_CHECK_EQUAL(json(-128), signed_view[2].as_json<json>());
+
+    cbor_view float_view(f32);
+    BOOST_CHECK(float_view[1].is_double());
+    BOOST_CHECK_EQUAL(-2.0, float_view[1].as_double());
+
+    cbor_view large_view(s64);
+    BOOST_CHECK_EQUAL((std::numeric_limits<int64_t>::min)(), large_view[0].as_integer());
+
+    std::vector<int> elements;
+    for (const auto& item : signed_view.array_range())
+    {
+        elements.push_back(item.as<int>());
+    }
+    BOOST_CHECK(elements == std::vector<int>({-1, 0, -128}));
+
+    // An element copied from a temporary view keeps its value
+    cbor_view element = float_view[0];
+    cbor_view copy = element;
+    element = float_view[1];
+    BOOST_CHECK_EQUAL(1.5, copy.as_double());
+    BOOST_CHECK_EQUAL(-2.0, element.as_double());
+
+    // Typed arrays inside a document
+    json doc = json::parse(R"({"ids": [7, 4096, 65535], "names": ["a", "b"]})");
+    std::vector<uint8_t> v = encode_typed(doc);
+    cbor_view ids = cbor_view(v)["ids"];
+    BOOST_CHECK(ids.is_array());
+    BOOST_CHECK_EQUAL(4096, ids[1].as<int>());
+    size_t count = 0;
+    for (auto it = ids.array_range().begin(); it != ids.array_range().end(); ++it)
+    {
+        BOOST_CHECK_EQUAL(doc["ids"][count], (*it).as_json<json>());
+        ++count;
+    }
+    BOOST_CHECK_EQUAL(3, count);
+}
+
+BOOST_AUTO_TEST_CASE(invalid_typed_arrays)
+{
+    // length not a multiple of the element size
+    std::vector<uint8_t> ragged = {0xd8,0x45,0x43,0x01,0x00,0x02};
+    BOOST_CHECK_THROW(decode_cbor<json>(ragged), std::exception);
+    std::error_code ec;
+    json_decoder<json> decoder;
+    cbor_parser parser(decoder);
+    parser.set_source(ragged.data(), ragged.size());
+    parser.parse(ec);
+    BOOST_CHECK(ec == cbor_parser_errc::invalid_typed_array);
+    BOOST_CHECK_THROW(cbor_view(ragged).size(), parse_error);
+
+    // tag not followed by a byte string
+    std::vector<uint8_t> not_bytes = {0xd8,0x40,0x01};
+    BOOST_CHECK_THROW(decode_cbor<json>(not_bytes), std::exception);
+    ec = std::error_code();
+    cbor_parser parser2(decoder);
+    parser2.set_source(not_bytes.data(), not_bytes.size());
+    parser2.parse(ec);
+    BOOST_CHECK(ec == cbor_parser_errc::invalid_typed_array);
+
+    // truncated payload
+    std::vector<uint8_t> truncated = {0xd8,0x40,0x43,0x01};
+    BOOST_CHECK_THROW(decode_cbor<json>(truncated), std::exception);
+    ec = std::error_code();
+    cbor_parser parser3(decoder);
+    parser3.set_source(truncated.data(), truncated.size());
+    parser3.parse(ec);
+    BOOST_CHECK(!ec);
+    parser3.end_parse(ec);
+    BOOST_CHECK(ec == cbor_parser_errc::unexpected_eof);
+
+    // other tags are still unsupported
+    std::vector<uint8_t> other_tag = {0xd8,0x20,0x61,0x61};
+    BOOST_CHECK_THROW(decode_cbor<json>(other_tag), std::exception);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,139 @@
+// Copyright 2017 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/cbor/cbor.hpp>
+#include <sstream>
+#include <vector>
+#include <utility>
+#include <limits>
+
+using namespace jsoncons;
+using namespace jsoncons::cbor;
+
+BOOST_AUTO_TEST_SUITE(cbor_view_tests)
+
+namespace {
+
+const ojson doc = ojson::parse(R"(
+{
+    "name": "Moby Dick é中",
+    "count": 3,
+    "tags": ["whale", "sea", "classic"],
+    "meta": {"price": 8.99, "stock": -12, "big": 18446744073709551615, "ok": true, "isbn": null},
+    "empty": [],
+    "nested": [[1, [2, [3, {"deep": "yes"}]]], {}]
+}
+)");
+
+std::vector<uint8_t> indefinite_encoding(const ojson& val)
+{
+    std::vector<uint8_t> v;
+    cbor_serializer serializer(v);
+    val.dump(serializer);
+    return v;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(test_cbor_view_navigation)
+{
+    std::vector<std::vector<uint8_t>> encodings = {encode_cbor(doc), indefinite_encoding(doc)};
+    for (const auto& v : encodings)
+    {
+        cbor_view root(v);
+        BOOST_REQUIRE(root.is_object());
+        BOOST_CHECK_EQUAL(6, root.size());
+        BOOST_CHECK(root["name"].as_string() == "Moby Dick é中");
+        BOOST_CHECK(root["name"].as<std::string>() == "Moby Dick é中");
+        BOOST_CHECK_EQUAL(3, root["count"].as<int>());
+        BOOST_CHECK(root["tags"].is_array());
+        BOOST_CHECK_EQUAL(3, root["tags"].size());
+        BOOST_CHECK(root["tags"][2].as_string() == "classic");
+        BOOST_CHECK_EQUAL(8.99, root["meta"]["price"].as<double>());
+        BOOST_CHECK_EQUAL(-12, root["meta"]["stock"].as_integer());
+        BOOST_CHECK(root["meta"]["stock"].is_integer());
+        BOOST_CHECK(!root["meta"]["big"].is_integer());
+        BOOST_CHECK((std::numeric_limits<uint64_t>::max)() == root["meta"]["big"].as<uint64_t>());
+        BOOST_CHECK(root["meta"]["ok"].as<bool>());
+        BOOST_CHECK(root["meta"]["isbn"].is_null());
+        BOOST_CHECK(root["empty"].empty());
+        BOOST_CHECK(root["nested"][0][1][1][1]["deep"].as_string() == "yes");
+        BOOST_CHECK(root["nested"][1].is_object());
+        BOOST_CHECK(root.has_key("meta"));
+        BOOST_CHECK(!root.has_key("none"));
+        BOOST_CHECK_THROW(root.at("none"), std::out_of_range);
+        BOOST_CHECK_THROW(root["tags"].at(3), std::out_of_range);
+        BOOST_CHECK_THROW(root["count"].as_string(), std::runtime_error);
+
+        std::vector<std::string> keys;
+        for (const auto& member : root.object_range())
+        {
+            keys.push_back(member.key());
+            BOOST_CHECK(member.value().as_json<ojson>() == doc[member.key()]);
+        }
+        BOOST_CHECK(keys == std::vector<std::string>({"name","count","tags","meta","empty","nested"}));
+
+        std::vector<std::string> tags;
+        for (const auto& tag : root["tags"].array_range())
+        {
+            tags.push_back(tag.as_string());
+        }
+        BOOST_CHECK(tags == std::vector<std::string>({"whale","sea","classic"}));
+
+        BOOST_CHECK(root.as_json<ojson>() == doc);
+        BOOST_CHECK_EQUAL(v.size(), root.encoded_size());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_cbor_view_string_in_place)
+{
+    std::vector<uint8_t> v = encode_cbor(doc);
+    cbor_view root(v);
+    auto sv = root["tags"][1].as<cbor_view::string_view_type>();
+    BOOST_CHECK(sv == "sea");
+    BOOST_CHECK(reinterpret_cast<const uint8_t*>(sv.data()) > v.data());
+    BOOST_CHECK(reinterpret_cast<const uint8_t*>(sv.data()) < v.data() + v.size());
+}
+
+BOOST_AUTO_TEST_CASE(test_cbor_view_chunks_and_tags)
+{
+    // {"a": <indefinite "Hel">, "b": tag 1 (1.5), "c": [half 1.0]}
+    std::vector<uint8_t> v = {0xa3,
+                              0x61,'a',0x7f,0x61,'H',0x62,'e','l',0xff,
+                              0x61,'b',0xc1,0xfa,0x3f,0xc0,0,0,
+                              0x61,'c',0x81,0xf9,0x3c,0x00};
+    cbor_view root(v);
+    BOOST_CHECK(root["a"].as_string() == "Hel");
+    BOOST_CHECK_THROW(root["a"].as_string_view(), std::runtime_error);
+    BOOST_CHECK_EQUAL(1.5, root["b"].as_double());
+    BOOST_CHECK_EQUAL(1.0, root["c"][0].as_double());
+}
+
+BOOST_AUTO_TEST_CASE(test_cbor_view_malformed)
+{
+    std::vector<uint8_t> truncated = encode_cbor(doc);
+    truncated.resize(truncated.size() - 3);
+    cbor_view root(truncated);
+    BOOST_CHECK(root["name"].as_string() == "Moby Dick é中");
+    BOOST_CHECK_THROW(root["nested"][1], parse_error);
+
+    std::vector<uint8_t> empty;
+    BOOST_CHECK_THROW(cbor_view view(empty), parse_error);
+
+    std::vector<uint8_t> bad_length = {0x82, 0x61, 'a', 0x7a, 0xff, 0xff, 0xff, 0xff};
+    cbor_view view(bad_length);
+    BOOST_CHECK(view[0].as_string() == "a");
+    BOOST_CHECK_THROW(view[1].as_string(), parse_error);
+    BOOST_CHECK_THROW(view.encoded_size(), parse_error);
+
+    std::vector<uint8_t> bad_utf8 = {0x62, 0xc3, 0x28};
+    BOOST_CHECK_THROW(cbor_view(bad_utf8).as_string(), parse_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
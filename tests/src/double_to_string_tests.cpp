@@ -12,6 +12,7 @@
 #include <vector>
 #include <utility>
 #include <ctime>
+#include <cmath>
 
 using namespace jsoncons;
 
@@ -173,5 +174,53 @@ BOOST_AUTO_TEST_CASE(test_double_to_wstring)
     s = float_to_string<wchar_t>(x, options.precision());
     BOOST_CHECK(s == std::wstring(L"-11.0"));
 }
+
+BOOST_AUTO_TEST_CASE(test_shortest_round_trip)
+{
+    BOOST_CHECK_EQUAL(std::string("0.30000000000000004"), float_to_string<char>(0.1+0.2, 0));
+    BOOST_CHECK_EQUAL(std::string("0.1"), float_to_string<char>(0.1, 0));
+    BOOST_CHECK_EQUAL(std::string("1.0e+23"), float_to_string<char>(1.0e23, 0));
+    BOOST_CHECK_EQUAL(std::string("1.7976931348623157e+308"), float_to_string<char>((std::numeric_limits<double>::max)(), 0));
+    BOOST_CHECK_EQUAL(std::string("2.2250738585072014e-308"), float_to_string<char>((std::numeric_limits<double>::min)(), 0));
+    BOOST_CHECK_EQUAL(std::string("5.0e-324"), float_to_string<char>(std::numeric_limits<double>::denorm_min(), 0));
+    BOOST_CHECK_EQUAL(std::string("123456789012345.0"), float_to_string<char>(123456789012345.0, 0));
+    BOOST_CHECK_EQUAL(std::string("-0.0"), float_to_string<char>(-0.0, 0));
+
+    std::vector<double> values = {0.1, 1.0/3.0, 2.0/3.0, 1e-7, 123.456, 9007199254740993.0, 4.9406564584124654e-324, 1.7976931348623157e308};
+    for (double x : values)
+    {
+        std::string s = float_to_string<char>(x, 0);
+        BOOST_CHECK_EQUAL(x, json::parse(s).as<double>());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_precision_rounding)
+{
+    // Exact value 0.299999999999999988897769753748...
+    BOOST_CHECK_EQUAL(std::string("0.29999999999999999"), float_to_string<char>(0.3, 17));
+    BOOST_CHECK_EQUAL(std::string("0.3"), float_to_string<char>(0.3, 16));
+    // Exact value 0.125 is halfway, ties go to even
+    BOOST_CHECK_EQUAL(std::string("0.12"), float_to_string<char>(0.125, 2));
+    // Shortest digits 2.675 are halfway, exact value 2.67499999999999982236431605997495353221893310546875
+    BOOST_CHECK_EQUAL(std::string("2.67"), float_to_string<char>(2.675, 3));
+    BOOST_CHECK_EQUAL(std::string("1.0e+16"), float_to_string<char>(9999999999999999.0, 15));
+    BOOST_CHECK_EQUAL(std::string("0.0001"), float_to_string<char>(0.0001, 15));
+    BOOST_CHECK_EQUAL(std::string("1.0e-05"), float_to_string<char>(0.00001, 15));
+    BOOST_CHECK_EQUAL(std::string("0.1000000000000000055511151231"), float_to_string<char>(0.1, 28));
+}
+
+BOOST_AUTO_TEST_CASE(test_precision_powers_of_two)
+{
+    // The shortest digits have 16 digits, but the closest 16 digits are
+    // below the interval that reads back as a power of two
+    BOOST_CHECK_EQUAL(std::string("6.310887241768094e-30"), float_to_string<char>(std::ldexp(1.0,-97), 16));
+    BOOST_CHECK_EQUAL(std::string("7.120236347223044e-307"), float_to_string<char>(std::ldexp(1.0,-1017), 16));
+    BOOST_CHECK_EQUAL(std::string("7.67844768714563e-239"), float_to_string<char>(std::ldexp(1.0,-791), 16));
+    BOOST_CHECK_EQUAL(std::string("6.083493012144511e-210"), float_to_string<char>(std::ldexp(1.0,-695), 16));
+
+    json j(std::ldexp(1.0,-97));
+    BOOST_CHECK_EQUAL(std::string("6.310887241768094e-30"), j.to_string(serialization_options().precision(16)));
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
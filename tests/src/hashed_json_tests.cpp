@@ -0,0 +1,72 @@
+// Copyright 2017 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <sstream>
+#include <vector>
+#include <utility>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(hashed_json_tests)
+
+BOOST_AUTO_TEST_CASE(test_hashed_json_build)
+{
+    const size_t n = 10000;
+    hashed_json j;
+    for (size_t i = 0; i < n; ++i)
+    {
+        j.insert_or_assign("setting" + std::to_string(i), i);
+    }
+    BOOST_CHECK_EQUAL(n, j.size());
+    size_t i = 0;
+    for (const auto& member : j.object_range())
+    {
+        BOOST_CHECK(member.key() == "setting" + std::to_string(i));
+        BOOST_CHECK_EQUAL(i, member.value().as<size_t>());
+        ++i;
+    }
+    BOOST_CHECK(j.find("setting42") != j.object_range().end());
+    BOOST_CHECK(j.find("setting10000") == j.object_range().end());
+
+    j.erase("setting0");
+    BOOST_CHECK(!j.has_key("setting0"));
+    BOOST_CHECK_EQUAL(n - 1, j.at("setting9999").as<size_t>());
+}
+
+BOOST_AUTO_TEST_CASE(test_hashed_json_small_objects)
+{
+    hashed_json j = hashed_json::parse(R"({"b":1,"a":2,"b":3})");
+    BOOST_CHECK_EQUAL(2, j.size());
+    BOOST_CHECK(j.object_range().begin()->key() == "a");
+    BOOST_CHECK_EQUAL(3, j["b"].as<int>());
+
+    j.erase("a");
+    j.erase("b");
+    BOOST_CHECK(j.empty());
+    BOOST_CHECK(!j.has_key("a"));
+    j["c"] = 4;
+    BOOST_CHECK_EQUAL(4, j.at("c").as<int>());
+}
+
+BOOST_AUTO_TEST_CASE(test_hashed_json_serialize)
+{
+    std::string s = R"({"zebra":1,"apple":{"y":[1,2],"x":null},"mango":"m"})";
+    hashed_json j = hashed_json::parse(s);
+    std::ostringstream os;
+    os << j;
+    BOOST_CHECK(os.str() == s);
+
+    hashed_json other = hashed_json::parse(R"({"mango":"m","apple":{"x":null,"y":[1,2]},"zebra":1})");
+    BOOST_CHECK(j == other);
+}
+
+BOOST_AUTO_TEST_CASE(test_whashed_json)
+{
+    whashed_json j = whashed_json::parse(L"{\"b\":1,\"a\":2}");
+    BOOST_CHECK(j.object_range().begin()->key() == L"b");
+    BOOST_CHECK_EQUAL(2, j[L"a"].as<int>());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
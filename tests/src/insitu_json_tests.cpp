@@ -0,0 +1,102 @@
+// Copyright 2017 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <sstream>
+#include <vector>
+#include <utility>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(insitu_json_tests)
+
+namespace {
+
+bool in_buffer(const std::vector<char>& buffer, const char* p)
+{
+    return p >= buffer.data() && p < buffer.data() + buffer.size();
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_insitu)
+{
+    std::string s = R"({"a member name that is long":"a string value that is too long to be small",
+                        "escaped \u0041 name":"tab\tquote\"unicode\u00e9\ud83d\ude00 end",
+                        "array":[1,"x","",true,null,2.5],
+                        "short":"abc"})";
+    std::vector<char> buffer(s.begin(), s.end());
+
+    insitu_json j = insitu_json::parse_insitu(buffer.data(), buffer.size());
+    BOOST_CHECK(j == insitu_json::parse(s));
+
+    BOOST_CHECK(j["a member name that is long"].as<std::string>() == "a string value that is too long to be small");
+    BOOST_CHECK(j["escaped A name"].as<std::string>() == "tab\tquote\"unicode\xC3\xA9\xF0\x9F\x98\x80 end");
+    BOOST_CHECK(j["array"][2].as<std::string>() == "");
+    BOOST_CHECK(j["short"].as<std::string>() == "abc");
+
+    // Long strings and all member names refer to the buffer
+    BOOST_CHECK(in_buffer(buffer, j.at("a member name that is long").as_cstring()));
+    BOOST_CHECK(in_buffer(buffer, j.at("escaped A name").as_cstring()));
+    for (const auto& member : j.object_range())
+    {
+        BOOST_CHECK(in_buffer(buffer, member.key().data()));
+        BOOST_CHECK_EQUAL(0, member.key().data()[member.key().length()]);
+    }
+    BOOST_CHECK_EQUAL(0, j.at("escaped A name").as_cstring()[j.at("escaped A name").as_string_view().length()]);
+}
+
+BOOST_AUTO_TEST_CASE(test_insitu_json_modify)
+{
+    std::string s = R"({"a member name that is long":"a string value that is too long to be small"})";
+    std::vector<char> buffer(s.begin(), s.end());
+    insitu_json j = insitu_json::parse_insitu(buffer.data(), buffer.size());
+
+    insitu_json copy = j;
+    std::string key = "an added member name that is long";
+    copy[key] = std::string("an added string value that is quite long");
+    key.assign(key.size(), 'x');
+    copy["a member name that is long"] = "replaced";
+
+    BOOST_CHECK_EQUAL(1, j.size());
+    BOOST_CHECK_EQUAL(2, copy.size());
+    BOOST_CHECK(copy["an added member name that is long"].as<std::string>() == "an added string value that is quite long");
+    BOOST_CHECK(copy["a member name that is long"].as<std::string>() == "replaced");
+    BOOST_CHECK(j["a member name that is long"].as<std::string>() == "a string value that is too long to be small");
+
+    std::ostringstream os;
+    os << j;
+    BOOST_CHECK(os.str() == s);
+}
+
+BOOST_AUTO_TEST_CASE(test_json_parse_insitu)
+{
+    // With the default traits the strings are copied
+    std::string s = R"(["a string value that is too long to be small","\u00e9\n"])";
+    std::vector<char> buffer(s.begin(), s.end());
+    json j = json::parse_insitu(buffer.data(), buffer.size());
+    std::fill(buffer.begin(), buffer.end(), 'z');
+    BOOST_CHECK(j == json::parse(s));
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_insitu_errors)
+{
+    std::string s = R"({"a":"b",})";
+    std::vector<char> buffer(s.begin(), s.end());
+    BOOST_CHECK_THROW(insitu_json::parse_insitu(buffer.data(), buffer.size()), parse_error);
+
+    std::string s2 = R"(["abc)";
+    std::vector<char> buffer2(s2.begin(), s2.end());
+    BOOST_CHECK_THROW(insitu_json::parse_insitu(buffer2.data(), buffer2.size()), parse_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_winsitu_json)
+{
+    std::wstring s = L"{\"a wide member name\":\"a wide string value \\u00e9\"}";
+    std::vector<wchar_t> buffer(s.begin(), s.end());
+    winsitu_json j = winsitu_json::parse_insitu(buffer.data(), buffer.size());
+    BOOST_CHECK(j[L"a wide member name"].as<std::wstring>() == L"a wide string value \u00e9");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
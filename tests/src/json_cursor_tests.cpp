@@ -0,0 +1,159 @@
+// Copyright 2017 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_cursor.hpp>
+#include <sstream>
+#include <vector>
+#include <utility>
+#include <ctime>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(json_cursor_tests)
+
+BOOST_AUTO_TEST_CASE(test_cursor_events)
+{
+    std::string s = R"({"a":"hello","b":-10,"c":10,"d":1.5,"e":true,"f":null,"g":[1,2]})";
+    json_cursor cursor(s);
+
+    std::vector<json_event_type> expected = {
+        json_event_type::begin_object,
+        json_event_type::name, json_event_type::string_value,
+        json_event_type::name, json_event_type::integer_value,
+        json_event_type::name, json_event_type::uinteger_value,
+        json_event_type::name, json_event_type::double_value,
+        json_event_type::name, json_event_type::bool_value,
+        json_event_type::name, json_event_type::null_value,
+        json_event_type::name, json_event_type::begin_array,
+        json_event_type::uinteger_value, json_event_type::uinteger_value,
+        json_event_type::end_array,
+        json_event_type::end_object
+    };
+
+    std::vector<json_event_type> actual;
+    for (; !cursor.done(); cursor.next())
+    {
+        const json_event& event = cursor.current_event();
+        actual.push_back(event.event_type());
+        switch (event.event_type())
+        {
+        case json_event_type::string_value:
+            BOOST_CHECK(event.as_string_view() == json_cursor::string_view_type("hello"));
+            break;
+        case json_event_type::integer_value:
+            BOOST_CHECK_EQUAL(-10, event.as_integer());
+            break;
+        case json_event_type::double_value:
+            BOOST_CHECK_EQUAL(1.5, event.as_double());
+            BOOST_CHECK_EQUAL(2, event.precision());
+            break;
+        case json_event_type::bool_value:
+            BOOST_CHECK(event.as_bool());
+            break;
+        default:
+            break;
+        }
+    }
+    BOOST_CHECK(expected == actual);
+}
+
+BOOST_AUTO_TEST_CASE(test_cursor_skip)
+{
+    std::string big(20000, 'x');
+    for (const std::string& filler : {std::string("w"), big})
+    {
+        // Skipped content that spans several reads
+        std::string s = R"({"skipped":{"x":[1,{"y":[]}],"z":")" + filler + R"("},"wanted":"yes","after":[[1],[2]]})";
+
+        std::istringstream is(s);
+        json_cursor cursor(is);
+
+        BOOST_CHECK(cursor.current_event().event_type() == json_event_type::begin_object);
+        cursor.next();
+        BOOST_CHECK(cursor.current_event().as_string() == "skipped");
+        cursor.next();
+        BOOST_CHECK(cursor.current_event().event_type() == json_event_type::begin_object);
+        cursor.skip();
+        BOOST_CHECK(cursor.current_event().event_type() == json_event_type::end_object);
+        cursor.next();
+        BOOST_CHECK(cursor.current_event().as_string() == "wanted");
+        cursor.next();
+        BOOST_CHECK(cursor.current_event().as_string() == "yes");
+        cursor.next();
+        BOOST_CHECK(cursor.current_event().as_string() == "after");
+        cursor.next();
+        cursor.skip();
+        BOOST_CHECK(cursor.current_event().event_type() == json_event_type::end_array);
+        cursor.next();
+        BOOST_CHECK(cursor.current_event().event_type() == json_event_type::end_object);
+        cursor.next();
+        BOOST_CHECK(cursor.done());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_cursor_scalar)
+{
+    std::string s = "  42  ";
+    json_cursor cursor(s);
+    BOOST_REQUIRE(!cursor.done());
+    BOOST_CHECK(cursor.current_event().event_type() == json_event_type::uinteger_value);
+    BOOST_CHECK_EQUAL(42, cursor.current_event().as_uinteger());
+    cursor.next();
+    BOOST_CHECK(cursor.done());
+}
+
+BOOST_AUTO_TEST_CASE(test_cursor_stops_early)
+{
+    // Nothing after the first member is looked at
+    std::string s = R"({"id":7,"rest":[1,2,)";
+    json_cursor cursor(s);
+    cursor.next();
+    cursor.next();
+    BOOST_CHECK_EQUAL(7, cursor.current_event().as_integer());
+}
+
+BOOST_AUTO_TEST_CASE(test_cursor_error)
+{
+    std::string s = R"({"a":[1,2})";
+    json_cursor cursor(s);
+    std::error_code ec;
+    while (!cursor.done() && !ec)
+    {
+        cursor.next(ec);
+    }
+    BOOST_CHECK(ec == json_parser_errc::expected_comma_or_right_bracket);
+
+    std::string s2 = "[1,";
+    json_cursor cursor2(s2);
+    BOOST_CHECK_THROW(while (!cursor2.done()) cursor2.next(), parse_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_cursor_bom)
+{
+    std::string s = "\xEF\xBB\xBF[1]";
+    json_cursor cursor(s);
+    BOOST_CHECK(cursor.current_event().event_type() == json_event_type::begin_array);
+
+    // A UTF-16 byte order mark in 8 bit text
+    std::string u16("\xFF\xFE[\x00""1\x00]\x00", 8);
+    BOOST_CHECK_THROW(json_cursor cursor2(u16), parse_error);
+
+    std::error_code ec;
+    json_cursor cursor3(u16, ec);
+    BOOST_CHECK(ec == unicons::encoding_errc::expected_u8_found_u16);
+}
+
+BOOST_AUTO_TEST_CASE(test_wcursor)
+{
+    std::wstring s = L"[\"été\",2.25]";
+    wjson_cursor cursor(s);
+    cursor.next();
+    BOOST_CHECK(cursor.current_event().as_string() == L"été");
+    cursor.next();
+    BOOST_CHECK_EQUAL(2.25, cursor.current_event().as_double());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
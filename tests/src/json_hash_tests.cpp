@@ -0,0 +1,96 @@
+// Copyright 2017 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <sstream>
+#include <vector>
+#include <unordered_set>
+#include <utility>
+#include <type_traits>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(json_hash_tests)
+
+namespace {
+
+template <class T, class Enable = void>
+struct has_hash_value : std::false_type {};
+
+template <class T>
+struct has_hash_value<T,decltype(static_cast<void>(hash_value(std::declval<const T&>())))> : std::true_type {};
+
+}
+
+BOOST_AUTO_TEST_CASE(test_equal_values_hash_alike)
+{
+    std::hash<json> hasher;
+
+    BOOST_CHECK(hasher(json(1)) == hasher(json(1.0)));
+    BOOST_CHECK(hasher(json(1)) == hasher(json(1u)));
+    BOOST_CHECK(hasher(json(0.0)) == hasher(json(-0.0)));
+    BOOST_CHECK(hasher(json("short")) == hasher(json(std::string("short"))));
+    BOOST_CHECK(hasher(json::object()) == hasher(json::parse("{}")));
+
+    BOOST_CHECK(hasher(json(1)) != hasher(json(2)));
+    BOOST_CHECK(hasher(json("1")) != hasher(json(1)));
+    BOOST_CHECK(hasher(json::null()) != hasher(json(false)));
+    BOOST_CHECK(hasher(json::parse("[1,2]")) != hasher(json::parse("[2,1]")));
+    BOOST_CHECK(hasher(json::parse("[[]]")) != hasher(json::parse("[]")));
+    BOOST_CHECK(hasher(json::parse(R"({"a":1,"b":2})")) != hasher(json::parse(R"({"a":2,"b":1})")));
+
+    // Objects that preserve order hash independently of the order
+    ojson a = ojson::parse(R"({"a":1,"b":[true,null]})");
+    ojson b = ojson::parse(R"({"b":[true,null],"a":1})");
+    BOOST_CHECK(a == b);
+    BOOST_CHECK(std::hash<ojson>()(a) == std::hash<ojson>()(b));
+
+    BOOST_CHECK(std::hash<wjson>()(wjson::parse(L"[\"x\"]")) == std::hash<wjson>()(wjson::parse(L"[ \"x\" ]")));
+}
+
+BOOST_AUTO_TEST_CASE(test_unordered_set)
+{
+    std::unordered_set<json> documents;
+    documents.insert(json::parse(R"({"id":1,"tags":["a","b"]})"));
+    documents.insert(json::parse(R"({"tags":["a","b"],"id":1.0})"));
+    documents.insert(json::parse(R"({"id":1,"tags":["b","a"]})"));
+    BOOST_CHECK_EQUAL(2, documents.size());
+}
+
+BOOST_AUTO_TEST_CASE(test_json_hash_cache)
+{
+    const json doc = json::parse(R"(
+    {
+        "a": {"x": [1, 2, 3], "y": {"z": "w"}},
+        "b": {"x": [1, 2, 3], "y": {"z": "w"}},
+        "c": {"x": [1, 2, 4], "y": {"z": "w"}}
+    }
+    )");
+
+    json_hash_cache<json> cache;
+    BOOST_CHECK(cache.hash(doc) == hash_value(doc));
+    BOOST_CHECK_EQUAL(10, cache.size());
+
+    BOOST_CHECK(cache.equal(doc["a"], doc["b"]));
+    BOOST_CHECK(!cache.equal(doc["a"], doc["c"]));
+    BOOST_CHECK(cache.equal(doc["a"]["y"], doc["c"]["y"]));
+    BOOST_CHECK(cache.hash(doc["c"]["x"]) == hash_value(json::parse("[1,2,4]")));
+    BOOST_CHECK_EQUAL(10, cache.size());
+
+    cache.clear();
+    BOOST_CHECK_EQUAL(0, cache.size());
+}
+
+BOOST_AUTO_TEST_CASE(test_hash_value_only_for_json)
+{
+    // hash_value is found by argument dependent lookup, as boost::hash
+    // does, for json values but not for other jsoncons types
+    BOOST_CHECK(has_hash_value<json>::value);
+    BOOST_CHECK(has_hash_value<ojson>::value);
+    BOOST_CHECK(has_hash_value<wjson>::value);
+    BOOST_CHECK(!has_hash_value<serialization_options>::value);
+    BOOST_CHECK(!has_hash_value<json::object_iterator>::value);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,154 @@
+// Copyright 2017 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_lines_reader.hpp>
+#include <sstream>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(json_lines_reader_tests)
+
+namespace {
+
+std::string make_lines(size_t n)
+{
+    std::string s;
+    for (size_t i = 0; i < n; ++i)
+    {
+        s += "{\"id\":" + std::to_string(i) + ",\"name\":\"record " + std::to_string(i) + "\",\"tags\":[1,2,3]}\n";
+    }
+    return s;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(test_ordered_delivery)
+{
+    const size_t n = 5000;
+    std::string s = make_lines(n);
+
+    for (size_t threads : {1, 2, 4})
+    {
+        json_lines_options options;
+        options.thread_count(threads).chunk_size(1000);
+        json_lines_reader reader(s, options);
+
+        size_t expected = 0;
+        reader.read([&](json&& j, size_t line)
+        {
+            BOOST_CHECK_EQUAL(expected, j["id"].as<size_t>());
+            BOOST_CHECK_EQUAL(expected + 1, line);
+            ++expected;
+        });
+        BOOST_CHECK_EQUAL(n, expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_unordered_delivery)
+{
+    const size_t n = 5000;
+    std::string s = make_lines(n);
+
+    json_lines_options options;
+    options.thread_count(4).chunk_size(500).ordered(false);
+    json_lines_reader reader(s, options);
+
+    std::vector<size_t> ids;
+    reader.read([&](json&& j, size_t line)
+    {
+        BOOST_CHECK_EQUAL(line, j["id"].as<size_t>() + 1);
+        ids.push_back(j["id"].as<size_t>());
+    });
+    BOOST_REQUIRE_EQUAL(n, ids.size());
+    std::sort(ids.begin(), ids.end());
+    for (size_t i = 0; i < n; ++i)
+    {
+        BOOST_CHECK_EQUAL(i, ids[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_stream_input)
+{
+    // Chunks smaller than a record, blank lines, CRLF and no final newline
+    std::string s = "\xEF\xBB\xBF{\"a\":[1,2,3,4,5,6,7,8,9,10]}\r\n\n   \n\"a string\"\n[true,false]\r\n42";
+    for (size_t threads : {1, 3})
+    {
+        std::istringstream is(s);
+        json_lines_options options;
+        options.thread_count(threads).chunk_size(5);
+        json_lines_reader reader(is, options);
+
+        std::vector<std::pair<size_t,json>> values;
+        reader.read([&](json&& j, size_t line)
+        {
+            values.emplace_back(line, std::move(j));
+        });
+        BOOST_REQUIRE_EQUAL(4, values.size());
+        BOOST_CHECK_EQUAL(1, values[0].first);
+        BOOST_CHECK_EQUAL(10, values[0].second["a"].size());
+        BOOST_CHECK_EQUAL(4, values[1].first);
+        BOOST_CHECK(values[1].second.as<std::string>() == "a string");
+        BOOST_CHECK_EQUAL(5, values[2].first);
+        BOOST_CHECK(values[2].second[0].as<bool>());
+        BOOST_CHECK_EQUAL(6, values[3].first);
+        BOOST_CHECK_EQUAL(42, values[3].second.as<int>());
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_error)
+{
+    std::string s = make_lines(100) + "{\"id\":100,}\n" + make_lines(100);
+    for (size_t threads : {1, 4})
+    {
+        json_lines_options options;
+        options.thread_count(threads).chunk_size(100);
+        json_lines_reader reader(s, options);
+
+        size_t count = 0;
+        std::error_code ec;
+        reader.read([&](json&&, size_t) {++count;}, ec);
+        BOOST_CHECK(ec == json_parser_errc::extra_comma);
+        BOOST_CHECK_EQUAL(100, count);
+        BOOST_CHECK_EQUAL(101, reader.line_number());
+        BOOST_CHECK_EQUAL(11, reader.column_number());
+
+        json_lines_reader reader2(s, options);
+        BOOST_CHECK_THROW(reader2.read([](json&&, size_t) {}), parse_error);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_callback_exception)
+{
+    std::string s = make_lines(1000);
+    json_lines_options options;
+    options.thread_count(4).chunk_size(100);
+    json_lines_reader reader(s, options);
+
+    size_t count = 0;
+    BOOST_CHECK_THROW(reader.read([&](json&&, size_t)
+    {
+        if (++count == 50)
+        {
+            throw std::runtime_error("stop");
+        }
+    }), std::runtime_error);
+    BOOST_CHECK_EQUAL(50, count);
+}
+
+BOOST_AUTO_TEST_CASE(test_ojson_lines)
+{
+    std::string s = "{\"b\":1,\"a\":2}\n{\"d\":3,\"c\":4}\n";
+    basic_json_lines_reader<ojson> reader(s);
+    std::vector<ojson> values;
+    reader.read([&](ojson&& j, size_t) {values.push_back(std::move(j));});
+    BOOST_REQUIRE_EQUAL(2, values.size());
+    BOOST_CHECK(values[1].object_range().begin()->key() == "d");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
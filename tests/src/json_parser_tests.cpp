@@ -214,6 +214,99 @@ BOOST_AUTO_TEST_CASE(test_array_string)
     json j = decoder.get_result();
 }
 
+BOOST_AUTO_TEST_CASE(test_long_string_with_escapes)
+{
+    // Place escapes on either side of the 16 and 32 byte scan boundaries
+    for (size_t n = 0; n < 70; ++n)
+    {
+        std::string prefix(n, 'a');
+        std::string s = "[\"" + prefix + "\\n\\\"\\u00e9" + prefix + "\xE2\x82\xAC" + "\"]";
+
+        json j = json::parse(s);
+        BOOST_REQUIRE(j.is_array());
+        BOOST_CHECK(j[0].as<std::string>() == prefix + "\n\"\xC3\xA9" + prefix + "\xE2\x82\xAC");
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_control_character_in_long_string)
+{
+    size_t column0 = 0;
+    for (size_t n = 0; n < 70; ++n)
+    {
+        std::string s = "\"" + std::string(n, 'a') + "\x01\"";
+
+        std::error_code ec;
+        try
+        {
+            json::parse(s);
+        }
+        catch (const parse_error& e)
+        {
+            ec = e.code();
+            if (n == 0)
+            {
+                column0 = e.column_number();
+            }
+            BOOST_CHECK_EQUAL(column0+n, e.column_number());
+        }
+        BOOST_CHECK(ec == json_parser_errc::illegal_control_character);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_invalid_utf8_after_long_ascii_run)
+{
+    for (size_t n = 0; n < 70; ++n)
+    {
+        std::string s = "[\"" + std::string(n, 'a') + "\xC3\x28" + std::string(n, 'b') + "\"]";
+
+        std::error_code ec;
+        try
+        {
+            json::parse(s);
+        }
+        catch (const parse_error& e)
+        {
+            ec = e.code();
+        }
+        BOOST_CHECK(ec == json_parser_errc::expected_continuation_byte);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_long_string_across_buffers)
+{
+    std::string value(1000, 'x');
+    value[500] = 'y';
+    std::string s = "{\"" + std::string(40,'k') + "\":\"" + value + "\"}";
+
+    std::istringstream is(s);
+    json_decoder<json> decoder;
+    json_reader reader(is, decoder);
+    reader.buffer_length(37);
+    reader.read();
+
+    json j = decoder.get_result();
+    BOOST_CHECK(j[std::string(40,'k')].as<std::string>() == value);
+}
+
+BOOST_AUTO_TEST_CASE(test_whitespace_runs)
+{
+    std::string s = "[" + std::string(45,' ') + "1," + std::string(17,'\t') + "\n" + std::string(33,' ') + "2" + std::string(64,' ') + "]";
+
+    json_decoder<json> decoder;
+    json_parser parser(decoder);
+    parser.set_source(s.data(),s.length());
+    parser.parse();
+    parser.end_parse();
+
+    BOOST_CHECK(parser.done());
+    BOOST_CHECK_EQUAL(2,parser.line_number());
+    BOOST_CHECK_EQUAL(100,parser.column_number());
+
+    json j = decoder.get_result();
+    BOOST_CHECK_EQUAL(2,j.size());
+    BOOST_CHECK_EQUAL(2,j[1].as<int>());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
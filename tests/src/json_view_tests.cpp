@@ -0,0 +1,186 @@
+// Copyright 2017 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_view.hpp>
+#include <sstream>
+#include <vector>
+#include <utility>
+#include <ctime>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(json_view_tests)
+
+BOOST_AUTO_TEST_CASE(test_view_navigation)
+{
+    std::string s = R"(
+{
+    "name" : "Reginald \"Reg\" Hill",
+    "tags" : ["a", "b", {"c" : [] }, -1, 18446744073709551615, 1.5e3, true, false, null],
+    "empty" : {},
+    "escaped\u0041key" : "value"
+}
+    )";
+
+    json_document doc = json_document::parse(s);
+    json_view root = doc.root();
+
+    BOOST_CHECK(root.is_object());
+    BOOST_CHECK_EQUAL(4, root.size());
+    BOOST_CHECK(root.at("name").as_string() == "Reginald \"Reg\" Hill");
+    BOOST_CHECK(root.has_key("escapedAkey"));
+    BOOST_CHECK(root["escapedAkey"].as_string() == "value");
+    BOOST_CHECK(!root.has_key("missing"));
+    BOOST_CHECK_THROW(root.at("missing"), std::out_of_range);
+
+    json_view tags = root["tags"];
+    BOOST_CHECK(tags.is_array());
+    BOOST_CHECK_EQUAL(9, tags.size());
+    BOOST_CHECK(tags[0].as_string() == "a");
+    BOOST_CHECK(tags[2].is_object());
+    BOOST_CHECK(tags[2]["c"].is_array());
+    BOOST_CHECK(tags[2]["c"].empty());
+    BOOST_CHECK(tags[3].is_integer());
+    BOOST_CHECK_EQUAL(-1, tags[3].as_integer());
+    BOOST_CHECK(tags[4].is_uinteger());
+    BOOST_CHECK(!tags[4].is_integer());
+    BOOST_CHECK_EQUAL((std::numeric_limits<uint64_t>::max)(), tags[4].as_uinteger());
+    BOOST_CHECK(tags[5].is_double());
+    BOOST_CHECK_EQUAL(1500.0, tags[5].as_double());
+    BOOST_CHECK(tags[6].as_bool());
+    BOOST_CHECK(!tags[7].as_bool());
+    BOOST_CHECK(tags[8].is_null());
+    BOOST_CHECK_THROW(tags[9], std::out_of_range);
+
+    BOOST_CHECK(root["empty"].is_object());
+    BOOST_CHECK_EQUAL(0, root["empty"].size());
+
+    std::vector<std::string> keys;
+    for (auto member : root.object_range())
+    {
+        keys.push_back(member.key());
+    }
+    std::vector<std::string> expected_keys = {"name","tags","empty","escapedAkey"};
+    BOOST_CHECK(expected_keys == keys);
+
+    size_t count = 0;
+    for (auto element : tags.array_range())
+    {
+        BOOST_CHECK(element.kind() == tags[count].kind());
+        ++count;
+    }
+    BOOST_CHECK_EQUAL(9, count);
+}
+
+BOOST_AUTO_TEST_CASE(test_view_as_json)
+{
+    std::string s = R"({"a":{"b":[1,2.25,"x"]},"c":"d"})";
+    json_document doc = json_document::parse(s);
+
+    json a = doc.root()["a"].as_json<json>();
+    BOOST_CHECK(a == json::parse(R"({"b":[1,2.25,"x"]})"));
+    BOOST_CHECK(doc.root()["a"].text() == json_view::string_view_type(R"({"b":[1,2.25,"x"]})"));
+    BOOST_CHECK(doc.root()["c"].as_json<json>() == json("d"));
+}
+
+BOOST_AUTO_TEST_CASE(test_view_scalars)
+{
+    std::string s = "  -0.5  ";
+    json_document doc = json_document::parse(s);
+    BOOST_CHECK_EQUAL(-0.5, doc.root().as_double());
+
+    std::string big = "-9223372036854775809";
+    json_document doc2 = json_document::parse(big);
+    BOOST_CHECK(doc2.root().is_double());
+}
+
+BOOST_AUTO_TEST_CASE(test_view_errors)
+{
+    std::vector<std::pair<std::string,json_parser_errc>> cases = {
+        {"", json_parser_errc::unexpected_eof},
+        {"[1,2", json_parser_errc::unexpected_eof},
+        {"\"abc", json_parser_errc::unexpected_eof},
+        {"[1,]", json_parser_errc::extra_comma},
+        {"{\"a\":1,}", json_parser_errc::extra_comma},
+        {"{\"a\" 1}", json_parser_errc::expected_colon},
+        {"{1:1}", json_parser_errc::expected_name},
+        {"[1 2]", json_parser_errc::expected_comma_or_right_bracket},
+        {"{\"a\":1]", json_parser_errc::expected_comma_or_right_brace},
+        {"[tru]", json_parser_errc::invalid_value},
+        {"[nulll]", json_parser_errc::invalid_value},
+        {"[01]", json_parser_errc::leading_zero},
+        {"[1.]", json_parser_errc::invalid_number},
+        {"[-]", json_parser_errc::invalid_number},
+        {"[1e+]", json_parser_errc::invalid_number},
+        {"[1x]", json_parser_errc::invalid_number},
+        {"[1] 2", json_parser_errc::extra_character},
+        {"[@]", json_parser_errc::expected_value}
+    };
+    for (const auto& c : cases)
+    {
+        std::error_code ec;
+        json_document::parse(c.first, ec);
+        BOOST_CHECK_MESSAGE(ec == c.second, c.first);
+    }
+
+    std::string s = "[1,\n  2,\n  x]";
+    try
+    {
+        json_document::parse(s);
+        BOOST_CHECK(false);
+    }
+    catch (const parse_error& e)
+    {
+        BOOST_CHECK_EQUAL(3, e.line_number());
+        BOOST_CHECK_EQUAL(3, e.column_number());
+    }
+
+    // Bad escapes are reported when the string is read
+    std::string bad = R"(["\q"])";
+    json_document doc = json_document::parse(bad);
+    BOOST_CHECK_THROW(doc.root()[0].as_string(), parse_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_view_escapes_across_blocks)
+{
+    // Quotes and backslashes at every offset relative to the 64 character blocks
+    for (size_t pad = 0; pad < 130; ++pad)
+    {
+        std::string value = std::string(pad, 'x') + "\\\\\\\"" + std::string(pad % 7, '\\') + std::string(pad % 7, '\\') + "y";
+        std::string s = "[" + std::string(pad % 65, ' ') + "\"" + value + "\",{\"k\":" + std::to_string(pad) + "}]";
+        json expected = json::parse(s);
+
+        json_document doc = json_document::parse(s);
+        BOOST_REQUIRE_EQUAL(2, doc.root().size());
+        BOOST_CHECK(doc.root()[0].as_string() == expected[0].as<std::string>());
+        BOOST_CHECK_EQUAL(pad, doc.root()[1]["k"].as_uinteger());
+        BOOST_CHECK(doc.root().as_json<json>() == expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_view_matches_parse)
+{
+    std::string s = R"([{"id":1,"values":[1.5,-2,3e-5],"meta":{"a":"x\ty","b":[[],[{}]]}},
+                        {"id":2,"values":[],"meta":{"a":"é😀","b":null}}])";
+    json expected = json::parse(s);
+    json_document doc = json_document::parse(s);
+    json_view root = doc.root();
+
+    BOOST_CHECK(root.as_json<json>() == expected);
+    BOOST_CHECK(root[1]["meta"]["a"].as_string() == expected[1]["meta"]["a"].as<std::string>());
+    BOOST_CHECK_EQUAL(3e-5, root[0]["values"][2].as_double());
+    BOOST_CHECK_EQUAL(2, root[0]["meta"]["b"][1].size() + root[0]["meta"]["b"][1][0].size() + 1);
+}
+
+BOOST_AUTO_TEST_CASE(test_wjson_view)
+{
+    std::wstring s = L"{\"name\":\"ét\\u00e9\",\"n\":[10,20]}";
+    wjson_document doc = wjson_document::parse(s);
+    BOOST_CHECK(doc.root()[L"name"].as_string() == L"été");
+    BOOST_CHECK_EQUAL(20, doc.root()[L"n"][1].as_integer());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
+
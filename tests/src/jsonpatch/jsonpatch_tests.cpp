@@ -13,6 +13,7 @@
 #include <vector>
 #include <map>
 #include <utility>
+#include <algorithm>
 #include <ctime>
 #include <new>
 #include <codecvt>
@@ -469,6 +470,64 @@ BOOST_AUTO_TEST_CASE(test_diff2)
     check_patch(source,patch,jsonpatch::jsonpatch_errc(),target);
 }
 
+BOOST_AUTO_TEST_CASE(test_diff_arrays)
+{
+    json source = R"(
+        {"a": [1, 2, 3, 4], "b": [{"id": 1}, {"id": 2}]}
+    )"_json;
+
+    json target = R"(
+        {"a": [1, 2], "b": [{"id": 1}, {"id": 2}, {"id": 3}, {"id": 4}]}
+    )"_json;
+
+    for (auto mode : {jsonpatch::array_diff::positional, jsonpatch::array_diff::aligned})
+    {
+        json doc = source;
+        auto patch = jsonpatch::diff(source, target, mode);
+        check_patch(doc,patch,jsonpatch::jsonpatch_errc(),target);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_diff_aligned)
+{
+    json source = json::array();
+    for (int i = 0; i < 100; ++i)
+    {
+        json item;
+        item["id"] = i;
+        item["tags"] = json::array{"x"};
+        source.push_back(std::move(item));
+    }
+
+    // Insert at the front
+    json target = source;
+    target.insert(target.array_range().begin(), json("first"));
+    auto patch = jsonpatch::diff(source, target, jsonpatch::array_diff::aligned);
+    BOOST_REQUIRE_EQUAL(1, patch.size());
+    BOOST_CHECK(patch[0] == json::parse(R"({"op":"add","path":"/0","value":"first"})"));
+    json doc = source;
+    check_patch(doc,patch,jsonpatch::jsonpatch_errc(),target);
+
+    // Move one element, remove another, and change a nested value
+    target = source;
+    json moved = target[90];
+    target.erase(target.array_range().begin()+90);
+    target.insert(target.array_range().begin()+10, moved);
+    target.erase(target.array_range().begin()+50);
+    target[70]["tags"].push_back("y");
+    patch = jsonpatch::diff(source, target, jsonpatch::array_diff::aligned);
+    BOOST_CHECK_EQUAL(3, patch.size());
+    doc = source;
+    check_patch(doc,patch,jsonpatch::jsonpatch_errc(),target);
+
+    // Reorder
+    target = source;
+    std::reverse(target.array_range().begin(), target.array_range().end());
+    patch = jsonpatch::diff(source, target, jsonpatch::array_diff::aligned);
+    doc = source;
+    check_patch(doc,patch,jsonpatch::jsonpatch_errc(),target);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
@@ -0,0 +1,202 @@
+// Copyright 2017 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <utility>
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/jsonpath/json_query.hpp>
+#include <jsoncons_ext/jsonpath/json_query_handler.hpp>
+
+using namespace jsoncons;
+using namespace jsoncons::jsonpath;
+
+BOOST_AUTO_TEST_SUITE(json_query_handler_tests)
+
+namespace {
+
+const std::string store_text = R"(
+{
+    "store": {
+        "book": [
+            {"category": "reference", "author": "Nigel Rees", "title": "Sayings of the Century", "price": 8.95},
+            {"category": "fiction", "author": "Evelyn Waugh", "title": "Sword of Honour", "price": 12.99},
+            {"category": "fiction", "author": "Herman Melville", "title": "Moby Dick", "isbn": "0-553-21311-3", "price": 8.99},
+            {"category": "fiction", "author": "J. R. R. Tolkien", "title": "The Lord of the Rings", "isbn": "0-395-19395-8", "price": 22.99}
+        ],
+        "bicycle": {"color": "red", "price": 19.95}
+    }
+}
+)";
+
+std::vector<std::pair<std::string,json>> stream_query(const std::string& text, const std::string& path)
+{
+    std::vector<std::pair<std::string,json>> results;
+    json_query_handler handler(path,
+                               [&](const std::string& p, json&& value)
+                               {
+                                   results.emplace_back(p, std::move(value));
+                               });
+    std::istringstream is(text);
+    json_reader reader(is, handler);
+    reader.read();
+    return results;
+}
+
+std::vector<std::string> sorted_values(const json& a)
+{
+    std::vector<std::string> v;
+    for (const auto& item : a.array_range())
+    {
+        v.push_back(item.to_string());
+    }
+    std::sort(v.begin(), v.end());
+    return v;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(test_stream_query_paths)
+{
+    auto results = stream_query(store_text, "$.store.book[*].author");
+    BOOST_REQUIRE_EQUAL(4, results.size());
+    BOOST_CHECK(results[0].first == "$['store']['book'][0]['author']");
+    BOOST_CHECK(results[0].second.as<std::string>() == "Nigel Rees");
+    BOOST_CHECK(results[3].first == "$['store']['book'][3]['author']");
+    BOOST_CHECK(results[3].second.as<std::string>() == "J. R. R. Tolkien");
+
+    results = stream_query(store_text, "$..book[2]");
+    BOOST_REQUIRE_EQUAL(1, results.size());
+    BOOST_CHECK(results[0].first == "$['store']['book'][2]");
+    BOOST_CHECK(results[0].second["title"].as<std::string>() == "Moby Dick");
+
+    results = stream_query(store_text, "$");
+    BOOST_REQUIRE_EQUAL(1, results.size());
+    BOOST_CHECK(results[0].first == "$");
+    BOOST_CHECK(results[0].second == json::parse(store_text));
+}
+
+BOOST_AUTO_TEST_CASE(test_stream_query_same_values_as_json_query)
+{
+    json root = json::parse(store_text);
+    std::vector<std::string> paths = {
+        "$.store.book",
+        "$.store.*",
+        "$.store.book[1]",
+        "$.store.book[0,2]",
+        "$.store.book[1:]",
+        "$.store.book[0:4:2]['title','price']",
+        "$.store.book.1.title",
+        "$['store']['bicycle'].color",
+        "$..price",
+        "$..book[1:3]",
+        "$..['isbn','color']",
+        "$.store..price",
+        "$.*.book[*].category",
+        "$.nothing.here",
+        "$.store.book[10]"
+    };
+    for (const auto& path : paths)
+    {
+        json expected = json_query(root, path);
+        json actual = json::array();
+        for (auto& result : stream_query(store_text, path))
+        {
+            actual.add(std::move(result.second));
+        }
+        BOOST_CHECK_MESSAGE(sorted_values(expected) == sorted_values(actual), path);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_stream_query_unions)
+{
+    // Values come in document order, once each, where json_query follows 
+    // the order of the union and repeats a value selected twice
+    json root = json::parse(store_text);
+
+    auto results = stream_query(store_text, "$.store.book[2,0].title");
+    BOOST_REQUIRE_EQUAL(2, results.size());
+    BOOST_CHECK(results[0].second.as<std::string>() == "Sayings of the Century");
+    BOOST_CHECK(results[1].second.as<std::string>() == "Moby Dick");
+    json expected = json_query(root, "$.store.book[2,0].title");
+    BOOST_REQUIRE_EQUAL(2, expected.size());
+    BOOST_CHECK(expected[0].as<std::string>() == "Moby Dick");
+
+    results = stream_query(store_text, "$.store.book[1,1].title");
+    BOOST_REQUIRE_EQUAL(1, results.size());
+    BOOST_CHECK(results[0].first == "$['store']['book'][1]['title']");
+    BOOST_CHECK_EQUAL(2, json_query(root, "$.store.book[1,1].title").size());
+}
+
+BOOST_AUTO_TEST_CASE(test_stream_query_nested_matches)
+{
+    // An inner match is delivered before the value that contains it
+    std::string text = R"({"a":{"a":{"a":1}}})";
+    auto results = stream_query(text, "$..a");
+    BOOST_REQUIRE_EQUAL(3, results.size());
+    BOOST_CHECK(results[0].first == "$['a']['a']['a']");
+    BOOST_CHECK_EQUAL(1, results[0].second.as<int>());
+    BOOST_CHECK(results[1].first == "$['a']['a']");
+    BOOST_CHECK(results[1].second == json::parse(R"({"a":1})"));
+    BOOST_CHECK(results[2].first == "$['a']");
+    BOOST_CHECK(results[2].second == json::parse(R"({"a":{"a":1}})"));
+}
+
+BOOST_AUTO_TEST_CASE(test_stream_query_compiled_expression)
+{
+    auto expr = compile<json>("$.items[*].id");
+    std::ostringstream os;
+    os << "{\"items\":[";
+    for (size_t i = 0; i < 1000; ++i)
+    {
+        if (i > 0) os << ",";
+        os << "{\"id\":" << i << ",\"payload\":{\"data\":[1,2,3],\"id\":\"not this one\"}}";
+    }
+    os << "]}";
+
+    size_t count = 0;
+    int64_t sum = 0;
+    json_query_handler handler(expr, [&](const std::string&, json&& value)
+    {
+        ++count;
+        sum += value.as<int64_t>();
+    });
+    std::istringstream is(os.str());
+    json_reader reader(is, handler);
+    reader.read();
+    BOOST_CHECK_EQUAL(1000, count);
+    BOOST_CHECK_EQUAL(999*1000/2, sum);
+}
+
+BOOST_AUTO_TEST_CASE(test_stream_query_unsupported)
+{
+    auto f = [](const std::string&, json&&){};
+    BOOST_CHECK_THROW(json_query_handler("$.store.book[?(@.price < 10)]", f), std::invalid_argument);
+    BOOST_CHECK_THROW(json_query_handler("$.store.book[(@.length-1)]", f), std::invalid_argument);
+    BOOST_CHECK_THROW(json_query_handler("$.store.book[-1]", f), std::invalid_argument);
+    BOOST_CHECK_THROW(json_query_handler("$.store.book[-2:]", f), std::invalid_argument);
+    BOOST_CHECK_THROW(json_query_handler("$.store.book[?(@.price < 10]", f), parse_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_wjson_stream_query)
+{
+    std::vector<std::wstring> names;
+    wjson_query_handler handler(L"$.people[*].name", [&](const std::wstring&, wjson&& value)
+    {
+        names.push_back(value.as<std::wstring>());
+    });
+    std::wistringstream is(L"{\"people\":[{\"name\":\"Ann\"},{\"name\":\"Bob\"}]}");
+    wjson_reader reader(is, handler);
+    reader.read();
+    BOOST_REQUIRE_EQUAL(2, names.size());
+    BOOST_CHECK(names[1] == L"Bob");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,81 @@
+// Copyright 2017 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <utility>
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/jsonpath/json_query.hpp>
+
+using namespace jsoncons;
+using namespace jsoncons::jsonpath;
+
+BOOST_AUTO_TEST_SUITE(jsonpath_callback_tests)
+
+namespace {
+
+const json store = json::parse(R"(
+{
+    "store": {
+        "book": [
+            {"category": "reference", "author": "Nigel Rees", "title": "Sayings of the Century", "price": 8.95},
+            {"category": "fiction", "author": "Evelyn Waugh", "title": "Sword of Honour", "price": 12.99},
+            {"category": "fiction", "author": "Herman Melville", "title": "Moby Dick", "isbn": "0-553-21311-3", "price": 8.99}
+        ],
+        "bicycle": {"color": "red", "price": 19.95}
+    }
+}
+)");
+
+}
+
+BOOST_AUTO_TEST_CASE(test_json_query_callback)
+{
+    std::vector<std::string> paths = {
+        "$..price",
+        "$.store.book[?(@.price < 10)].title",
+        "$.store.book.length",
+        "$.store.book[0].title[0]",
+        "$.store.*",
+        "$.nothing"
+    };
+    for (const auto& path : paths)
+    {
+        json values = json::array();
+        json_query(store, path, [&](const json& value)
+        {
+            values.add(value);
+        });
+        BOOST_CHECK_MESSAGE(values == json_query(store, path), path);
+
+        json values2 = json::array();
+        json_query(store, compile<json>(path), [&](const json& value)
+        {
+            values2.add(value);
+        });
+        BOOST_CHECK_MESSAGE(values2 == values, path);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_json_query_callback_no_copy)
+{
+    // Selected values are passed by reference to the values in the document
+    std::vector<const json*> selected;
+    json_query(store, "$.store.book[*]", [&](const json& value)
+    {
+        selected.push_back(&value);
+    });
+    BOOST_REQUIRE_EQUAL(3, selected.size());
+    for (size_t i = 0; i < selected.size(); ++i)
+    {
+        BOOST_CHECK(selected[i] == &store["store"]["book"][i]);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,163 @@
+// Copyright 2017 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <sstream>
+#include <vector>
+#include <utility>
+#include <thread>
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/jsonpath/json_query.hpp>
+
+using namespace jsoncons;
+using namespace jsoncons::jsonpath;
+
+BOOST_AUTO_TEST_SUITE(jsonpath_compile_tests)
+
+namespace {
+
+json make_store(double price_offset)
+{
+    json store = json::parse(R"(
+    {
+        "store": {
+            "book": [
+                {"category": "reference", "author": "Nigel Rees", "title": "Sayings of the Century", "price": 8.95},
+                {"category": "fiction", "author": "Evelyn Waugh", "title": "Sword of Honour", "price": 12.99},
+                {"category": "fiction", "author": "Herman Melville", "title": "Moby Dick", "isbn": "0-553-21311-3", "price": 8.99},
+                {"category": "fiction", "author": "J. R. R. Tolkien", "title": "The Lord of the Rings", "isbn": "0-395-19395-8", "price": 22.99}
+            ],
+            "bicycle": {"color": "red", "price": 19.95}
+        }
+    }
+    )");
+    for (auto& book : store["store"]["book"].array_range())
+    {
+        book["price"] = book["price"].as<double>() + price_offset;
+    }
+    return store;
+}
+
+const std::vector<std::string> paths = 
+{
+    "$.store.book[*].author",
+    "$..author",
+    "$.store.*",
+    "$.store..price",
+    "$..book[2]",
+    "$..book[-1:]",
+    "$..book[0,1]",
+    "$..book[:2]",
+    "$..book[?(@.isbn)].title",
+    "$..book[?(@.price < 10)].title",
+    "$..book[(@.length-1)].title",
+    "$.store.book[?(@.price < max($.store.book[*].price))].title",
+    "$.store.book[?(@.author =~ /.*Tolkien/)].price",
+    "$.store.book.length",
+    ""
+};
+
+}
+
+BOOST_AUTO_TEST_CASE(test_compiled_same_as_json_query)
+{
+    std::vector<json> docs = {make_store(0), make_store(5), make_store(-1)};
+
+    for (const auto& path : paths)
+    {
+        auto expr = jsonpath::compile<json>(path);
+        for (const auto& doc : docs)
+        {
+            BOOST_CHECK_EQUAL(json_query(doc, path), expr.evaluate(doc));
+            BOOST_CHECK_EQUAL(json_query(doc, path, result_type::path), expr.evaluate(doc, result_type::path));
+            BOOST_CHECK_EQUAL(json_query(doc, path), json_query(doc, expr));
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_compiled_filter_uses_each_root)
+{
+    // max($...) in a filter is evaluated against the root being queried
+    auto expr = jsonpath::compile<json>("$.store.book[?(@.price == max($.store.book[*].price))].title");
+    json doc1 = make_store(0);
+    json doc2 = make_store(0);
+    doc2["store"]["book"][0]["price"] = 100.0;
+    BOOST_CHECK_EQUAL(json::parse(R"(["The Lord of the Rings"])"), expr.evaluate(doc1));
+    BOOST_CHECK_EQUAL(json::parse(R"(["Sayings of the Century"])"), expr.evaluate(doc2));
+}
+
+BOOST_AUTO_TEST_CASE(test_compiled_replace)
+{
+    auto expr = jsonpath::compile<json>("$.store.book[?(@.price < 10)].price");
+    json doc1 = make_store(0);
+    json doc2 = make_store(0);
+    expr.replace(doc1, 10.0);
+    json_replace(doc2, expr, 11.0);
+    BOOST_CHECK_EQUAL(json::parse("[10.0,12.99,10.0,22.99]"), json_query(doc1, "$..book[*].price"));
+    BOOST_CHECK_EQUAL(json::parse("[11.0,12.99,11.0,22.99]"), json_query(doc2, "$..book[*].price"));
+}
+
+BOOST_AUTO_TEST_CASE(test_compile_errors)
+{
+    std::error_code ec;
+    jsonpath::compile<json>("$.store.book[?(@.price < 10]", ec);
+    BOOST_CHECK(ec);
+
+    BOOST_CHECK_THROW(jsonpath::compile<json>("store.book"), parse_error);
+    BOOST_CHECK_THROW(jsonpath::compile<json>("$..book[?(@.price ~ 10)]"), parse_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_compiled_concurrent_evaluation)
+{
+    std::vector<jsonpath_expression<json>> exprs;
+    for (const auto& path : paths)
+    {
+        exprs.push_back(jsonpath::compile<json>(path));
+    }
+
+    std::vector<json> docs;
+    std::vector<std::vector<json>> expected;
+    for (size_t i = 0; i < 8; ++i)
+    {
+        docs.push_back(make_store(static_cast<double>(i)));
+        std::vector<json> results;
+        for (const auto& path : paths)
+        {
+            results.push_back(json_query(docs.back(), path, result_type::path));
+        }
+        expected.push_back(results);
+    }
+
+    std::vector<int> mismatches(docs.size(), 0);
+    std::vector<std::thread> threads;
+    for (size_t t = 0; t < docs.size(); ++t)
+    {
+        threads.emplace_back([&, t]()
+        {
+            for (size_t n = 0; n < 20; ++n)
+            {
+                for (size_t i = 0; i < exprs.size(); ++i)
+                {
+                    if (exprs[i].evaluate(docs[t], result_type::path) != expected[t][i])
+                    {
+                        ++mismatches[t];
+                    }
+                }
+            }
+        });
+    }
+    for (auto& thread : threads)
+    {
+        thread.join();
+    }
+    for (size_t t = 0; t < docs.size(); ++t)
+    {
+        BOOST_CHECK_EQUAL(0, mismatches[t]);
+    }
+}
+
+BOOST_AUTO_TEST_SUITE_END()
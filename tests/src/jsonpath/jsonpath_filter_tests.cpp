@@ -11,6 +11,7 @@
 #include <utility>
 #include <ctime>
 #include <new>
+#include <limits>
 #include <jsoncons/json.hpp>
 #include <jsoncons_ext/jsonpath/json_query.hpp>
 
@@ -493,5 +494,80 @@ BOOST_AUTO_TEST_CASE(test_jsonpath_filter_regex)
     BOOST_CHECK_EQUAL(json(true),result3);
 }
 
-BOOST_AUTO_TEST_SUITE_END()
+BOOST_AUTO_TEST_CASE(test_numeric_literals)
+{
+    const char* pend;
+    jsonpath_filter_parser<json> parser;
+
+    json context = json::array();
+    context.push_back(3);
+
+    std::string s1 = "(@.0 > 2.5e0)";
+    auto expr1 = parser.parse(context, s1.c_str(), s1.c_str()+ s1.length(), &pend);
+    BOOST_CHECK(expr1.eval(context).as<bool>());
+
+    std::string s2 = "(-1.25*4)";
+    auto expr2 = parser.parse(context, s2.c_str(), s2.c_str()+ s2.length(), &pend);
+    BOOST_CHECK_EQUAL(json(-5.0),expr2.eval(context));
+
+    std::string s3 = "(18446744073709551615 == 18446744073709551615)";
+    auto expr3 = parser.parse(context, s3.c_str(), s3.c_str()+ s3.length(), &pend);
+    BOOST_CHECK(expr3.eval(context).as<bool>());
+
+    std::string s4 = "(01 == 1)";
+    BOOST_CHECK_THROW(parser.parse(context, s4.c_str(), s4.c_str()+ s4.length(), &pend),parse_error);
+
+    // Literals keep their integer types and precision
+    std::string s5 = "(18446744073709551615)";
+    auto expr5 = parser.parse(context, s5.c_str(), s5.c_str()+ s5.length(), &pend);
+    BOOST_CHECK(expr5.eval(context).is_uinteger());
+    BOOST_CHECK_EQUAL((std::numeric_limits<uint64_t>::max)(), expr5.eval(context).as<uint64_t>());
+
+    std::string s6 = "(9007199254740993 == 9007199254740992)";
+    auto expr6 = parser.parse(context, s6.c_str(), s6.c_str()+ s6.length(), &pend);
+    BOOST_CHECK(!expr6.eval(context).as<bool>());
 
+    std::string s7 = "(0.1000000000000000055511151231257827)";
+    auto expr7 = parser.parse(context, s7.c_str(), s7.c_str()+ s7.length(), &pend);
+    BOOST_CHECK_EQUAL(json::parse("0.1000000000000000055511151231257827").to_string(), expr7.eval(context).to_string());
+}
+
+BOOST_AUTO_TEST_CASE(test_aggregate_bound_to_root)
+{
+    const char* pend;
+    jsonpath_filter_parser<json> parser;
+
+    std::string s = "(@.v == max($[*].v))";
+    auto expr = parser.parse(s.c_str(), s.c_str()+ s.length(), &pend);
+    BOOST_CHECK(expr.depends_on_root());
+
+    json root = json::parse(R"([{"v":1},{"v":3},{"v":2}])");
+    auto bound = expr.bind_root(root);
+    BOOST_CHECK(!bound.depends_on_root());
+    BOOST_CHECK(bound.exists(root[1], root));
+    BOOST_CHECK(!bound.exists(root[0], root));
+
+    std::string s2 = "(@.v > 1)";
+    BOOST_CHECK(!parser.parse(s2.c_str(), s2.c_str()+ s2.length(), &pend).depends_on_root());
+}
+
+BOOST_AUTO_TEST_CASE(test_aggregate_filter_large_array)
+{
+    json root = json::array();
+    for (int i = 0; i < 5000; ++i)
+    {
+        json item;
+        item["v"] = (i * 7919) % 5000;
+        root.push_back(std::move(item));
+    }
+
+    json max_result = json_query(root, "$[?(@.v == max($[*].v))]");
+    BOOST_REQUIRE_EQUAL(1, max_result.size());
+    BOOST_CHECK_EQUAL(4999, max_result[0]["v"].as<int>());
+
+    json min_result = json_query(root, "$[?(@.v == min($[*].v))].v");
+    BOOST_REQUIRE_EQUAL(1, min_result.size());
+    BOOST_CHECK_EQUAL(0, min_result[0].as<int>());
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,89 @@
+// Copyright 2017 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <utility>
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/jsonpath/json_query.hpp>
+
+using namespace jsoncons;
+using namespace jsoncons::jsonpath;
+
+BOOST_AUTO_TEST_SUITE(jsonpath_parallel_tests)
+
+namespace {
+
+json make_catalog(size_t n)
+{
+    json books = json::array();
+    books.reserve(n);
+    for (size_t i = 0; i < n; ++i)
+    {
+        json book;
+        book["title"] = "Title " + std::to_string(i);
+        book["author"] = (i % 7 == 0) ? std::string("J. R. R. Tolkien") : "Author " + std::to_string(i % 100);
+        book["price"] = static_cast<double>(i % 50) + 0.99;
+        json tags = json::array();
+        for (size_t j = 0; j < i % 4; ++j)
+        {
+            tags.add("tag" + std::to_string(j));
+        }
+        book["tags"] = std::move(tags);
+        books.add(std::move(book));
+    }
+    json root;
+    root["store"]["book"] = std::move(books);
+    root["store"]["bicycle"]["price"] = 19.95;
+    return root;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_same_as_serial)
+{
+    json root = make_catalog(2000);
+    std::vector<std::string> paths = {
+        "$.store.book[*].title",
+        "$.store.book[*]",
+        "$.store.book[?(@.price < 10)].title",
+        "$.store.book[?(@.author =~ /.*Tolkien/)].tags[*]",
+        "$..price",
+        "$..tags[0]",
+        "$..book[?(@.price > 45)].author",
+        "$.store.book[*].tags.length",
+        "$.store.*",
+        "$.store.book[1:10:3].title"
+    };
+    for (size_t threads : {2, 3, 8})
+    {
+        evaluation_options options;
+        options.thread_count(threads).parallel_threshold(16);
+        for (const auto& path : paths)
+        {
+            auto expr = compile<json>(path);
+            BOOST_CHECK_MESSAGE(json_query(root, expr, result_type::value, options) == json_query(root, expr), path);
+            BOOST_CHECK_MESSAGE(json_query(root, expr, result_type::path, options) == json_query(root, expr, result_type::path), path);
+        }
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_parallel_threshold)
+{
+    json root = make_catalog(100);
+    evaluation_options options;
+    options.thread_count(0);
+    BOOST_CHECK(options.parallel_threshold() == evaluation_options::default_parallel_threshold);
+
+    // Below the threshold, evaluation is serial
+    json result = json_query(root, "$.store.book[?(@.price < 10)].title", result_type::value, options);
+    BOOST_CHECK(result == json_query(root, "$.store.book[?(@.price < 10)].title"));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,146 @@
+// Copyright 2017 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <utility>
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/jsonpath/json_query.hpp>
+#include <jsoncons_ext/jsonpath/jsonpath_query_set.hpp>
+#include <jsoncons_ext/jsonpath/json_query_handler.hpp>
+
+using namespace jsoncons;
+using namespace jsoncons::jsonpath;
+
+BOOST_AUTO_TEST_SUITE(jsonpath_query_set_tests)
+
+namespace {
+
+const std::string store_text = R"(
+{
+    "store": {
+        "book": [
+            {"category": "reference", "author": "Nigel Rees", "title": "Sayings of the Century", "price": 8.95},
+            {"category": "fiction", "author": "Evelyn Waugh", "title": "Sword of Honour", "price": 12.99},
+            {"category": "fiction", "author": "Herman Melville", "title": "Moby Dick", "isbn": "0-553-21311-3", "price": 8.99},
+            {"category": "fiction", "author": "J. R. R. Tolkien", "title": "The Lord of the Rings", "isbn": "0-395-19395-8", "price": 22.99}
+        ],
+        "bicycle": {"color": "red", "price": 19.95}
+    }
+}
+)";
+
+std::vector<std::string> sorted_values(const json& a)
+{
+    std::vector<std::string> v;
+    for (const auto& item : a.array_range())
+    {
+        v.push_back(item.to_string());
+    }
+    std::sort(v.begin(), v.end());
+    return v;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(test_query_set_same_values_as_json_query)
+{
+    json root = json::parse(store_text);
+    std::vector<std::string> paths = {
+        "$",
+        "$.store.book",
+        "$.store.*",
+        "$.store.book[1]",
+        "$.store.book[-1]",
+        "$.store.book[0,2]",
+        "$.store.book[1:]",
+        "$.store.book[-2:]",
+        "$.store.book[:-1:2]",
+        "$.store.book[0:4:2]['title','price']",
+        "$.store.book.1.title",
+        "$['store']['bicycle'].color",
+        "$..price",
+        "$..book[1:3]",
+        "$..['isbn','color']",
+        "$.store..price",
+        "$.*.book[*].category",
+        "$.nothing.here",
+        "$.store.book[10]",
+        "$.store.book.length",
+        "$.store.book[?(@.price < 10)].title",
+        "$.store.book[(@.length-1)].title"
+    };
+
+    jsonpath_query_set<json> queries;
+    for (const auto& path : paths)
+    {
+        queries.add(path);
+    }
+    BOOST_CHECK_EQUAL(paths.size(), queries.size());
+
+    json values = queries.evaluate(root);
+    BOOST_REQUIRE_EQUAL(paths.size(), values.size());
+    for (size_t i = 0; i < paths.size(); ++i)
+    {
+        json expected = json_query(root, paths[i]);
+        BOOST_CHECK_MESSAGE(sorted_values(expected) == sorted_values(values[i]), paths[i]);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_query_set_paths)
+{
+    json root = json::parse(store_text);
+    jsonpath_query_set<json> queries;
+    size_t authors = queries.add("$.store.book[*].author");
+    size_t first = queries.add(compile<json>("$.store.book[0]"));
+    size_t colors = queries.add("$..color");
+
+    json result = queries.evaluate(root, result_type::path);
+    BOOST_REQUIRE_EQUAL(4, result[authors].size());
+    BOOST_CHECK(result[authors][2].as<std::string>() == "$['store']['book'][2]['author']");
+    BOOST_REQUIRE_EQUAL(1, result[first].size());
+    BOOST_CHECK(result[first][0].as<std::string>() == "$['store']['book'][0]");
+    BOOST_REQUIRE_EQUAL(1, result[colors].size());
+    BOOST_CHECK(result[colors][0].as<std::string>() == "$['store']['bicycle']['color']");
+}
+
+BOOST_AUTO_TEST_CASE(test_query_set_stream)
+{
+    jsonpath_query_set<json> queries;
+    queries.add("$.store.book[*].title");
+    queries.add("$.store.book[*]['title','price']");
+    queries.add("$..price");
+
+    std::vector<std::vector<json>> results(queries.size());
+    json_query_handler handler(queries, [&](size_t index, const std::string&, json&& value)
+    {
+        results[index].push_back(std::move(value));
+    });
+    std::istringstream is(store_text);
+    json_reader reader(is, handler);
+    reader.read();
+
+    json root = json::parse(store_text);
+    json expected = queries.evaluate(root);
+    for (size_t i = 0; i < queries.size(); ++i)
+    {
+        json actual = json::array(results[i].begin(), results[i].end());
+        BOOST_CHECK(sorted_values(expected[i]) == sorted_values(actual));
+    }
+    BOOST_CHECK_EQUAL(4, results[0].size());
+    BOOST_CHECK_EQUAL(8, results[1].size());
+    BOOST_CHECK_EQUAL(5, results[2].size());
+
+    jsonpath_query_set<json> unsupported;
+    unsupported.add("$.store.book[?(@.price < 10)]");
+    BOOST_CHECK_THROW(json_query_handler(unsupported, [](size_t, const std::string&, json&&){}), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,128 @@
+// Copyright 2017 Daniel Parker
+// Distributed under Boost license
+
+#ifdef __linux__
+#define BOOST_TEST_DYN_LINK
+#endif
+
+#include <boost/test/unit_test.hpp>
+#include <sstream>
+#include <vector>
+#include <string>
+#include <utility>
+#include <jsoncons/json.hpp>
+#include <jsoncons_ext/jsonpath/json_query.hpp>
+#include <jsoncons_ext/jsonpath/jsonpath_regex.hpp>
+
+using namespace jsoncons;
+using namespace jsoncons::jsonpath;
+
+BOOST_AUTO_TEST_SUITE(jsonpath_regex_tests)
+
+namespace {
+
+class counting_matcher : public basic_regex_matcher<char>
+{
+    std::string pattern_;
+    size_t* count_;
+public:
+    counting_matcher(const std::string& pattern, size_t* count)
+        : pattern_(pattern), count_(count)
+    {
+    }
+
+    bool matches(const char* s, size_t length) const override
+    {
+        ++(*count_);
+        return std::string(s, length) == pattern_;
+    }
+};
+
+}
+
+BOOST_AUTO_TEST_CASE(test_dfa_same_as_std_regex)
+{
+    std::vector<std::string> patterns = {
+        ".*Tolkien", "^ab*c$", "(ab|cd)+e?", "[^a-c]*", "\\d+\\.\\d*",
+        "\\w+@\\w+\\.com", "(?:x|y)*?z", "[A-Z][a-z]+ [A-Z]\\.", "(a|)b", "[-a]", ""
+    };
+    std::vector<std::string> subjects = {
+        "", "J. R. R. Tolkien", "j. r. r. tolkien", "abbbc", "ac", "abcdcde", "xyz",
+        "12.5", "12.", ".5", "foo@bar.com", "foo@bar.co", "xyxyz", "Moby D.", "b", "ab", "-", "a\nb"
+    };
+    for (const auto& pattern : patterns)
+    {
+        for (bool icase : {false, true})
+        {
+            auto dfa = jsonpath::detail::dfa_regex_matcher<char>::create(pattern, icase);
+            BOOST_REQUIRE_MESSAGE(dfa != nullptr, pattern);
+            auto flags = icase ? std::regex_constants::ECMAScript | std::regex_constants::icase : std::regex_constants::ECMAScript;
+            std::regex re(pattern, flags);
+            for (const auto& s : subjects)
+            {
+                BOOST_CHECK_MESSAGE(dfa->matches(s.data(), s.length()) == std::regex_match(s, re), pattern + " " + s);
+            }
+        }
+    }
+
+    // Outside the subset
+    BOOST_CHECK(jsonpath::detail::dfa_regex_matcher<char>::create("a{2}", false) == nullptr);
+    BOOST_CHECK(jsonpath::detail::dfa_regex_matcher<char>::create("(?=a)b", false) == nullptr);
+    BOOST_CHECK(jsonpath::detail::dfa_regex_matcher<char>::create("\\bword", false) == nullptr);
+    BOOST_CHECK(jsonpath::detail::dfa_regex_matcher<char>::create("(a)\\1", false) == nullptr);
+}
+
+BOOST_AUTO_TEST_CASE(test_regex_cache)
+{
+    auto flags = std::regex_constants::ECMAScript | std::regex_constants::icase;
+    auto m1 = regex_cache::instance().get(".*Tolkien", flags);
+    auto m2 = regex_cache::instance().get(".*Tolkien", flags);
+    auto m3 = regex_cache::instance().get(".*Tolkien", std::regex_constants::ECMAScript);
+    BOOST_CHECK(m1 == m2);
+    BOOST_CHECK(m1 != m3);
+    std::string s = "J. R. R. TOLKIEN";
+    BOOST_CHECK(m1->matches(s.data(), s.length()));
+    BOOST_CHECK(!m3->matches(s.data(), s.length()));
+
+    // Patterns outside the subset of the built-in matcher use std::regex
+    auto m4 = regex_cache::instance().get("(a)\\1", std::regex_constants::ECMAScript);
+    std::string aa = "aa";
+    BOOST_CHECK(m4->matches(aa.data(), aa.length()));
+}
+
+BOOST_AUTO_TEST_CASE(test_regex_filter)
+{
+    json root = json::parse(R"(
+    {"book": [
+        {"author": "Nigel Rees"}, {"author": "J. R. R. Tolkien"}, {"author": "Evelyn Waugh"}
+    ]})");
+    json result = json_query(root, "$..book[?(@.author =~ /.*tolkien/i)].author");
+    BOOST_REQUIRE_EQUAL(1, result.size());
+    BOOST_CHECK(result[0].as<std::string>() == "J. R. R. Tolkien");
+
+    result = json_query(root, "$..book[?(@.author =~ /(Nigel|Evelyn) \\w+/)].author");
+    BOOST_CHECK_EQUAL(2, result.size());
+
+    wjson wroot = wjson::parse(L"{\"names\":[\"Ann\",\"Bob\",\"ann\"]}");
+    wjson wresult = json_query(wroot, L"$.names[?(@ =~ /an+/i)]");
+    BOOST_CHECK_EQUAL(2, wresult.size());
+}
+
+BOOST_AUTO_TEST_CASE(test_regex_factory)
+{
+    size_t count = 0;
+    regex_cache::instance().set_factory([&](const std::string& pattern, std::regex_constants::syntax_option_type)
+    {
+        return std::make_shared<counting_matcher>(pattern, &count);
+    });
+
+    json root = json::parse(R"(["a.b","axb"])");
+    json result = json_query(root, "$[?(@ =~ /a.b/)]");
+    regex_cache::instance().set_factory(regex_cache::default_factory);
+
+    BOOST_CHECK_EQUAL(2, count);
+    BOOST_REQUIRE_EQUAL(1, result.size());
+    BOOST_CHECK(result[0].as<std::string>() == "a.b");
+}
+
+BOOST_AUTO_TEST_SUITE_END()
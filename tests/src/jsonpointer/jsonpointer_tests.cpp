@@ -210,6 +210,57 @@ BOOST_AUTO_TEST_CASE(test_replace_array_value)
     check_replace(example,"/foo/1", json("qux"), expected);
 }
 
+// pointer
+
+BOOST_AUTO_TEST_CASE(test_pointer_same_as_string)
+{
+    std::vector<std::string> paths = {"", "/", "/foo", "/foo/0", "/foo/2", "/foo/-", "/foo/01", "/foo/1a", "/foo/-/x",
+                                      "/a~1b", "/m~0n", "/m~2n", "/m~", "/ ", "/foo/0/x", "abc"};
+    for (const auto& path : paths)
+    {
+        json result1, result2;
+        jsonpointer::jsonpointer_errc ec1, ec2;
+        std::tie(result1,ec1) = jsonpointer::get(example, path);
+        std::tie(result2,ec2) = jsonpointer::get(example, jsonpointer::pointer(path));
+        BOOST_CHECK_MESSAGE(ec1 == ec2, path);
+        BOOST_CHECK_MESSAGE(ec1 != jsonpointer::jsonpointer_errc() || result1 == result2, path);
+        BOOST_CHECK_MESSAGE(jsonpointer::contains(example, path) == jsonpointer::contains(example, jsonpointer::pointer(path)), path);
+
+        json target1 = example;
+        json target2 = example;
+        BOOST_CHECK(jsonpointer::insert_or_assign(target1, path, json("x")) == jsonpointer::insert_or_assign(target2, jsonpointer::pointer(path), json("x")));
+        BOOST_CHECK(jsonpointer::erase(target1, path) == jsonpointer::erase(target2, jsonpointer::pointer(path)));
+        BOOST_CHECK(jsonpointer::insert(target1, path, json("y")) == jsonpointer::insert(target2, jsonpointer::pointer(path), json("y")));
+        BOOST_CHECK(jsonpointer::replace(target1, path, json("z")) == jsonpointer::replace(target2, jsonpointer::pointer(path), json("z")));
+        BOOST_CHECK_MESSAGE(target1 == target2, path);
+    }
+
+    jsonpointer::pointer p("/foo/-");
+    BOOST_CHECK_EQUAL(2, p.size());
+    BOOST_CHECK(jsonpointer::normalized_path(example, p).string() == "/foo/2");
+    BOOST_CHECK(jsonpointer::pointer("/m~0n").tokens()[0].name == "m~n");
+}
+
+BOOST_AUTO_TEST_CASE(test_get_many)
+{
+    std::vector<jsonpointer::pointer> pointers = {
+        jsonpointer::pointer("/foo/1"), 
+        jsonpointer::pointer("/a~1b"), 
+        jsonpointer::pointer("/foo/0"), 
+        jsonpointer::pointer("/foo/5"), 
+        jsonpointer::pointer("/foo"), 
+        jsonpointer::pointer("")
+    };
+    auto results = jsonpointer::get(example, pointers);
+    BOOST_REQUIRE_EQUAL(pointers.size(), results.size());
+    BOOST_CHECK(std::get<0>(results[0]) == json("baz"));
+    BOOST_CHECK(std::get<0>(results[1]) == json(1));
+    BOOST_CHECK(std::get<0>(results[2]) == json("bar"));
+    BOOST_CHECK(std::get<1>(results[3]) == jsonpointer::jsonpointer_errc::index_exceeds_array_size);
+    BOOST_CHECK(std::get<0>(results[4]) == example["foo"]);
+    BOOST_CHECK(std::get<0>(results[5]) == example);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 
 
@@ -0,0 +1,118 @@
+// Copyright 2017 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <jsoncons/json_reader.hpp>
+#include <jsoncons/mapped_file.hpp>
+#include <fstream>
+#include <sstream>
+#include <vector>
+#include <utility>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(mapped_file_tests)
+
+BOOST_AUTO_TEST_CASE(test_parse_file)
+{
+    for (std::string in_file : {"input/address-book.json", "input/countries.json", "input/JSONPath/json.json"})
+    {
+        std::ifstream is(in_file);
+        json expected = json::parse(is);
+        BOOST_CHECK(json::parse_file(in_file) == expected);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_file_errors)
+{
+    try
+    {
+        json::parse_file("input/json-exception-1.json");
+        BOOST_CHECK(false);
+    }
+    catch (const parse_error& e)
+    {
+        BOOST_CHECK(e.code() == json_parser_errc::expected_comma_or_right_bracket);
+        BOOST_CHECK_EQUAL(14,e.line_number());
+        BOOST_CHECK_EQUAL(30,e.column_number());
+    }
+
+    try
+    {
+        json::parse_file("input/no-such-file.json");
+        BOOST_CHECK(false);
+    }
+    catch (const parse_error& e)
+    {
+        BOOST_CHECK(e.code() == json_parser_errc::source_error);
+    }
+
+    std::error_code ec;
+    mapped_file file("input/no-such-file.json", ec);
+    BOOST_CHECK(ec);
+    BOOST_CHECK(file.empty());
+    BOOST_CHECK_THROW(mapped_file("input/no-such-file.json"), std::runtime_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_file_bom_and_empty)
+{
+    {
+        std::ofstream os("output/mapped_bom.json", std::ios::binary);
+        os << "\xEF\xBB\xBF{\"a\":[1,2,3]}";
+    }
+    json j = json::parse_file("output/mapped_bom.json");
+    BOOST_CHECK_EQUAL(3, j["a"].size());
+
+    {
+        std::ofstream os("output/mapped_empty.json", std::ios::binary);
+    }
+    mapped_file file("output/mapped_empty.json");
+    BOOST_CHECK(file.empty());
+    BOOST_CHECK_THROW(json::parse_file("output/mapped_empty.json"), parse_error);
+}
+
+BOOST_AUTO_TEST_CASE(test_reader_from_mapped_file)
+{
+    {
+        std::ofstream os("output/mapped_lines.json", std::ios::binary);
+        os << "{\"n\":1}\n[2]\n\"three\"\n";
+    }
+    mapped_file file("output/mapped_lines.json");
+    mapped_file moved(std::move(file));
+    BOOST_CHECK(file.data() == nullptr);
+
+    json_decoder<json> decoder;
+    json_reader reader(json_reader::string_view_type(moved.data(), moved.size()), decoder);
+
+    std::vector<json> values;
+    while (!reader.eof())
+    {
+        reader.read_next();
+        if (!reader.eof())
+        {
+            values.push_back(decoder.get_result());
+        }
+    }
+    BOOST_REQUIRE_EQUAL(3, values.size());
+    BOOST_CHECK_EQUAL(1, values[0]["n"].as<int>());
+    BOOST_CHECK_EQUAL(2, values[1][0].as<int>());
+    BOOST_CHECK(values[2].as<std::string>() == "three");
+}
+
+BOOST_AUTO_TEST_CASE(test_reader_from_string)
+{
+    std::string s = R"({"a":[1,2)";
+    json_decoder<json> decoder;
+    json_reader reader(s, decoder);
+    std::error_code ec;
+    reader.read(ec);
+    BOOST_CHECK(ec == json_parser_errc::unexpected_eof);
+
+    std::string s2 = "[1] [2]";
+    json_decoder<json> decoder2;
+    json_reader reader2(s2, decoder2);
+    BOOST_CHECK_THROW(reader2.read(), parse_error);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,171 @@
+// Copyright 2017 Daniel Parker
+// Distributed under Boost license
+
+#include <boost/test/unit_test.hpp>
+#include <jsoncons/json.hpp>
+#include <sstream>
+#include <vector>
+#include <utility>
+
+using namespace jsoncons;
+
+BOOST_AUTO_TEST_SUITE(ojson_index_tests)
+
+namespace {
+
+std::string key(size_t i)
+{
+    return "key" + std::to_string(i);
+}
+
+void check_order(const ojson& j, const std::vector<std::string>& expected)
+{
+    BOOST_REQUIRE_EQUAL(expected.size(), j.size());
+    size_t i = 0;
+    for (const auto& member : j.object_range())
+    {
+        BOOST_CHECK(member.key() == expected[i]);
+        ++i;
+    }
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(test_large_ojson_lookup)
+{
+    const size_t n = 5000;
+    ojson j;
+    std::vector<std::string> expected;
+    for (size_t i = 0; i < n; ++i)
+    {
+        size_t k = (i * 7919) % n;
+        j.insert_or_assign(key(k), k);
+        expected.push_back(key(k));
+    }
+    check_order(j, expected);
+    for (size_t i = 0; i < n; ++i)
+    {
+        BOOST_CHECK(j.has_key(key(i)));
+        BOOST_CHECK_EQUAL(i, j.at(key(i)).as<size_t>());
+    }
+    BOOST_CHECK(!j.has_key("missing"));
+
+    // Assigning keeps the position
+    j.insert_or_assign(key(0), "zero");
+    BOOST_CHECK(j.at(key(0)).as<std::string>() == "zero");
+    check_order(j, expected);
+}
+
+BOOST_AUTO_TEST_CASE(test_large_ojson_erase)
+{
+    const size_t n = 100;
+    ojson j;
+    std::vector<std::string> expected;
+    for (size_t i = 0; i < n; ++i)
+    {
+        j[key(i)] = i;
+    }
+    for (size_t i = 0; i < n; ++i)
+    {
+        if (i % 3 == 0)
+        {
+            j.erase(key(i));
+        }
+        else
+        {
+            expected.push_back(key(i));
+        }
+    }
+    check_order(j, expected);
+    for (size_t i = 0; i < n; ++i)
+    {
+        BOOST_CHECK_EQUAL(i % 3 != 0, j.has_key(key(i)));
+    }
+
+    // Below the index threshold lookups still work
+    j.erase(j.object_range().begin() + 10, j.object_range().end());
+    BOOST_CHECK_EQUAL(10, j.size());
+    BOOST_CHECK(j.has_key(key(1)));
+    BOOST_CHECK(!j.has_key(key(99)));
+    j[key(99)] = 99;
+    BOOST_CHECK_EQUAL(99, j[key(99)].as<int>());
+}
+
+BOOST_AUTO_TEST_CASE(test_large_ojson_insert_with_hint)
+{
+    ojson j;
+    for (size_t i = 0; i < 40; ++i)
+    {
+        j[key(i)] = i;
+    }
+    auto it = j.object_range().begin() + 5;
+    j.try_emplace(it, "inserted", true);
+    BOOST_CHECK_EQUAL(41, j.size());
+    BOOST_CHECK((j.object_range().begin() + 5)->key() == "inserted");
+    BOOST_CHECK((j.object_range().begin() + 6)->key() == key(5));
+    for (size_t i = 0; i < 40; ++i)
+    {
+        BOOST_CHECK_EQUAL(i, j[key(i)].as<size_t>());
+    }
+    BOOST_CHECK(j["inserted"].as<bool>());
+}
+
+BOOST_AUTO_TEST_CASE(test_large_ojson_parse_duplicates)
+{
+    std::string s = "{";
+    for (size_t i = 0; i < 50; ++i)
+    {
+        s += "\"" + key(i) + "\":" + std::to_string(i) + ",";
+    }
+    s += "\"" + key(3) + "\":\"last\"}";
+
+    ojson j = ojson::parse(s);
+    BOOST_CHECK_EQUAL(50, j.size());
+    BOOST_CHECK(j[key(3)].as<std::string>() == "last");
+    // The last member with a name keeps its position
+    BOOST_CHECK((j.object_range().end() - 1)->key() == key(3));
+    BOOST_CHECK(j.object_range().begin()->key() == key(0));
+}
+
+BOOST_AUTO_TEST_CASE(test_large_ojson_merge_and_compare)
+{
+    ojson a;
+    ojson b;
+    for (size_t i = 0; i < 30; ++i)
+    {
+        a[key(i)] = i;
+    }
+    for (size_t i = 20; i < 60; ++i)
+    {
+        b[key(i)] = i * 10;
+    }
+
+    ojson merged = a;
+    merged.merge(b);
+    BOOST_CHECK_EQUAL(60, merged.size());
+    BOOST_CHECK_EQUAL(25, merged[key(25)].as<int>());
+    BOOST_CHECK_EQUAL(500, merged[key(50)].as<int>());
+
+    ojson updated = a;
+    updated.merge_or_update(std::move(b));
+    BOOST_CHECK_EQUAL(60, updated.size());
+    BOOST_CHECK_EQUAL(250, updated[key(25)].as<int>());
+
+    // Equality doesn't depend on member order
+    ojson reversed;
+    for (size_t i = 60; i-- > 0; )
+    {
+        reversed[key(i)] = merged[key(i)];
+    }
+    BOOST_CHECK(reversed == merged);
+    reversed[key(0)] = -1;
+    BOOST_CHECK(reversed != merged);
+
+    ojson copy(merged);
+    BOOST_CHECK(copy == merged);
+    copy.clear();
+    BOOST_CHECK(!copy.has_key(key(0)));
+    BOOST_CHECK(merged.has_key(key(0)));
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -9,6 +9,8 @@
 #include <utility>
 #include <ctime>
 #include <cwchar>
+#include <cstring>
+#include <limits>
 
 using namespace jsoncons;
 
@@ -53,5 +55,58 @@ BOOST_AUTO_TEST_CASE(test_exponent)
     //std::cout << std::numeric_limits<double>::max() << std::endl;
 }
 
+BOOST_AUTO_TEST_CASE(test_decimal_to_double_round_trip)
+{
+    const char* inputs[] = {"0.1","1e-7","3.14159265358979323846","2.2250738585072011e-308",
+                            "2.2250738585072014e-308","4.9406564584124654e-324","1.7976931348623157e308",
+                            "9007199254740993","123456789012345678901234567890e-10","7.3177701707893310e+15",
+                            "1.00000000000000011102230246251565404236316680908203125",
+                            "1.00000000000000011102230246251565404236316680908203124",
+                            "0.000000000000000000000000000000000000000000000000000000000000001e60"};
+    for (auto s : inputs)
+    {
+        double expected = strtod(s, nullptr);
+        double val;
+        BOOST_CHECK(detail::decimal_to_double(s, strlen(s), val));
+        BOOST_CHECK_EQUAL(expected, val);
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_decimal_to_double_limits)
+{
+    double val;
+    BOOST_CHECK(detail::decimal_to_double("1e400", 5, val));
+    BOOST_CHECK(val == std::numeric_limits<double>::infinity());
+    BOOST_CHECK(detail::decimal_to_double("-1e-400", 7, val));
+    BOOST_CHECK(val == 0.0 && std::signbit(val));
+    BOOST_CHECK(detail::decimal_to_double("2.4703282292062328e-324", 23, val));
+    BOOST_CHECK_EQUAL(std::numeric_limits<double>::denorm_min(), val);
+}
+
+BOOST_AUTO_TEST_CASE(test_decimal_to_double_span)
+{
+    // Only the given length is read, no null terminator needed
+    const char* s = "1.25e2xyz";
+    double val;
+    BOOST_CHECK(detail::decimal_to_double(s, 6, val));
+    BOOST_CHECK_EQUAL(125.0, val);
+    BOOST_CHECK(!detail::decimal_to_double(s, 9, val));
+    BOOST_CHECK(!detail::decimal_to_double("1e", 2, val));
+    BOOST_CHECK(!detail::decimal_to_double(".", 1, val));
+    BOOST_CHECK(!detail::decimal_to_double("nan", 3, val));
+
+    const wchar_t* ws = L"-0.5E-1";
+    BOOST_CHECK(detail::decimal_to_double(ws, wcslen(ws), val));
+    BOOST_CHECK_EQUAL(-0.05, val);
+}
+
+BOOST_AUTO_TEST_CASE(test_parse_long_mantissa)
+{
+    json j = json::parse("[0.30000000000000001665334536938,1.7976931348623158e308,-4.9e-324]");
+    BOOST_CHECK_EQUAL(0.30000000000000004, j[0].as<double>());
+    BOOST_CHECK_EQUAL((std::numeric_limits<double>::max)(), j[1].as<double>());
+    BOOST_CHECK_EQUAL(-std::numeric_limits<double>::denorm_min(), j[2].as<double>());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
 